@@ -2,11 +2,45 @@ import os
 
 from starlette.applications import Starlette
 from starlette.responses import PlainTextResponse
-from starlette.routing import Route
+from starlette.routing import Route, WebSocketRoute
+from starlette.websockets import WebSocket
 
 random_1k = os.urandom(1 * 1024)
 random_20k = os.urandom(20 * 1024)
 random_200k = os.urandom(200 * 1024)
+random_1m = os.urandom(1024 * 1024)
+random_10m = os.urandom(10 * 1024 * 1024)
+
+
+async def upload(request):
+    size = 0
+    async for chunk in request.stream():
+        size += len(chunk)
+    return PlainTextResponse(str(size))
+
+
+def cached(request):
+    headers = {"Cache-Control": "max-age=3600", "ETag": '"v1"'}
+    return PlainTextResponse(random_20k, headers=headers)
+
+
+async def ws_echo(websocket: WebSocket):
+    await websocket.accept()
+    try:
+        while True:
+            await websocket.send_bytes(await websocket.receive_bytes())
+    except Exception:
+        pass
+
+
+async def ws_flood(websocket: WebSocket):
+    # sends `count` messages of `size` bytes as fast as possible
+    await websocket.accept()
+    count = int(websocket.query_params.get("count", "100000"))
+    payload = os.urandom(int(websocket.query_params.get("size", "64")))
+    for _ in range(count):
+        await websocket.send_bytes(payload)
+    await websocket.close()
 
 
 app = Starlette(
@@ -14,6 +48,12 @@ app = Starlette(
         Route("/1k", lambda r: PlainTextResponse(random_1k)),
         Route("/20k", lambda r: PlainTextResponse(random_20k)),
         Route("/200k", lambda r: PlainTextResponse(random_200k)),
+        Route("/1m", lambda r: PlainTextResponse(random_1m)),
+        Route("/10m", lambda r: PlainTextResponse(random_10m)),
+        Route("/upload", upload, methods=["POST"]),
+        Route("/cached", cached),
+        WebSocketRoute("/ws/echo", ws_echo),
+        WebSocketRoute("/ws/flood", ws_flood),
     ],
 )
 
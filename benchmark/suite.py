@@ -0,0 +1,451 @@
+"""Benchmark suite of curl_cffi, with machine-readable results to compare releases.
+
+Run all the scenarios against ``server.py``, started on a free port:
+
+    python benchmark/suite.py run -o results.json
+
+Compare two runs, exits with 1 when a scenario lost more than 10% of throughput:
+
+    python benchmark/suite.py compare baseline.json results.json --threshold 0.1
+
+See ``--help`` for profiles, allocation tracking and picking scenarios.
+"""
+
+import argparse
+import asyncio
+import cProfile
+import json
+import platform
+import socket
+import subprocess
+import sys
+import time
+import tracemalloc
+from collections.abc import Callable
+from datetime import datetime, timezone
+from pathlib import Path
+from time import perf_counter, process_time
+from typing import Any, Optional
+
+import curl_cffi
+from curl_cffi.requests import AsyncSession, MemoryCacheBackend, Session
+
+HERE = Path(__file__).resolve().parent
+
+
+class Measure:
+    """The measured part of a scenario, setup and warmup stay out of it."""
+
+    def __init__(self, profile: Optional[cProfile.Profile], alloc: bool) -> None:
+        self.profile = profile
+        self.alloc = alloc
+        self.latencies: list[float] = []
+        self.extra: dict[str, Any] = {}
+        self.wall = 0.0
+        self.cpu = 0.0
+        self.peak_alloc: Optional[int] = None
+
+    def __enter__(self) -> "Measure":
+        if self.alloc:
+            tracemalloc.start()
+        if self.profile is not None:
+            self.profile.enable()
+        self._wall = perf_counter()
+        self._cpu = process_time()
+        return self
+
+    def __exit__(self, *args: Any) -> None:
+        self.wall = perf_counter() - self._wall
+        self.cpu = process_time() - self._cpu
+        if self.profile is not None:
+            self.profile.disable()
+        if self.alloc:
+            self.peak_alloc = tracemalloc.get_traced_memory()[1]
+            tracemalloc.stop()
+
+
+class Context:
+    def __init__(self, base_url: str, scale: float) -> None:
+        self.base_url = base_url
+        self.scale = scale
+
+    def url(self, path: str) -> str:
+        return self.base_url + path
+
+    def ws_url(self, path: str) -> str:
+        return "ws" + self.base_url[len("http") :] + path
+
+    def ops(self, n: int) -> int:
+        return max(1, int(n * self.scale))
+
+
+Scenario = Callable[[Context, Measure], int]
+SCENARIOS: dict[str, Scenario] = {}
+
+
+def scenario(name: str) -> Callable[[Scenario], Scenario]:
+    """Register a scenario, it returns the number of operations it measured."""
+
+    def register(func: Scenario) -> Scenario:
+        SCENARIOS[name] = func
+        return func
+
+    return register
+
+
+def _sync_get(ctx: Context, m: Measure, path: str, ops: int, **kwargs: Any) -> int:
+    url = ctx.url(path)
+    with Session(**kwargs) as s:
+        s.get(url)  # connect, and fill the cache if any
+        with m:
+            for _ in range(ops):
+                start = perf_counter()
+                s.get(url)
+                m.latencies.append(perf_counter() - start)
+    return ops
+
+
+async def _async_get(
+    m: Measure, url: str, ops: int, concurrency: int, **kwargs: Any
+) -> int:
+    async with AsyncSession(max_clients=concurrency, **kwargs) as s:
+        await asyncio.gather(*(s.get(url) for _ in range(concurrency)))
+
+        async def worker(n: int) -> None:
+            for _ in range(n):
+                start = perf_counter()
+                await s.get(url)
+                m.latencies.append(perf_counter() - start)
+
+        with m:
+            await asyncio.gather(
+                *(worker(ops // concurrency) for _ in range(concurrency))
+            )
+    return ops // concurrency * concurrency
+
+
+@scenario("sync_small")
+def sync_small(ctx: Context, m: Measure) -> int:
+    return _sync_get(ctx, m, "/1k", ctx.ops(2000))
+
+
+@scenario("sync_large")
+def sync_large(ctx: Context, m: Measure) -> int:
+    return _sync_get(ctx, m, "/1m", ctx.ops(200))
+
+
+@scenario("sync_impersonate")
+def sync_impersonate(ctx: Context, m: Measure) -> int:
+    # the overhead of applying a fingerprint, compare with sync_small
+    return _sync_get(ctx, m, "/1k", ctx.ops(2000), impersonate="chrome")
+
+
+@scenario("sync_cache_hit")
+def sync_cache_hit(ctx: Context, m: Measure) -> int:
+    return _sync_get(ctx, m, "/cached", ctx.ops(5000), cache=MemoryCacheBackend())
+
+
+@scenario("async_small")
+def async_small(ctx: Context, m: Measure) -> int:
+    return asyncio.run(_async_get(m, ctx.url("/1k"), ctx.ops(5000), 10))
+
+
+@scenario("async_large")
+def async_large(ctx: Context, m: Measure) -> int:
+    return asyncio.run(_async_get(m, ctx.url("/1m"), ctx.ops(500), 10))
+
+
+@scenario("stream")
+def stream(ctx: Context, m: Measure) -> int:
+    ops = ctx.ops(30)
+    url = ctx.url("/10m")
+    with Session() as s:
+        s.get(ctx.url("/1k"))
+        received = 0
+        with m:
+            for _ in range(ops):
+                start = perf_counter()
+                with s.stream("GET", url) as r:
+                    for chunk in r.iter_content():
+                        received += len(chunk)
+                m.latencies.append(perf_counter() - start)
+    m.extra["mb_per_sec"] = received / m.wall / 1e6
+    return ops
+
+
+@scenario("upload")
+def upload(ctx: Context, m: Measure) -> int:
+    ops = ctx.ops(200)
+    url = ctx.url("/upload")
+    body = b"x" * (1024 * 1024)
+    with Session() as s:
+        s.get(ctx.url("/1k"))
+        with m:
+            for _ in range(ops):
+                start = perf_counter()
+                s.post(url, data=body)
+                m.latencies.append(perf_counter() - start)
+    m.extra["mb_per_sec"] = ops * len(body) / m.wall / 1e6
+    return ops
+
+
+@scenario("pool_churn")
+def pool_churn(ctx: Context, m: Measure) -> int:
+    """Bursts of requests separated by idle gaps longer than the idle timeout, so
+    handles are closed and created again all the time."""
+    rounds = ctx.ops(100)
+    concurrency = 8
+    url = ctx.url("/1k")
+
+    async def run() -> None:
+        async with AsyncSession(max_clients=concurrency, idle_timeout=0.001) as s:
+
+            async def get() -> None:
+                start = perf_counter()
+                await s.get(url)
+                m.latencies.append(perf_counter() - start)
+
+            with m:
+                for _ in range(rounds):
+                    await asyncio.gather(*(get() for _ in range(concurrency)))
+                    await asyncio.sleep(0.005)
+            m.extra["handles_created"] = s.pool_stats().created
+
+    asyncio.run(run())
+    return rounds * concurrency
+
+
+@scenario("ws_recv")
+def ws_recv(ctx: Context, m: Measure) -> int:
+    return _ws_recv(ctx, m, zero_copy=False)
+
+
+@scenario("ws_recv_zero_copy")
+def ws_recv_zero_copy(ctx: Context, m: Measure) -> int:
+    return _ws_recv(ctx, m, zero_copy=True)
+
+
+def _ws_recv(ctx: Context, m: Measure, zero_copy: bool) -> int:
+    count = ctx.ops(200000)
+    url = ctx.ws_url(f"/ws/flood?count={count}&size=64")
+
+    async def run() -> None:
+        async with AsyncSession() as s:
+            ws = await s.ws_connect(url, zero_copy=zero_copy)
+            with m:
+                for _ in range(count):
+                    await ws.recv()
+            await ws.close()
+
+    asyncio.run(run())
+    return count
+
+
+@scenario("ws_echo")
+def ws_echo(ctx: Context, m: Measure) -> int:
+    ops = ctx.ops(10000)
+    payload = b"x" * 64
+
+    async def run() -> None:
+        async with AsyncSession() as s:
+            ws = await s.ws_connect(ctx.ws_url("/ws/echo"))
+            with m:
+                for _ in range(ops):
+                    start = perf_counter()
+                    await ws.send(payload)
+                    await ws.recv()
+                    m.latencies.append(perf_counter() - start)
+            await ws.close()
+
+    asyncio.run(run())
+    return ops
+
+
+def _percentile(latencies: list[float], p: float) -> Optional[float]:
+    if not latencies:
+        return None
+    ordered = sorted(latencies)
+    return ordered[min(len(ordered) - 1, int(p * len(ordered)))]
+
+
+def run_scenario(
+    name: str, ctx: Context, profile_dir: Optional[Path], alloc: bool
+) -> dict[str, Any]:
+    profile = cProfile.Profile() if profile_dir is not None else None
+    m = Measure(profile, alloc=False)
+    ops = SCENARIOS[name](ctx, m)
+    result: dict[str, Any] = {
+        "ops": ops,
+        "seconds": m.wall,
+        "ops_per_sec": ops / m.wall,
+        "cpu_seconds": m.cpu,
+        "cpu_per_op_us": m.cpu / ops * 1e6,
+    }
+    for p in (0.5, 0.9, 0.99):
+        value = _percentile(m.latencies, p)
+        result[f"p{round(p * 100)}_ms"] = None if value is None else value * 1e3
+    result.update(m.extra)
+    if profile is not None and profile_dir is not None:
+        profile_dir.mkdir(parents=True, exist_ok=True)
+        profile.dump_stats(profile_dir / f"{name}.prof")
+    if alloc:
+        # in a second pass, tracing allocations would skew the timings
+        traced = Measure(None, alloc=True)
+        SCENARIOS[name](ctx, traced)
+        result["peak_alloc_kb"] = (traced.peak_alloc or 0) / 1024
+    return result
+
+
+def _free_port() -> int:
+    with socket.socket() as sock:
+        sock.bind(("127.0.0.1", 0))
+        return sock.getsockname()[1]
+
+
+def start_server() -> tuple[subprocess.Popen, str]:
+    port = _free_port()
+    process = subprocess.Popen(
+        [
+            sys.executable,
+            "-m",
+            "uvicorn",
+            "server:app",
+            "--port",
+            str(port),
+            "--log-level",
+            "warning",
+        ],
+        cwd=HERE,
+    )
+    deadline = time.monotonic() + 30
+    while time.monotonic() < deadline:
+        try:
+            socket.create_connection(("127.0.0.1", port), timeout=0.1).close()
+            return process, f"http://127.0.0.1:{port}"
+        except OSError:
+            time.sleep(0.1)
+    process.kill()
+    raise RuntimeError("benchmark server did not start")
+
+
+def _git_commit() -> Optional[str]:
+    try:
+        return subprocess.run(
+            ["git", "rev-parse", "HEAD"],
+            cwd=HERE,
+            capture_output=True,
+            text=True,
+            check=True,
+        ).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def run(args: argparse.Namespace) -> None:
+    names = args.scenario or list(SCENARIOS)
+    unknown = set(names) - set(SCENARIOS)
+    if unknown:
+        sys.exit(f"unknown scenarios: {', '.join(sorted(unknown))}")
+    process = None
+    base_url = args.url
+    if base_url is None:
+        process, base_url = start_server()
+    ctx = Context(base_url.rstrip("/"), args.scale)
+    results: dict[str, Any] = {
+        "meta": {
+            "curl_cffi": curl_cffi.__version__,
+            "libcurl": curl_cffi.__curl_version__,
+            "python": sys.version.split()[0],
+            "implementation": platform.python_implementation(),
+            "platform": platform.platform(),
+            "machine": platform.machine(),
+            "commit": _git_commit(),
+            "date": datetime.now(timezone.utc).isoformat(),
+            "scale": args.scale,
+        },
+        "scenarios": {},
+    }
+    try:
+        for name in names:
+            result = run_scenario(name, ctx, args.profile, args.alloc)
+            results["scenarios"][name] = result
+            p99 = result["p99_ms"]
+            print(
+                f"{name:20} {result['ops_per_sec']:12.1f} ops/s"
+                f"  p99 {'-' if p99 is None else f'{p99:.3f}'} ms"
+                f"  cpu {result['cpu_per_op_us']:.1f} us/op"
+            )
+    finally:
+        if process is not None:
+            process.terminate()
+            process.wait()
+    if args.output is not None:
+        args.output.write_text(json.dumps(results, indent=2) + "\n")
+
+
+def compare(args: argparse.Namespace) -> None:
+    old = json.loads(args.baseline.read_text())["scenarios"]
+    new = json.loads(args.results.read_text())["scenarios"]
+    regressions = []
+    print(f"{'scenario':20} {'ops/s':>12} {'change':>8} {'p99 ms':>10} {'change':>8}")
+    for name, result in new.items():
+        if name not in old:
+            continue
+        before = old[name]
+        throughput = result["ops_per_sec"] / before["ops_per_sec"] - 1
+        p99 = ""
+        if result.get("p99_ms") and before.get("p99_ms"):
+            p99 = f"{result['p99_ms'] / before['p99_ms'] - 1:+.1%}"
+        print(
+            f"{name:20} {result['ops_per_sec']:12.1f} {throughput:+8.1%}"
+            f" {result.get('p99_ms') or 0:10.3f} {p99:>8}"
+        )
+        if throughput < -args.threshold:
+            regressions.append(name)
+    if regressions:
+        print(f"regressions: {', '.join(regressions)}")
+        sys.exit(1)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    run_parser = commands.add_parser("run", help="run the scenarios")
+    run_parser.add_argument(
+        "scenario", nargs="*", help=f"scenarios to run: {', '.join(SCENARIOS)}"
+    )
+    run_parser.add_argument("-o", "--output", type=Path, help="write results as json")
+    run_parser.add_argument(
+        "--url", help="use a running server.py instead of starting one"
+    )
+    run_parser.add_argument(
+        "--scale", type=float, default=1.0, help="multiply the number of operations"
+    )
+    run_parser.add_argument(
+        "--profile", type=Path, help="write a cProfile of each scenario to this dir"
+    )
+    run_parser.add_argument(
+        "--alloc",
+        action="store_true",
+        help="record the peak of allocations, in an extra pass of each scenario",
+    )
+    run_parser.set_defaults(func=run)
+
+    compare_parser = commands.add_parser("compare", help="compare two results")
+    compare_parser.add_argument("baseline", type=Path)
+    compare_parser.add_argument("results", type=Path)
+    compare_parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.1,
+        help="throughput loss counted as a regression, 0.1 by default",
+    )
+    compare_parser.set_defaults(func=compare)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
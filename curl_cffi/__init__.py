@@ -2,6 +2,13 @@ __all__ = [
     "Curl",
     "AsyncCurl",
     "CurlMime",
+    "CurlMulti",
+    "CurlShare",
+    "CurlBuffer",
+    "CurlRingBuffer",
+    "CurlFileSink",
+    "CurlFileSource",
+    "CurlHeaderBuffer",
     "CurlError",
     "CurlInfo",
     "CurlOpt",
@@ -19,6 +26,7 @@ __all__ = [
     "lib",
     "Session",
     "AsyncSession",
+    "ShardedAsyncSession",
     "BrowserType",
     "BrowserTypeLiteral",
     "request",
@@ -66,7 +74,18 @@ from .const import (
     CurlSslVersion,
     CurlWsFlag,
 )
-from .curl import Curl, CurlError, CurlMime
+from .curl import (
+    Curl,
+    CurlBuffer,
+    CurlError,
+    CurlFileSink,
+    CurlFileSource,
+    CurlHeaderBuffer,
+    CurlMime,
+    CurlMulti,
+    CurlRingBuffer,
+    CurlShare,
+)
 
 from .requests import (
     AsyncSession,
@@ -84,6 +103,7 @@ from .requests import (
     Request,
     Response,
     Session,
+    ShardedAsyncSession,
     WebSocket,
     WebSocketClosed,
     WebSocketError,
@@ -1,8 +1,10 @@
 import asyncio
 import sys
+import threading
 import warnings
-from contextlib import suppress
-from typing import Any, Optional
+from collections.abc import Callable, Iterator
+from contextlib import AbstractContextManager, contextmanager, nullcontext, suppress
+from typing import Any, Literal, Optional, cast
 from weakref import WeakKeyDictionary
 
 from ._wrapper import ffi, lib
@@ -68,6 +70,10 @@ else:
         return loop
 
 
+def _has_readers(loop: asyncio.AbstractEventLoop) -> bool:
+    return not isinstance(loop, getattr(asyncio, "ProactorEventLoop", type(None)))
+
+
 CURL_POLL_NONE = 0
 CURL_POLL_IN = 1
 CURL_POLL_OUT = 2
@@ -99,122 +105,190 @@ There are 2 callbacks:
 - socket_function, set by CURLMOPT_SOCKETFUNCTION, will be called for socket events.
 - timer_function, set by CURLMOPT_TIMERFUNCTION, will be called when timeouts happen.
 
-And it works like the following:
-
-Set up handles, callbacks first.
+Both callbacks are implemented in the shim, they only record what libcurl wants. One
+`socket_action` call runs curl_multi_socket_action, drains curl_multi_info_read into
+an array of finished transfers, and returns. Python then applies the socket changes
+with asyncio loop readers/writers, which call `process_data`, installs the timer,
+and resolves the futures of the finished transfers.
 
-When started, curl_multi_socket_action should be called to start everything.
+Each socket keeps its last wanted state, so a socket changing its mind several times
+in one call only touches the loop once, and readers are left alone when they are
+still wanted. When libcurl changes something outside of socket_action, e.g. in
+`add_handle` or `curl_easy_pause`, the shim calls `multi_events_callback` once, which
+schedules applying the changes.
 
-If there are data in/out, libcurl calls the socket_function callback, and it sets up
-`process_data` as asyncio loop reader/writer function. `process_data` will call
-curl_multi_info_read to determine whether a certain `await perform` has finished.
-
-When idle, libcurl will call the timer_function callback, which sets up a later call
-for socket_action to detect events.
+Loops without `add_reader`, i.e. the proactor loop on Windows, are driven by a thread
+instead, see `_PollDriver`.
 """
 
 
 @ffi.def_extern()
-def timer_function(curlm, timeout_ms: int, clientp: Any) -> int:
-    """
-    see: https://curl.se/libcurl/c/CURLMOPT_TIMERFUNCTION.html
-    """
+def multi_events_callback(clientp: Any) -> None:
+    """Called by the shim when there are socket or timer changes to apply."""
     async_curl = ffi.from_handle(clientp)
+    if async_curl._curlm is not None:
+        async_curl.loop.call_soon(async_curl._update_events)
 
-    # Cancel the timer anyway, if it's -1, yes, libcurl says it should be cancelled.
-    # If not, to add a new timer, we need to cancel the old timer.
-    if async_curl._timer:
-        async_curl._timer.cancel()  # If already called, cancel does nothing.
-        async_curl._timer = None
 
-    # libcurl says to install a timer which calls socket_action on fire.
-    async_curl._timer = async_curl.loop.call_later(
-        timeout_ms / 1000,
-        async_curl.process_data,
-        CURL_SOCKET_TIMEOUT,  # -1
-        CURL_POLL_NONE,  # 0
-    )
+class _PollDriver:
+    """Waits for the sockets of a multi handle with ``curl_multi_poll`` in a dedicated
+    thread, and schedules a round of ``curl_multi_perform`` on the loop when there is
+    something to do.
 
-    return 0
-
-
-@ffi.def_extern()
-def socket_function(curl, sockfd: int, what: int, clientp: Any, data: Any) -> int:
-    """This callback is called when libcurl decides it's time to interact with certain
-    sockets"""
-
-    async_curl = ffi.from_handle(clientp)
-    loop = async_curl.loop
-
-    # Always remove and re-add fds
-    if sockfd in async_curl._sockfds:
-        loop.remove_reader(sockfd)
-        loop.remove_writer(sockfd)
+    Only one thread may use the multi handle at a time. The driver thread holds the
+    lock while it waits in ``curl_multi_poll``, the loop thread takes it over with
+    ``curl_multi_wakeup``, the only thread-safe multi call, whenever it needs the
+    handle, see ``__enter__``. Transfers still run on the loop thread, and so do the
+    callbacks. The poll waits until the next round is done, so a socket is never
+    reported twice.
+    """
 
-    # Need to read from the socket
-    if what & CURL_POLL_IN:
-        loop.add_reader(sockfd, async_curl.process_data, sockfd, CURL_CSELECT_IN)
-        async_curl._sockfds.add(sockfd)
+    # curl_multi_poll returns earlier when libcurl has a timeout to handle
+    POLL_TIMEOUT_MS = 1000
+
+    def __init__(
+        self, curlm: Any, loop: asyncio.AbstractEventLoop, drive: Callable[[], None]
+    ) -> None:
+        self._curlm = curlm
+        self._loop = loop
+        self._drive = drive
+        self._lock = threading.RLock()
+        self._held = 0  # only touched by the loop thread, holding the lock
+        self._round_done = threading.Event()
+        self._round_done.set()
+        self._closed = False
+        self._thread = threading.Thread(
+            target=self._run, name="curl_cffi-poll", daemon=True
+        )
+        self._thread.start()
 
-    # Need to write to the socket
-    if what & CURL_POLL_OUT:
-        loop.add_writer(sockfd, async_curl.process_data, sockfd, CURL_CSELECT_OUT)
-        async_curl._sockfds.add(sockfd)
+    def __enter__(self) -> "_PollDriver":
+        if not self._held:
+            lib.curl_multi_wakeup(self._curlm)
+        self._lock.acquire()
+        self._held += 1
+        return self
 
-    # Need to remove the socket
-    if what == CURL_POLL_REMOVE:
-        async_curl._sockfds.remove(sockfd)
+    def __exit__(self, *args: Any) -> None:
+        self._held -= 1
+        self._lock.release()
 
-    return 0
+    def _run(self) -> None:
+        numfds = ffi.new("int *")
+        while True:
+            self._round_done.wait()
+            self._round_done.clear()
+            with self._lock:
+                if self._closed:
+                    return
+                lib.curl_multi_poll(
+                    self._curlm, ffi.NULL, 0, self.POLL_TIMEOUT_MS, numfds
+                )
+            try:
+                self._loop.call_soon_threadsafe(self._drive)
+            except RuntimeError:
+                return  # the loop is closed
+
+    @contextmanager
+    def round(self) -> Iterator[None]:
+        """Hold the multi handle for a round scheduled by the driver thread, which is
+        not polling then, so no wakeup is needed, and let it poll again after."""
+        self._lock.acquire()
+        self._held += 1
+        try:
+            yield
+        finally:
+            self._held -= 1
+            self._lock.release()
+            self._round_done.set()
+
+    def close(self) -> None:
+        with self:
+            self._closed = True
+        self._round_done.set()
+        self._thread.join()
 
 
 class AsyncCurl:
     """Wrapper around curl_multi handle to provide asyncio support. It uses the libcurl
     socket_action APIs."""
 
-    def __init__(self, cacert: str = "", loop=None):
+    def __init__(
+        self,
+        cacert: str = "",
+        loop=None,
+        driver: Literal["auto", "loop", "thread"] = "auto",
+    ):
         """
         Parameters:
             cacert: CA cert path to use, by default, certs from ``certifi`` are used.
             loop: EventLoop to use.
+            driver: how to wait for the sockets. ``"loop"`` registers them with the
+                readers and writers of the loop, ``"thread"`` waits for all of them
+                with ``curl_multi_poll`` in one thread. ``"auto"`` picks the thread
+                for loops without ``add_reader``, i.e. the proactor loop on Windows.
         """
         self._curlm = lib.curl_multi_init()
         self._cacert = cacert or DEFAULT_CACERT
         self._curl2future: dict[Curl, asyncio.Future] = {}  # curl to future map
         self._curl2curl: dict[ffi.CData, Curl] = {}  # c curl to Curl
-        self._sockfds: set[int] = set()  # sockfds
-        self.loop = get_selector(
-            loop if loop is not None else asyncio.get_running_loop()
-        )
-        self._timeout_checker = self.loop.create_task(self._force_timeout())
+        self._wakeups: dict[Curl, Callable[[], None]] = {}  # curl to wakeup callback
+        self._sockfds: dict[int, int] = {}  # sockfd to watched CURL_POLL_ bits
+        loop = loop if loop is not None else asyncio.get_running_loop()
+        if driver == "auto":
+            driver = "loop" if _has_readers(loop) else "thread"
+        self.driver = driver
         self._timer: Optional[asyncio.TimerHandle] = None
-        self._setup()
+        self._driver: Optional[_PollDriver] = None
+        # held around every use of the multi handle
+        self._multi_guard: AbstractContextManager[Any] = nullcontext()
+        if driver == "thread":
+            self.loop = loop
+            self._timeout_checker: Optional[asyncio.Task] = None
+            self._setup()
+            self._driver = _PollDriver(self._curlm, loop, self._drive)
+            self._multi_guard = self._driver
+        else:
+            self.loop = get_selector(loop)
+            self._timeout_checker = self.loop.create_task(self._force_timeout())
+            self._setup()
 
     def _setup(self):
-        self.setopt(CurlMOpt.TIMERFUNCTION, lib.timer_function)
-        self.setopt(CurlMOpt.SOCKETFUNCTION, lib.socket_function)
         self._self_handle = ffi.new_handle(self)
-        self.setopt(CurlMOpt.SOCKETDATA, self._self_handle)
-        self.setopt(CurlMOpt.TIMERDATA, self._self_handle)
+        # sets the socket and timer callbacks of the multi handle, unless driven by
+        # a thread
+        notify = lib.multi_events_callback if self.driver == "loop" else ffi.NULL
+        events = lib._curl_multi_events_new(self._curlm, notify, self._self_handle)
+        if events == ffi.NULL:
+            raise MemoryError("Failed to allocate curl multi events")
+        self._events = ffi.gc(events, lib._curl_multi_events_free)
         # self.setopt(CurlMOpt.PIPELINING, CURLPIPE_NOTHING)
 
     async def close(self):
         """Close and cleanup running timers, readers, writers and handles."""
 
         # Close and wait for the force timeout checker to complete
-        self._timeout_checker.cancel()
-        with suppress(asyncio.CancelledError):
-            await self._timeout_checker
+        if self._timeout_checker is not None:
+            self._timeout_checker.cancel()
+            with suppress(asyncio.CancelledError):
+                await self._timeout_checker
+
+        # Stop polling before the multi handle goes away
+        if self._driver is not None:
+            self._driver.close()
+
+        # Events raised from here on are not applied
+        curlm, self._curlm = self._curlm, None
 
         # Close all pending futures
         for curl, future in self._curl2future.items():
-            lib.curl_multi_remove_handle(self._curlm, curl._curl)
+            lib.curl_multi_remove_handle(curlm, curl._curl)
+            curl._multi_guard = None
             if not future.done() and not future.cancelled():
                 future.set_result(None)
 
         # Cleanup curl_multi handle
-        lib.curl_multi_cleanup(self._curlm)
-        self._curlm = None
+        lib.curl_multi_cleanup(curlm)
 
         # Remove add readers and writers
         for sockfd in self._sockfds:
@@ -234,30 +308,69 @@ class AsyncCurl:
             self.socket_action(CURL_SOCKET_TIMEOUT, CURL_POLL_NONE)
             await asyncio.sleep(0.1)
 
-    def add_handle(self, curl: Curl):
+    def add_handle(self, curl: Curl, wakeup: Optional[Callable[[], None]] = None):
         """Add a curl handle to be managed by curl_multi. This is the equivalent of
-        `perform` in the async world."""
+        `perform` in the async world.
+
+        Parameters:
+            curl: the handle to perform.
+            wakeup: called after each round of socket actions while the handle is
+                running, e.g. to look for data written by a native sink.
+        """
 
         curl._ensure_cacert()
-        errcode = lib.curl_multi_add_handle(self._curlm, curl._curl)
+        with self._multi_guard:
+            self._events.busy = 1
+            errcode = lib.curl_multi_add_handle(self._curlm, curl._curl)
+            self._events.busy = 0
         self._check_error(errcode)
+        self._update_events()
+        if self._driver is not None:
+            curl._multi_guard = self._driver
         future = self.loop.create_future()
         self._curl2future[curl] = future
         self._curl2curl[curl._curl] = curl
+        if wakeup is not None:
+            self._wakeups[curl] = wakeup
         return future
 
     def socket_action(self, sockfd: int, ev_bitmask: int) -> int:
         """wrapper for curl_multi_socket_action,
-        returns the number of running curl handles."""
-        running_handle = ffi.new("int *")
-        errcode = lib.curl_multi_socket_action(
-            self._curlm, sockfd, ev_bitmask, running_handle
-        )
+        returns the number of running curl handles.
+
+        The futures of the transfers finished in this call are resolved too."""
+        events = self._events
+        errcode = lib._curl_multi_action(self._curlm, events, sockfd, ev_bitmask)
         self._check_error(errcode)
-        return running_handle[0]
+        self._update_events()
+        self._after_round()
+        return events.running
+
+    def _drive(self) -> None:
+        """A round of the thread driver: run the transfers, then resolve all those
+        finished in one go, holding the multi handle throughout."""
+        if self._curlm is None:
+            return
+        with cast(_PollDriver, self._driver).round():
+            errcode = lib._curl_multi_perform(self._curlm, self._events)
+            self._check_error(errcode, "perform")
+            self._after_round()
+
+    def _after_round(self) -> None:
+        for wakeup in list(self._wakeups.values()):
+            wakeup()
+        events = self._events
+        ndone = events.ndone
+        if ndone:
+            done = events.done
+            finished = [(done[i].easy, done[i].result) for i in range(ndone)]
+            events.ndone = 0
+            for easy, retcode in finished:
+                self._finish(easy, retcode)
 
     def process_data(self, sockfd: int, ev_bitmask: int):
-        """Call curl_multi_info_read to read data for given socket."""
+        """Call curl_multi_socket_action for given socket, loop readers, writers and
+        timers end up here."""
         if not self._curlm:
             warnings.warn(
                 "Curlm already closed! quitting from process_data",
@@ -268,39 +381,116 @@ class AsyncCurl:
 
         self.socket_action(sockfd, ev_bitmask)
 
-        msg_in_queue = ffi.new("int *")
-        while True:
-            try:
-                curl_msg = lib.curl_multi_info_read(self._curlm, msg_in_queue)
-                # NULL is returned as a signal that no more to be get at this point
-                if curl_msg == ffi.NULL:
-                    break
-                if curl_msg.msg == CURLMSG_DONE:
-                    curl = self._curl2curl[curl_msg.easy_handle]
-                    retcode = curl_msg.data.result
-                    callback_exception = curl._get_callback_exception()
-                    if callback_exception is not None:
-                        self.set_exception(curl, callback_exception)
-                    elif retcode == 0:
-                        self.set_result(curl)
-                    else:
-                        self.set_exception(curl, curl._get_error(retcode, "perform"))
-                else:
-                    print("NOT DONE")  # Will not reach, for nothing else being defined.
-            except Exception:
-                warnings.warn(
-                    "Unexpected curl multi state in process_data, "
-                    "please open an issue on GitHub\n",
-                    CurlCffiWarning,
-                    stacklevel=2,
-                )
+    def _finish(self, easy: Any, retcode: int) -> None:
+        curl = self._curl2curl.get(easy)
+        if curl is None:
+            return  # already removed, e.g. cancelled
+        try:
+            callback_exception = curl._get_callback_exception()
+            if callback_exception is not None:
+                self.set_exception(curl, callback_exception)
+            elif retcode == 0:
+                self.set_result(curl)
+            else:
+                self.set_exception(curl, curl._get_error(retcode, "perform"))
+        except Exception:
+            warnings.warn(
+                "Unexpected curl multi state in process_data, "
+                "please open an issue on GitHub\n",
+                CurlCffiWarning,
+                stacklevel=2,
+            )
+
+    def _update_events(self) -> None:
+        """Apply the socket and timer changes collected by the shim."""
+        if self._curlm is None:
+            return
+        events = self._events
+        events.notified = 0
+        if events.timer_set:
+            events.timer_set = 0
+            self._set_timer(events.timeout_ms)
+        nsocks = events.nsocks
+        if nsocks:
+            socks = events.socks
+            changes = [
+                (socks[i].fd, socks[i].what, socks[i].removed) for i in range(nsocks)
+            ]
+            events.nsocks = 0
+            for sockfd, what, removed in changes:
+                self._watch(sockfd, what, removed)
+
+    def _set_timer(self, timeout_ms: int) -> None:
+        """
+        see: https://curl.se/libcurl/c/CURLMOPT_TIMERFUNCTION.html
+        """
+        # Cancel the timer anyway, if it's -1, yes, libcurl says it should be cancelled.
+        # If not, to add a new timer, we need to cancel the old timer.
+        if self._timer:
+            self._timer.cancel()  # If already called, cancel does nothing.
+            self._timer = None
+
+        # libcurl says to install a timer which calls socket_action on fire.
+        if timeout_ms >= 0:
+            self._timer = self.loop.call_later(
+                timeout_ms / 1000,
+                self.process_data,
+                CURL_SOCKET_TIMEOUT,  # -1
+                CURL_POLL_NONE,  # 0
+            )
+
+    def _watch(self, sockfd: int, what: int, removed: bool) -> None:
+        """Update the loop readers and writers of a socket to what libcurl wants,
+        see: https://curl.se/libcurl/c/CURLMOPT_SOCKETFUNCTION.html"""
+        loop = self.loop
+        watched = self._sockfds.pop(sockfd, CURL_POLL_NONE)
+        wanted = CURL_POLL_NONE if what == CURL_POLL_REMOVE else what
+        if removed:
+            # closed and reopened, the old registration is stale
+            self._unwatch(sockfd, CURL_POLL_INOUT)
+            watched = CURL_POLL_NONE
+        changed = watched ^ wanted
+
+        # No longer needed
+        self._unwatch(sockfd, changed & watched)
+
+        # Need to read from the socket
+        if changed & wanted & CURL_POLL_IN:
+            loop.add_reader(sockfd, self.process_data, sockfd, CURL_CSELECT_IN)
+
+        # Need to write to the socket
+        if changed & wanted & CURL_POLL_OUT:
+            loop.add_writer(sockfd, self.process_data, sockfd, CURL_CSELECT_OUT)
+
+        if wanted:
+            self._sockfds[sockfd] = wanted
+
+    def _unwatch(self, sockfd: int, what: int) -> None:
+        # libcurl may have closed the socket by now, the selector drops it anyway
+        # when it fails to modify the registration.
+        if what & CURL_POLL_IN:
+            with suppress(OSError):
+                self.loop.remove_reader(sockfd)
+        if what & CURL_POLL_OUT:
+            with suppress(OSError):
+                self.loop.remove_writer(sockfd)
 
     def _pop_future(self, curl: Curl):
-        errcode = lib.curl_multi_remove_handle(self._curlm, curl._curl)
+        with self._multi_guard:
+            self._events.busy = 1
+            errcode = lib.curl_multi_remove_handle(self._curlm, curl._curl)
+            self._events.busy = 0
+        curl._multi_guard = None
         self._check_error(errcode)
+        self._update_events()
         self._curl2curl.pop(curl._curl, None)
+        self._wakeups.pop(curl, None)
         return self._curl2future.pop(curl, None)
 
+    def handles(self) -> list[Curl]:
+        """The curl handles being performed."""
+        return list(self._curl2future)
+
     def remove_handle(self, curl: Curl):
         """Cancel a future for given curl handle."""
         future = self._pop_future(curl)
@@ -343,4 +533,5 @@ class AsyncCurl:
             c_value = ffi.new("long*", value)
         else:
             c_value = value
-        return lib.curl_multi_setopt(self._curlm, option, c_value)
+        with self._multi_guard:
+            return lib.curl_multi_setopt(self._curlm, option, c_value)
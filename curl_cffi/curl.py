@@ -1,14 +1,18 @@
 from __future__ import annotations
 
 import locale
+import mmap
 import re
 import struct
 import ssl
 import sys
+import threading
 import warnings
+from collections.abc import AsyncIterable, Callable, Iterable, Sequence
+from contextlib import AbstractContextManager
 from http.cookies import SimpleCookie
 from pathlib import Path
-from typing import TYPE_CHECKING, Any, Literal, cast
+from typing import IO, TYPE_CHECKING, Any, Literal, cast
 
 import os
 
@@ -77,6 +81,18 @@ CURL_SEEKFUNC_OK = 0
 CURL_SEEKFUNC_FAIL = 1
 CURL_SEEKFUNC_CANTSEEK = 2
 
+CURLMSG_DONE = 1
+
+CURL_LOCK_DATA_COOKIE = 2
+CURL_LOCK_DATA_DNS = 3
+CURL_LOCK_DATA_SSL_SESSION = 4
+CURL_LOCK_DATA_CONNECT = 5
+
+CURLALTSVC_H1 = 1 << 3
+CURLALTSVC_H2 = 1 << 4
+CURLALTSVC_H3 = 1 << 5
+CURLHSTS_ENABLE = 1 << 0
+
 CURLPAUSE_RECV = 1 << 0
 CURLPAUSE_RECV_CONT = 0
 CURLPAUSE_SEND = 1 << 2
@@ -256,6 +272,347 @@ def slist_to_list(head) -> list[bytes]:
     return result
 
 
+_METHOD_DEFAULTS = ((CurlOpt.HTTPGET, 1), (CurlOpt.CUSTOMREQUEST, None))
+_WRITE_DEFAULTS = (
+    (CurlOpt.WRITEFUNCTION, "_curl_discard_write"),
+    (CurlOpt.WRITEDATA, None),
+)
+_HEADER_DEFAULTS = ((CurlOpt.HEADERFUNCTION, None), (CurlOpt.HEADERDATA, None))
+_READ_DEFAULTS = ((CurlOpt.READFUNCTION, "_curl_empty_read"), (CurlOpt.READDATA, None))
+_SEEK_DEFAULTS = ((CurlOpt.SEEKFUNCTION, None), (CurlOpt.SEEKDATA, None))
+
+# How ``Curl.soft_reset`` undoes options set for a single request. ``None`` is a NULL
+# pointer, ``str`` names a shim function. An option not listed here can't be restored
+# without knowing its default, so it triggers a full ``curl_easy_reset`` instead.
+_SOFT_RESET_DEFAULTS: dict[int, tuple[tuple[CurlOpt, int | str | None], ...]] = {
+    CurlOpt.HTTPGET: _METHOD_DEFAULTS,
+    CurlOpt.POST: _METHOD_DEFAULTS,
+    CurlOpt.NOBODY: _METHOD_DEFAULTS,
+    CurlOpt.UPLOAD: _METHOD_DEFAULTS,
+    CurlOpt.CUSTOMREQUEST: _METHOD_DEFAULTS,
+    CurlOpt.URL: ((CurlOpt.URL, None),),
+    CurlOpt.POSTFIELDS: ((CurlOpt.POSTFIELDS, None),),
+    CurlOpt.POSTFIELDSIZE: ((CurlOpt.POSTFIELDSIZE, -1),),
+    CurlOpt.POSTFIELDSIZE_LARGE: ((CurlOpt.POSTFIELDSIZE_LARGE, -1),),
+    CurlOpt.INFILESIZE: ((CurlOpt.INFILESIZE, -1),),
+    CurlOpt.INFILESIZE_LARGE: ((CurlOpt.INFILESIZE_LARGE, -1),),
+    CurlOpt.MIMEPOST: ((CurlOpt.MIMEPOST, None),),
+    CurlOpt.HTTPHEADER: ((CurlOpt.HTTPHEADER, None),),
+    CurlOpt.HTTP3_HTTPHEADER: ((CurlOpt.HTTP3_HTTPHEADER, None),),
+    CurlOpt.WS_HTTPHEADER: ((CurlOpt.WS_HTTPHEADER, None),),
+    CurlOpt.PROXYHEADER: ((CurlOpt.PROXYHEADER, None),),
+    CurlOpt.RESOLVE: ((CurlOpt.RESOLVE, None),),
+    # the cookie engine keeps its state anyway, and every request clears it first
+    CurlOpt.COOKIEFILE: (),
+    CurlOpt.COOKIELIST: (),
+    CurlOpt.COOKIE: ((CurlOpt.COOKIE, None),),
+    CurlOpt.USERNAME: ((CurlOpt.USERNAME, None),),
+    CurlOpt.PASSWORD: ((CurlOpt.PASSWORD, None),),
+    CurlOpt.CONNECTTIMEOUT_MS: ((CurlOpt.CONNECTTIMEOUT_MS, 0),),
+    CurlOpt.TIMEOUT_MS: ((CurlOpt.TIMEOUT_MS, 0),),
+    CurlOpt.LOW_SPEED_LIMIT: ((CurlOpt.LOW_SPEED_LIMIT, 0),),
+    CurlOpt.LOW_SPEED_TIME: ((CurlOpt.LOW_SPEED_TIME, 0),),
+    CurlOpt.FOLLOWLOCATION: ((CurlOpt.FOLLOWLOCATION, 0),),
+    CurlOpt.MAXREDIRS: ((CurlOpt.MAXREDIRS, 30),),
+    CurlOpt.PROXY: ((CurlOpt.PROXY, None),),
+    CurlOpt.PROXY_CREDENTIAL_NO_REUSE: ((CurlOpt.PROXY_CREDENTIAL_NO_REUSE, 0),),
+    CurlOpt.HTTPPROXYTUNNEL: ((CurlOpt.HTTPPROXYTUNNEL, 0),),
+    CurlOpt.PROXYUSERNAME: ((CurlOpt.PROXYUSERNAME, None),),
+    CurlOpt.PROXYPASSWORD: ((CurlOpt.PROXYPASSWORD, None),),
+    CurlOpt.SSL_VERIFYPEER: ((CurlOpt.SSL_VERIFYPEER, 1),),
+    CurlOpt.SSL_VERIFYHOST: ((CurlOpt.SSL_VERIFYHOST, 2),),
+    # restored to the cacert of the handle by _ensure_cacert
+    CurlOpt.CAINFO: (),
+    CurlOpt.PROXY_CAINFO: (),
+    CurlOpt.REFERER: ((CurlOpt.REFERER, None),),
+    CurlOpt.MAX_RECV_SPEED_LARGE: ((CurlOpt.MAX_RECV_SPEED_LARGE, 0),),
+    CurlOpt.PIPEWAIT: ((CurlOpt.PIPEWAIT, 0),),
+    CurlOpt.RESUME_FROM_LARGE: ((CurlOpt.RESUME_FROM_LARGE, 0),),
+    CurlOpt.WRITEDATA: _WRITE_DEFAULTS,
+    CurlOpt.WRITEFUNCTION: _WRITE_DEFAULTS,
+    CurlOpt.HEADERDATA: _HEADER_DEFAULTS,
+    CurlOpt.HEADERFUNCTION: _HEADER_DEFAULTS,
+    CurlOpt.READDATA: _READ_DEFAULTS,
+    CurlOpt.READFUNCTION: _READ_DEFAULTS,
+    CurlOpt.SEEKDATA: _SEEK_DEFAULTS,
+    CurlOpt.SEEKFUNCTION: _SEEK_DEFAULTS,
+}
+
+
+class CurlBuffer:
+    """A growable buffer living in C memory.
+
+    When passed as ``WRITEDATA`` or ``HEADERDATA``, libcurl writes into it directly
+    from the shim, no python callback is involved and the GIL is not taken.
+    """
+
+    _write_function = "_curl_buffer_write"
+
+    def __init__(self, capacity: int = 0) -> None:
+        """
+        Parameters:
+            capacity: bytes to pre-allocate, the buffer grows as needed anyway.
+        """
+        buffer = lib._curl_buffer_new(capacity)
+        if buffer == ffi.NULL:
+            raise MemoryError("Failed to allocate curl buffer")
+        self._buffer = ffi.gc(buffer, lib._curl_buffer_free)
+
+    def __len__(self) -> int:
+        return self._buffer.size
+
+    def write(self, data: bytes) -> int:
+        """Append data to the buffer, mainly for API parity with ``BytesIO``."""
+        size = len(data)
+        if not size:
+            return 0
+        wrote = lib._curl_buffer_write(ffi.from_buffer(data), 1, size, self._buffer)
+        if wrote != size:
+            raise MemoryError("Failed to grow curl buffer")
+        return size
+
+    def getbuffer(self) -> memoryview:
+        """Return a zero-copy view of the content.
+
+        The view is invalidated by any further write, clear or the buffer being
+        garbage collected, use ``getvalue`` if you need to keep the data around.
+        """
+        if not self._buffer.size:
+            return memoryview(b"")
+        return memoryview(ffi.buffer(self._buffer.data, self._buffer.size))
+
+    def getvalue(self) -> bytes:
+        """Return the content as bytes, this is the only copy on the happy path."""
+        if not self._buffer.size:
+            return b""
+        return ffi.unpack(self._buffer.data, self._buffer.size)
+
+    def clear(self) -> None:
+        """Drop the content but keep the allocated memory for reuse."""
+        lib._curl_buffer_clear(self._buffer)
+
+
+class CurlRingBuffer:
+    """A bounded ring buffer living in C memory, for streaming responses.
+
+    When passed as ``WRITEDATA``, libcurl writes into it from the shim. Once it is
+    full, the transfer is paused instead of buffering more, and it should be
+    resumed with ``CURLPAUSE_CONT`` after the reader consumed enough data, see
+    ``paused`` and ``resumable``. ``Curl.perform_ring`` does that for readers in
+    another thread, which hold ``cond`` while touching the ring.
+    """
+
+    _write_function = "_curl_ring_write"
+
+    def __init__(self, capacity: int = 1 << 20) -> None:
+        """
+        Parameters:
+            capacity: size of the ring in bytes, it never grows. A single chunk from
+                libcurl larger than that is still accepted when the ring is empty,
+                the rest of it is moved in as the ring is consumed.
+        """
+        if capacity <= 0:
+            raise ValueError("capacity must be positive")
+        # owned here rather than by the C ring, the views from peek keep it alive
+        self._data = ffi.new("char[]", capacity)
+        ring = lib._curl_ring_new(self._data, capacity)
+        if ring == ffi.NULL:
+            raise MemoryError("Failed to allocate curl ring buffer")
+        self._buffer = ffi.gc(ring, lib._curl_ring_free)
+        self._multi: Any = None
+        self.cond = threading.Condition()
+
+    def __len__(self) -> int:
+        return self._buffer.size
+
+    @property
+    def capacity(self) -> int:
+        return self._buffer.capacity
+
+    @property
+    def closed(self) -> bool:
+        return bool(self._buffer.closed)
+
+    @property
+    def paused(self) -> bool:
+        """Whether libcurl was told to pause, because a chunk did not fit."""
+        return self._buffer.pending != 0
+
+    @property
+    def resumable(self) -> bool:
+        """Whether the chunk refused by the ring fits now."""
+        ring = self._buffer
+        if not ring.pending or ring.spill != ffi.NULL:
+            return False
+        # a chunk larger than the ring is taken once the ring is empty
+        return not ring.size or ring.capacity - ring.size >= ring.pending
+
+    def peek(self) -> memoryview:
+        """Return a zero-copy view of the oldest contiguous data in the ring.
+
+        The view keeps the memory of the ring alive, but its content is only valid
+        until the data is consumed, so release it before ``consume``. The ring may
+        wrap around, another ``peek`` can return the rest.
+        """
+        ring = self._buffer
+        start = ring.start
+        size = min(ring.size, ring.capacity - start)
+        if not size:
+            return memoryview(b"")
+        return memoryview(ffi.buffer(self._data))[start : start + size]
+
+    def consume(self, size: int) -> None:
+        """Release ``size`` bytes at the head of the ring."""
+        lib._curl_ring_consume(self._buffer, size)
+        if self._multi is not None and self.resumable:
+            lib.curl_multi_wakeup(self._multi)
+
+    def close(self) -> None:
+        """Abort the transfer writing into the ring, at its next write."""
+        with self.cond:
+            self._buffer.closed = 1
+            if self._multi is not None:
+                lib.curl_multi_wakeup(self._multi)
+            self.cond.notify_all()
+
+
+class CurlFileSink:
+    """Writes the response body straight to a file with ``write(2)``.
+
+    When passed as ``WRITEDATA``, neither python nor the GIL is involved for the
+    body, which is written at the current position of the file.
+    """
+
+    _write_function = "_curl_file_write"
+
+    def __init__(self, file: int | IO[bytes]) -> None:
+        """
+        Parameters:
+            file: a file descriptor or a binary file object, which is flushed first
+                and must stay open during the transfer.
+        """
+        if isinstance(file, int):
+            fd = file
+        else:
+            file.flush()
+            fd = file.fileno()
+        sink = lib._curl_file_new(fd)
+        if sink == ffi.NULL:
+            raise MemoryError("Failed to allocate curl file sink")
+        self._buffer = ffi.gc(sink, lib._curl_file_free)
+        self._file = file
+
+    def __len__(self) -> int:
+        return self._buffer.written
+
+    @property
+    def exception(self) -> OSError | None:
+        """The failed write which aborted the transfer, if any."""
+        errno = self._buffer.error
+        if not errno:
+            return None
+        return OSError(errno, os.strerror(errno))
+
+
+class CurlFileSource:
+    """Reads the request body straight from a file with ``pread(2)``.
+
+    When passed as ``READDATA``, the upload is read by the shim, without python or
+    the GIL. The position of the file is not changed, so the same source can be
+    rewound by libcurl for redirects and authentication.
+    """
+
+    _read_function = "_curl_fd_read"
+    _seek_function = "_curl_fd_seek"
+
+    def __init__(self, file: int | IO[bytes], start: int, length: int) -> None:
+        """
+        Parameters:
+            file: a file descriptor or a binary file object, which must stay open
+                during the transfer.
+            start: offset in the file where the body starts.
+            length: size of the body.
+        """
+        fd = file if isinstance(file, int) else file.fileno()
+        reader = lib._curl_fd_reader_new(fd, start, length)
+        if reader == ffi.NULL:
+            raise MemoryError("Failed to allocate curl file source")
+        self._buffer = ffi.gc(reader, lib._curl_fd_reader_free)
+        self._file = file
+
+    def __len__(self) -> int:
+        return self._buffer.length
+
+    def tell(self) -> int:
+        """Bytes of the body handed to libcurl so far."""
+        return self._buffer.offset
+
+    @property
+    def exception(self) -> OSError | None:
+        """The failed read which aborted the transfer, if any."""
+        errno = self._buffer.error
+        if not errno:
+            return None
+        return OSError(errno, os.strerror(errno))
+
+
+class CurlHeaderBuffer:
+    """Collects response headers in C memory.
+
+    Header lines are split into name/value pairs by the shim as they arrive, one
+    block per response in the transfer, e.g. redirects and ``100 Continue``.
+    """
+
+    _write_function = "_curl_headers_write"
+
+    def __init__(self) -> None:
+        headers = lib._curl_headers_new()
+        if headers == ffi.NULL:
+            raise MemoryError("Failed to allocate curl header buffer")
+        self._buffer = ffi.gc(headers, lib._curl_headers_free)
+        self._blocks: list[tuple[int, bytes, list[tuple[bytes, bytes]]]] | None = None
+
+    def blocks(self) -> list[tuple[int, bytes, list[tuple[bytes, bytes]]]]:
+        """Return a list of ``(status, reason, [(name, value), ...])`` blocks.
+
+        Headers received before any status line are put in a block with status 0.
+        The result is cached, so it can be taken as a snapshot while the transfer
+        is still running, e.g. from a write callback.
+        """
+        if self._blocks is not None:
+            return self._blocks
+        headers = self._buffer
+        if not headers.nblocks:
+            self._blocks = []
+            return self._blocks
+        # one crossing for each array, slicing is cheap compared to ffi calls
+        data = b""
+        if headers.data.size:
+            data = ffi.unpack(headers.data.data, headers.data.size)
+        fields = []
+        if headers.nfields:
+            fields = ffi.unpack(headers.fields, headers.nfields * 4)
+        raw_blocks = ffi.unpack(headers.blocks, headers.nblocks * 5)
+        blocks = []
+        for i in range(0, len(raw_blocks), 5):
+            status, reason_off, reason_len, first, count = raw_blocks[i : i + 5]
+            pairs = []
+            for j in range(first * 4, (first + count) * 4, 4):
+                name_off, name_len, value_off, value_len = fields[j : j + 4]
+                name = data[name_off : name_off + name_len]
+                value = data[value_off : value_off + value_len]
+                pairs.append((name, value))
+            reason = data[reason_off : reason_off + reason_len]
+            blocks.append((status, reason, pairs))
+        self._blocks = blocks
+        return blocks
+
+    def clear(self) -> None:
+        """Drop collected headers but keep the allocated memory for reuse."""
+        lib._curl_headers_clear(self._buffer)
+        self._blocks = None
+
+
 class Curl:
     """
     Wrapper for ``curl_easy_*`` functions of libcurl.
@@ -285,6 +642,25 @@ class Curl:
         self._body_handle: Any = None
         self._read_handle: Any = None
         self._seek_handle: Any = None
+        self._read_buffer: CurlFileSource | None = None
+        self._mime: CurlMime | None = None
+        self._write_buffer: CurlBuffer | CurlRingBuffer | CurlFileSink | None = (
+            None
+        )
+        self._header_buffer: CurlBuffer | CurlHeaderBuffer | None = None
+        self._share: CurlShare | None = None
+        # set by AsyncCurl while a driver thread may be polling the multi handle
+        self._multi_guard: AbstractContextManager[Any] | None = None
+        self._persistent_files: tuple[str | None, str | None] = (None, None)
+        self._info_arrays: dict[tuple[CurlInfo, ...], Any] = {}
+        # Integer options are dereferenced by the shim right away, so one holder
+        # per type is enough and saves an allocation for each setopt call.
+        self._long_holder = ffi.new("long *")
+        self._int64_holder = ffi.new("int64_t *")
+        # Bookkeeping for apply_template and soft_reset.
+        self._template_key: Any = None
+        self._track_options = True
+        self._dirty_options: set[int] = set()
         # TODO: use CURL_ERROR_SIZE
         self._error_buffer = ffi.new("char[]", 256)
         self._debug = debug
@@ -295,13 +671,20 @@ class Curl:
         self._ws_recv_n_recv = ffi.new("size_t *")
         self._ws_recv_p_frame = ffi.new("struct curl_ws_frame **")
         self._ws_send_n_sent = ffi.new("size_t *")
+        self._ws_chunks: Any = None
+        self._ws_send_frames: Any = None
+        self._ws_n_chunks = ffi.new("size_t *")
 
     def _set_error_buffer(self) -> None:
         ret = lib._curl_easy_setopt(self._curl, CurlOpt.ERRORBUFFER, self._error_buffer)
         if ret != 0:
             warnings.warn("Failed to set error buffer", CurlCffiWarning, stacklevel=2)
         if self._debug:
-            self.debug()
+            self._track_options = False
+            try:
+                self.debug()
+            finally:
+                self._track_options = True
 
     def debug(self) -> None:
         """Set debug to True"""
@@ -342,6 +725,14 @@ class Curl:
                 exception = ffi.from_handle(handle).exception
                 if exception is not None:
                     return exception
+        if self._read_buffer is not None and self._read_buffer.exception:
+            return self._read_buffer.exception
+        if self._mime is not None:
+            exception = self._mime._get_callback_exception()
+            if exception is not None:
+                return exception
+        if isinstance(self._write_buffer, CurlFileSink):
+            return self._write_buffer.exception
         return None
 
     def setopt(self, option: CurlOpt, value: Any) -> int:
@@ -356,6 +747,8 @@ class Curl:
         """
         if self._curl is None:
             return 0  # silently ignore if curl handle is None
+        if self._track_options:
+            self._dirty_options.add(option)
         input_option = {
             # this should be int in curl, but cffi requires pointer for void*
             # it will be convert back in the glue c code.
@@ -369,8 +762,36 @@ class Curl:
 
         # Convert value
         value_type = input_option.get((option // 10000) * 10000)
-        if value_type == "long*" or value_type == "int64_t*":
-            c_value = ffi.new(value_type, value)
+        if value_type == "long*":
+            c_value = self._long_holder
+            c_value[0] = value
+        elif value_type == "int64_t*":
+            c_value = self._int64_holder
+            c_value[0] = value
+        elif option in (CurlOpt.WRITEDATA, CurlOpt.HEADERDATA) and isinstance(
+            value, (CurlBuffer, CurlRingBuffer, CurlFileSink, CurlHeaderBuffer)
+        ):
+            # native sink, libcurl writes into C memory without calling python
+            c_value = value._buffer
+            if option == CurlOpt.WRITEDATA:
+                self._write_buffer = value
+                callback_option = CurlOpt.WRITEFUNCTION
+            else:
+                self._header_buffer = value
+                callback_option = CurlOpt.HEADERFUNCTION
+            lib._curl_easy_setopt(
+                self._curl,
+                callback_option,
+                ffi.addressof(lib, value._write_function),
+            )
+        elif option == CurlOpt.SHARE:
+            # keep the share alive for as long as this handle may use it
+            c_value = value._share.share if value is not None else ffi.NULL
+            self._share = value
+        elif option == CurlOpt.MIMEPOST and isinstance(value, CurlMime):
+            # the streamed parts report their errors through this handle
+            c_value = value._form
+            self._mime = value
         elif option == CurlOpt.WRITEDATA:
             c_value = ffi.new_handle(_CallbackContext(value))
             self._write_handle = c_value
@@ -383,6 +804,23 @@ class Curl:
             lib._curl_easy_setopt(
                 self._curl, CurlOpt.HEADERFUNCTION, lib.buffer_callback
             )
+        elif option == CurlOpt.READDATA and isinstance(value, CurlFileSource):
+            # native source, libcurl reads the body without calling python
+            c_value = value._buffer
+            self._read_buffer = value
+            lib._curl_easy_setopt(
+                self._curl,
+                CurlOpt.READFUNCTION,
+                ffi.addressof(lib, value._read_function),
+            )
+            lib._curl_easy_setopt(
+                self._curl,
+                CurlOpt.SEEKFUNCTION,
+                ffi.addressof(lib, value._seek_function),
+            )
+            lib._curl_easy_setopt(self._curl, CurlOpt.SEEKDATA, c_value)
+            if self._track_options:
+                self._dirty_options.add(CurlOpt.SEEKDATA)
         elif option == CurlOpt.READDATA:
             c_value = ffi.new_handle(_CallbackContext(value))
             self._read_handle = c_value
@@ -437,6 +875,8 @@ class Curl:
                     CurlOpt.SSH_PRIVATE_KEYFILE,
                     CurlOpt.COOKIEFILE,
                     CurlOpt.COOKIEJAR,
+                    CurlOpt.ALTSVC,
+                    CurlOpt.HSTS,
                     CurlOpt.NETRC_FILE,
                     CurlOpt.UNIX_SOCKET_PATH,
                 }
@@ -446,6 +886,9 @@ class Curl:
                     c_value = value.encode(enc, errors="strict")
                 else:
                     c_value = value.encode()
+            elif isinstance(value, (bytearray, memoryview, mmap.mmap)):
+                # pinned in place instead of copied to bytes
+                c_value = ffi.from_buffer(value)
             else:
                 c_value = value
             # Must keep a reference, otherwise may be GCed.
@@ -454,6 +897,10 @@ class Curl:
         else:
             raise NotImplementedError(f"Option unsupported: {option}")
 
+        if option == CurlOpt.MIMEPOST and not isinstance(value, CurlMime):
+            # cleared, e.g. by soft_reset, or a raw form, not ours to keep
+            self._mime = None
+
         header_options = {
             CurlOpt.HTTPHEADER: "_headers",
             CurlOpt.HTTP3_HTTPHEADER: "_http3_headers",
@@ -532,6 +979,52 @@ class Curl:
 
         return ret_cast_option[option_type](c_value[0])
 
+    def getinfo_many(
+        self, options: Sequence[CurlInfo]
+    ) -> list[bytes | int | float | list[str | int]]:
+        """Get multiple infos in one call, equivalent to calling ``getinfo`` for each
+        option, but crosses the ffi boundary only once.
+
+        Parameters:
+            options: infos to get, using constants from ``CurlInfo`` enum. The C
+                arrays are cached per sequence of options, so passing the same
+                tuple for every request is the cheapest.
+
+        Returns:
+            values retrieved from last perform, in the same order as ``options``.
+        """
+        key = tuple(options)
+        if self._curl is None:
+            return [b"" if o & 0xF00000 == 0x100000 else 0 for o in key]
+
+        arrays = self._info_arrays.get(key)
+        if arrays is None:
+            arrays = (
+                ffi.new("int[]", key),
+                ffi.new("union curl_cffi_info[]", len(key)),
+            )
+            self._info_arrays[key] = arrays
+        c_options, c_values = arrays
+
+        ret = lib._curl_easy_getinfo_many(self._curl, c_options, c_values, len(key))
+
+        results: list[bytes | int | float | list[str | int]] = []
+        for i, option in enumerate(key):
+            value = c_values[i]
+            option_type = option & 0xF00000
+            if option_type == 0x100000:
+                results.append(ffi.string(value.string) if value.string else b"")
+            elif option_type == 0x300000:
+                results.append(value.real)
+            elif option_type == 0x400000:
+                results.append(slist_to_list(value.list))  # type: ignore
+            elif option_type == 0x600000:
+                results.append(value.offset)
+            else:
+                results.append(value.number)
+        self._check_error(ret, "getinfo", *key)
+        return results
+
     def version(self) -> bytes:
         """Get the underlying libcurl version."""
         return ffi.string(lib.curl_version())
@@ -556,10 +1049,15 @@ class Curl:
         if self._skip_cacert:
             return
         if not self._is_cert_set:
-            ret = self.setopt(CurlOpt.CAINFO, self._cacert)
-            self._check_error(ret, "set cacert")
-            ret = self.setopt(CurlOpt.PROXY_CAINFO, self._cacert)
-            self._check_error(ret, "set proxy cacert")
+            # the default of this handle, soft_reset does not need to undo it
+            self._track_options = False
+            try:
+                ret = self.setopt(CurlOpt.CAINFO, self._cacert)
+                self._check_error(ret, "set cacert")
+                ret = self.setopt(CurlOpt.PROXY_CAINFO, self._cacert)
+                self._check_error(ret, "set proxy cacert")
+            finally:
+                self._track_options = True
 
     def perform(self, clear_headers: bool = True, clear_resolve: bool = True) -> None:
         """Wrapper for ``curl_easy_perform``, performs a curl request.
@@ -589,6 +1087,83 @@ class Curl:
             # cleaning
             self.clean_handles_and_buffers(clear_headers, clear_resolve)
 
+    def perform_ring(
+        self, ring: CurlRingBuffer, on_data: Callable[[], None] | None = None
+    ) -> None:
+        """Performs a request writing into ``ring``, which is read by another thread.
+
+        The transfer runs on a private multi handle, so that it can be resumed from
+        this thread whenever the reader made enough room, ``curl_easy_pause`` must
+        not be called from other threads.
+
+        Parameters:
+            ring: the ring buffer set as ``WRITEDATA``.
+            on_data: called with ``ring.cond`` held, each time new data is in the
+                ring, before the readers are notified.
+
+        Raises:
+            CurlError: if the perform was not successful.
+        """
+        if self._curl is None:
+            raise CurlError("Cannot perform request on closed handle.")
+
+        self._ensure_cacert()
+
+        multi = lib.curl_multi_init()
+        running = ffi.new("int *", 1)
+        ret = CurlECode.OK
+        lib.curl_multi_add_handle(multi, self._curl)
+        cond = ring.cond
+        buffer = ring._buffer
+        try:
+            with cond:
+                ring._multi = multi
+                # the readers see the written bytes once published below
+                buffer.deferred = 1
+            while running[0]:
+                with cond:
+                    resume = ring.paused and (ring.closed or ring.resumable)
+                # the readers keep consuming while libcurl writes
+                if resume:
+                    lib.curl_easy_pause(self._curl, CURLPAUSE_CONT)
+                code = lib.curl_multi_perform(multi, running)
+                with cond:
+                    if lib._curl_ring_publish(buffer):
+                        if on_data is not None:
+                            on_data()
+                        cond.notify_all()
+                if code != 0:
+                    break
+                if running[0]:
+                    lib.curl_multi_poll(multi, ffi.NULL, 0, 1000, ffi.NULL)
+            msg_in_queue = ffi.new("int *")
+            curl_msg = lib.curl_multi_info_read(multi, msg_in_queue)
+            # only one easy handle on this multi, so it is the DONE message for it
+            if curl_msg != ffi.NULL:
+                ret = curl_msg.data.result
+        finally:
+            with cond:
+                ring._multi = None
+                buffer.deferred = 0
+                if lib._curl_ring_publish(buffer) and on_data is not None:
+                    on_data()
+                cond.notify_all()
+            lib.curl_multi_remove_handle(multi, self._curl)
+            lib.curl_multi_cleanup(multi)
+
+        try:
+            callback_exception = self._get_callback_exception()
+            if callback_exception is not None:
+                raise callback_exception
+            if code != 0:
+                raise CurlError(
+                    f"Failed to perform, multi: ({code}) "
+                    f"{ffi.string(lib.curl_multi_strerror(code)).decode()}."
+                )
+            self._check_error(ret, "perform")
+        finally:
+            self.clean_handles_and_buffers()
+
     def upkeep(self) -> int:
         if self._curl is None:
             return 0  # silently ignore if curl handle is None
@@ -598,7 +1173,11 @@ class Curl:
         """Pause or resume data transfer on this handle."""
         if self._curl is None:
             return 0
-        ret = lib.curl_easy_pause(self._curl, action)
+        if self._multi_guard is not None:
+            with self._multi_guard:
+                ret = lib.curl_easy_pause(self._curl, action)
+        else:
+            ret = lib.curl_easy_pause(self._curl, action)
         self._check_error(ret, "pause")
         return ret
 
@@ -613,6 +1192,10 @@ class Curl:
         self._body_handle = None
         self._read_handle = None
         self._seek_handle = None
+        self._read_buffer = None
+        self._mime = None
+        self._write_buffer = None
+        self._header_buffer = None
 
         if clear_resolve:
             if self._resolve != ffi.NULL:
@@ -641,17 +1224,187 @@ class Curl:
             raise CurlError("Cannot duplicate closed handle.")
         new_handle = lib.curl_easy_duphandle(self._curl)
         c = Curl(cacert=self._cacert, debug=self._debug, handle=new_handle)
+        c._share = self._share  # copied by libcurl
+        c._persistent_files = self._persistent_files
         return c
 
     def reset(self) -> None:
         """Reset all curl options, wrapper for ``curl_easy_reset``."""
         self._is_cert_set = False
         self._skip_cacert = False
+        self._template_key = None
+        self._dirty_options.clear()
         if self._curl is not None:
-            lib.curl_easy_reset(self._curl)
+            # curl_easy_reset keeps the share attached, it must not outlive it
+            self.set_share(None)
+            if self._persistent_files != (None, None):
+                # it also keeps the Alt-Svc and HSTS caches, which must not leak into
+                # the next files, the old handle writes them back when cleaned up
+                lib.curl_easy_cleanup(self._curl)
+                self._curl = lib.curl_easy_init()
+                self._persistent_files = (None, None)
+            else:
+                lib.curl_easy_reset(self._curl)
             self._set_error_buffer()
         self._resolve = ffi.NULL
 
+    def set_share(self, share: CurlShare | None) -> None:
+        """Use the caches of ``share``, or stop sharing with ``None``.
+
+        Like template options, the share is kept by :meth:`soft_reset`, and
+        setting the same share again is a no-op.
+        """
+        if share is self._share:
+            return
+        self._track_options = False
+        try:
+            self.setopt(CurlOpt.SHARE, share)
+        finally:
+            self._track_options = True
+
+    @property
+    def persistent_files(self) -> tuple[str | None, str | None]:
+        """The Alt-Svc and HSTS files of this handle."""
+        return self._persistent_files
+
+    def set_persistent_files(
+        self, altsvc: str | None = None, hsts: str | None = None
+    ) -> None:
+        """Load the Alt-Svc and HSTS caches from these files, libcurl writes them
+        back, atomically, when the handle is closed. ``None`` stops using a file.
+
+        Like the share, the files are kept by :meth:`soft_reset`, and setting the
+        same files again is a no-op.
+        """
+        if (altsvc, hsts) == self._persistent_files:
+            return
+        self._track_options = False
+        try:
+            if altsvc is not None:
+                altsvc_ctrl = CURLALTSVC_H1 | CURLALTSVC_H2 | CURLALTSVC_H3
+                self._check_error(
+                    self.setopt(CurlOpt.ALTSVC_CTRL, altsvc_ctrl), "setopt ALTSVC_CTRL"
+                )
+            self._check_error(self.setopt(CurlOpt.ALTSVC, altsvc), "setopt ALTSVC")
+            hsts_ctrl = CURLHSTS_ENABLE if hsts is not None else 0
+            self._check_error(
+                self.setopt(CurlOpt.HSTS_CTRL, hsts_ctrl), "setopt HSTS_CTRL"
+            )
+            self._check_error(self.setopt(CurlOpt.HSTS, hsts), "setopt HSTS")
+        finally:
+            self._track_options = True
+        self._persistent_files = (altsvc, hsts)
+
+    def export_ssl_sessions(self) -> bytes:
+        """Serialize the TLS sessions cached by this handle, or by its share, for
+        :meth:`import_ssl_sessions`, wrapper for ``curl_easy_ssls_export``.
+
+        The records are in native byte order, not meant to move between machines.
+        Returns ``b""`` when libcurl was built without session export.
+        """
+        if self._curl is None:
+            raise CurlError("Cannot export TLS sessions of a closed handle.")
+        buffer = CurlBuffer()
+        ret = lib._curl_ssls_export(self._curl, buffer._buffer)
+        if ret == CurlECode.NOT_BUILT_IN:
+            return b""
+        self._check_error(ret, "export TLS sessions")
+        return buffer.getvalue()
+
+    def import_ssl_sessions(self, data: bytes) -> int:
+        """Add TLS sessions exported by :meth:`export_ssl_sessions` to the cache of
+        this handle, or of its share, wrapper for ``curl_easy_ssls_import``.
+
+        Sessions libcurl refuses, e.g. expired ones, are skipped.
+
+        Returns:
+            the number of sessions imported.
+        """
+        if self._curl is None:
+            raise CurlError("Cannot import TLS sessions into a closed handle.")
+        if not data:
+            return 0
+        imported = ffi.new("size_t *")
+        ret = lib._curl_ssls_import(self._curl, data, len(data), imported)
+        if ret == CurlECode.NOT_BUILT_IN:
+            return 0
+        self._check_error(ret, "import TLS sessions")
+        return imported[0]
+
+    def apply_template(self, key: Any, apply: Callable[[Curl], Any]) -> bool:
+        """Apply options shared by many requests once per handle.
+
+        ``apply`` is only called when ``key`` differs from the template applied last
+        time. When replacing another template, the handle is fully reset first,
+        options set on a handle without template are kept. Options set by
+        ``apply`` are kept by :meth:`soft_reset`, so they should be set before any
+        per-request option, and the key should cover every input of ``apply``.
+
+        Parameters:
+            key: comparable value identifying the options set by ``apply``.
+            apply: function setting the options on this handle.
+
+        Returns:
+            True if the template was (re-)applied, False if it was already there.
+        """
+        if self._template_key is not None:
+            if self._template_key == key:
+                return False
+            self.reset()
+        self._track_options = False
+        try:
+            apply(self)
+        finally:
+            self._track_options = True
+        self._template_key = key
+        return True
+
+    def soft_reset(self) -> None:
+        """Undo options set since the last reset, but keep the template.
+
+        Options set through :meth:`apply_template` and the cacert of this handle are
+        kept, so the next request only has to set what differs. Falls back to
+        :meth:`reset` if an option with an unknown default was set. Note that the
+        response body is discarded until a new ``WRITEDATA`` or ``WRITEFUNCTION``
+        is set, where a fully reset handle prints it to stdout.
+        """
+        if self._curl is None:
+            return
+        dirty = self._dirty_options
+        if any(option not in _SOFT_RESET_DEFAULTS for option in dirty):
+            self.clean_handles_and_buffers()
+            self.reset()
+            return
+
+        restored: set[CurlOpt] = set()
+        for option in dirty:
+            for default_option, default in _SOFT_RESET_DEFAULTS[option]:
+                if default_option in restored:
+                    continue
+                restored.add(default_option)
+                if default is None:
+                    c_value = ffi.NULL
+                elif isinstance(default, str):
+                    c_value = ffi.addressof(lib, default)
+                elif default_option >= 30000:  # offset type
+                    c_value = self._int64_holder
+                    c_value[0] = default
+                else:
+                    c_value = self._long_holder
+                    c_value[0] = default
+                lib._curl_easy_setopt(self._curl, default_option, c_value)
+
+        if CurlOpt.CAINFO in dirty or CurlOpt.PROXY_CAINFO in dirty:
+            # _ensure_cacert sets the default cacert again before the next perform
+            self._is_cert_set = False
+        self._skip_cacert = False
+        dirty.clear()
+
+        # header lists are not referenced by the handle anymore, free them
+        self.clean_handles_and_buffers()
+        # the debug callback handle was dropped with the other handles
+        self._set_error_buffer()
+
     def parse_cookie_headers(self, headers: list[bytes]) -> SimpleCookie:
         """Extract ``cookies.SimpleCookie`` from header lines.
 
@@ -704,6 +1457,7 @@ class Curl:
         if self._curl:
             lib.curl_easy_cleanup(self._curl)
             self._curl = None
+        self._share = None
         ffi.release(self._error_buffer)
 
         if self._ws_recv_buffer is not None:
@@ -737,6 +1491,65 @@ class Curl:
             self._ws_recv_p_frame[0],
         )
 
+    def ws_recv_into(self, buffer: bytearray | memoryview) -> tuple[int, CurlWsFrame]:
+        """Receive a frame, or as much of it as fits, into a writable ``buffer``.
+
+        Unlike :meth:`ws_recv`, the data is not copied into a new bytes object. The
+        rest of a frame larger than ``buffer`` is returned by the next calls, see
+        ``bytesleft`` of the frame meta.
+
+        Returns:
+            a tuple of the number of bytes received and curl frame meta struct.
+
+        Raises:
+            CurlError: if failed.
+        """
+        if self._curl is None:
+            raise CurlError("Cannot receive websocket data on closed handle.")
+
+        if ret := lib.curl_ws_recv(
+            self._curl,
+            ffi.from_buffer(buffer, require_writable=True),
+            len(buffer),
+            self._ws_recv_n_recv,
+            self._ws_recv_p_frame,
+        ):
+            self._check_error(ret, "WS_RECV")
+        return self._ws_recv_n_recv[0], self._ws_recv_p_frame[0]
+
+    def ws_recv_many(
+        self, buffer: bytearray | memoryview, max_chunks: int = 64
+    ) -> tuple[int, list[tuple[int, int, int, int]]]:
+        """Receive frames back to back into a writable ``buffer`` in a single call,
+        until there is nothing left to read, ``buffer`` is full, ``max_chunks`` frames
+        or parts of frames are received, or a close frame is received.
+
+        Unlike :meth:`ws_recv`, errors are returned rather than raised, so that an
+        empty socket costs no exception.
+
+        Returns:
+            a tuple of the curl code it stopped on, ``CurlECode.AGAIN`` when there
+            is nothing left to read and 0 when a limit was hit, and the
+            ``(offset, length, flags, bytesleft)`` of each chunk received before.
+        """
+        if self._curl is None:
+            raise CurlError("Cannot receive websocket data on closed handle.")
+
+        if self._ws_chunks is None or len(self._ws_chunks) < max_chunks:
+            self._ws_chunks = ffi.new("struct curl_cffi_ws_chunk[]", max_chunks)
+        code = lib._curl_ws_recv_many(
+            self._curl,
+            ffi.from_buffer(buffer, require_writable=True),
+            len(buffer),
+            self._ws_chunks,
+            max_chunks,
+            self._ws_n_chunks,
+        )
+        return code, [
+            (c.offset, c.len, c.flags, c.bytesleft)
+            for c in self._ws_chunks[0 : self._ws_n_chunks[0]]
+        ]
+
     def ws_send(
         self, payload: bytes | memoryview, flags: CurlWsFlag | int = CurlWsFlag.BINARY
     ) -> int:
@@ -766,6 +1579,54 @@ class Curl:
             self._check_error(ret, "WS_SEND")
         return self._ws_send_n_sent[0]
 
+    def ws_send_many(
+        self,
+        frames: Sequence[tuple[bytes | bytearray | memoryview, int]],
+        sent: int = 0,
+        offset: int = 0,
+    ) -> tuple[int, int, int]:
+        """Send the ``(payload, flags)`` frames in order with a single call, each one
+        keeps its own flags, i.e. messages are not merged, nor copied.
+
+        Args:
+            frames: the frames to send.
+            sent: frames already sent by an earlier call.
+            offset: bytes of the frame ``sent`` already sent by an earlier call.
+
+        Returns:
+            a tuple of the curl code it stopped on, which is returned rather than
+            raised, ``CurlECode.AGAIN`` when the socket is full, the number of frames
+            sent and the bytes of the next one sent. Stopping on 0 with frames left
+            means libcurl took no bytes.
+        """
+        if self._curl is None:
+            raise CurlError("Cannot send websocket data on closed handle.")
+
+        # only the frames left, a full socket calls again with the same frames
+        count = len(frames) - sent
+        out = self._ws_send_frames
+        if out is None or len(out) < count:
+            out = self._ws_send_frames = ffi.new(
+                "struct curl_cffi_ws_send_frame[]", max(count, 64)
+            )
+        # the buffers must outlive the call
+        buffers = []
+        for i in range(count):
+            payload, flags = frames[sent + i]
+            buffer = ffi.from_buffer(payload)
+            buffers.append(buffer)
+            frame = out[i]
+            frame.buffer = buffer
+            frame.len = len(buffer)
+            frame.flags = flags
+        n_sent = self._ws_n_chunks
+        n_sent[0] = 0
+        self._ws_send_n_sent[0] = offset
+        code = lib._curl_ws_send_many(
+            self._curl, out, count, n_sent, self._ws_send_n_sent
+        )
+        return code, sent + n_sent[0], self._ws_send_n_sent[0]
+
     def ws_close(self, code: int = 1000, message: bytes = b"") -> int:
         """Close a websocket connection. Shorthand for :meth:`ws_send`
         with close code and message. Note that to completely close the connection,
@@ -785,6 +1646,152 @@ class Curl:
         return self.ws_send(payload, flags=CurlWsFlag.CLOSE)
 
 
+class CurlMulti:
+    """A blocking wrapper for the ``curl_multi_`` API, to run many transfers from
+    one thread.
+
+    Unlike ``AsyncCurl``, there is no event loop, ``poll`` waits for activity on
+    all the added handles with ``curl_multi_poll``.
+    """
+
+    def __init__(self) -> None:
+        self._curlm = lib.curl_multi_init()
+        if self._curlm == ffi.NULL:
+            raise CurlError("Failed to init curl multi handle")
+        self._curl2curl: dict[Any, Curl] = {}
+        self._running = ffi.new("int *")
+        self._msg_in_queue = ffi.new("int *")
+
+    def __len__(self) -> int:
+        return len(self._curl2curl)
+
+    def __enter__(self) -> CurlMulti:
+        return self
+
+    def __exit__(self, *args) -> None:
+        self.close()
+
+    def add_handle(self, curl: Curl) -> None:
+        """Add a curl handle, the transfer starts on the next ``perform``."""
+        if self._curlm is None:
+            raise CurlError("Cannot add handle to closed multi handle.")
+        curl._ensure_cacert()
+        self._check_error(lib.curl_multi_add_handle(self._curlm, curl._curl), "add")
+        self._curl2curl[curl._curl] = curl
+
+    def remove_handle(self, curl: Curl) -> None:
+        """Remove a curl handle, aborting its transfer if it's still running."""
+        if self._curl2curl.pop(curl._curl, None) is not None:
+            lib.curl_multi_remove_handle(self._curlm, curl._curl)
+
+    def perform(self) -> int:
+        """Wrapper for ``curl_multi_perform``, returns the number of running
+        transfers."""
+        if self._curlm is None:
+            raise CurlError("Cannot perform on closed multi handle.")
+        code = lib.curl_multi_perform(self._curlm, self._running)
+        self._check_error(code, "perform")
+        return self._running[0]
+
+    def poll(self, timeout_ms: int = 1000) -> None:
+        """Wrapper for ``curl_multi_poll``, waits until there is something to do
+        for ``perform``, the timeout expires, or ``wakeup`` is called."""
+        if self._curlm is None:
+            raise CurlError("Cannot poll on closed multi handle.")
+        code = lib.curl_multi_poll(self._curlm, ffi.NULL, 0, timeout_ms, ffi.NULL)
+        self._check_error(code, "poll")
+
+    def wakeup(self) -> None:
+        """Interrupt a ``poll`` in progress, safe to call from any thread."""
+        if self._curlm is not None:
+            lib.curl_multi_wakeup(self._curlm)
+
+    def info_read(self) -> list[tuple[Curl, BaseException | None]]:
+        """Remove the finished handles, returning them with the error they failed
+        with, if any."""
+        done = []
+        while self._curlm is not None:
+            curl_msg = lib.curl_multi_info_read(self._curlm, self._msg_in_queue)
+            if curl_msg == ffi.NULL:
+                break
+            if curl_msg.msg != CURLMSG_DONE:
+                continue
+            curl = self._curl2curl[curl_msg.easy_handle]
+            retcode = curl_msg.data.result
+            self.remove_handle(curl)
+            error = curl._get_callback_exception() or curl._get_error(
+                retcode, "perform"
+            )
+            curl.clean_handles_and_buffers()
+            done.append((curl, error))
+        return done
+
+    def close(self) -> None:
+        """Remove all handles and clean up the multi handle."""
+        if self._curlm is None:
+            return
+        for curl in list(self._curl2curl.values()):
+            self.remove_handle(curl)
+        lib.curl_multi_cleanup(self._curlm)
+        self._curlm = None
+
+    def _check_error(self, errcode: int, action: str) -> None:
+        if errcode != 0:
+            errmsg = ffi.string(lib.curl_multi_strerror(errcode)).decode()
+            raise CurlError(f"Failed to {action}, multi: ({errcode}) {errmsg}.")
+
+
+class CurlShare:
+    """Wrapper for the ``curl_share_`` API, caches shared by many curl handles.
+
+    Handles using the same share resolve a host once, resume TLS sessions with each
+    other's session tickets and, if enabled, reuse each other's connections and
+    cookies. Every kind of shared data is guarded by its own mutex, so the handles
+    may run in different threads.
+
+    Note that libcurl does not support sharing connections between handles running
+    concurrently in different threads, only enable ``connections`` when the handles
+    are used from one thread at a time, e.g. a single session. Handles added to one
+    ``curl_multi`` share their connections anyway.
+    """
+
+    def __init__(
+        self,
+        dns: bool = True,
+        ssl_session: bool = True,
+        connections: bool = False,
+        cookies: bool = False,
+    ) -> None:
+        """
+        Parameters:
+            dns: share the DNS cache.
+            ssl_session: share TLS session ids and tickets.
+            connections: share the connection cache.
+            cookies: share the cookie engine of libcurl. Sessions keep their cookies
+                in python, unless created with ``cookie_engine=True``.
+        """
+        share = lib._curl_share_new()
+        if share == ffi.NULL:
+            raise CurlError("Failed to init curl share handle")
+        self._share = ffi.gc(share, lib._curl_share_free)
+        self.ssl_session = ssl_session
+        self.cookies = cookies
+        shared = (
+            (dns, CURL_LOCK_DATA_DNS),
+            (ssl_session, CURL_LOCK_DATA_SSL_SESSION),
+            (connections, CURL_LOCK_DATA_CONNECT),
+            (cookies, CURL_LOCK_DATA_COOKIE),
+        )
+        for enabled, data in shared:
+            if enabled:
+                self._check_error(lib._curl_share_add(share, data), "share")
+
+    def _check_error(self, errcode: int, action: str) -> None:
+        if errcode != 0:
+            errmsg = ffi.string(lib.curl_share_strerror(errcode)).decode()
+            raise CurlError(f"Failed to {action}, share: ({errcode}) {errmsg}.")
+
+
 class CurlMime:
     """Wrapper for the ``curl_mime_`` API."""
 
@@ -795,6 +1802,9 @@ class CurlMime:
         """
         self._curl = curl if curl else Curl()
         self._form = lib.curl_mime_init(self._curl._curl)
+        # sources of the streamed parts, alive until the form is freed
+        self._sources: list[Any] = []
+        self._async_readers: list[Any] = []
 
     def addpart(
         self,
@@ -804,10 +1814,12 @@ class CurlMime:
         filename: str | None = None,
         local_path: str | bytes | Path | None = None,
         data: bytes | None = None,
+        content: IO[bytes] | Iterable[bytes] | AsyncIterable[bytes] | None = None,
+        size: int | None = None,
     ) -> None:
         """Add a mime part for a mutlipart html form.
 
-        Note: You can only use either local_path or data, not both.
+        Note: You can only use one of local_path, data and content.
 
         Args:
             name: name of the field.
@@ -815,6 +1827,11 @@ class CurlMime:
             filename: filename for the server.
             local_path: file to upload on local disk.
             data: file content to upload.
+            content: a binary file object, or an iterable of bytes, streamed during
+                the transfer instead of copied into memory. Async iterables are only
+                supported by ``AsyncSession``.
+            size: size of ``content``, if known. Seekable files are measured,
+                otherwise the request is sent with chunked encoding.
         """
         part = lib.curl_mime_addpart(self._form)
 
@@ -828,8 +1845,8 @@ class CurlMime:
             if ret != 0:
                 raise CurlError("Add field failed.")
 
-        if local_path and data:
-            raise CurlError("Can not use local_path and data at the same time.")
+        if (local_path and data) or (content is not None and (local_path or data)):
+            raise CurlError("Can only use one of local_path, data and content.")
 
         # this is a filename
         if local_path is not None:
@@ -857,6 +1874,67 @@ class CurlMime:
                 data = str(data).encode()
             ret = lib.curl_mime_data(part, data, len(data))
 
+        if content is not None:
+            self._add_stream(part, content, size)
+
+    def _add_stream(self, part: Any, content: Any, size: int | None) -> None:
+        # imported here, the module of the readers imports this one
+        from .requests.streams import (
+            _AsyncIterableReader,
+            _FileReader,
+            _IterableReader,
+        )
+
+        seekable = False
+        if hasattr(content, "read"):
+            reader: Any = _FileReader(content)
+            if size is None or size == reader.length:
+                source = reader.native()
+                if source is not None:
+                    # a regular file, read by the shim without the GIL
+                    self._sources.append(source)
+                    ret = lib.curl_mime_data_cb(
+                        part,
+                        len(source),
+                        ffi.addressof(lib, source._read_function),
+                        ffi.addressof(lib, source._seek_function),
+                        ffi.NULL,
+                        source._buffer,
+                    )
+                    if ret != 0:
+                        raise CurlError("Add field failed.")
+                    return
+                size = reader.length
+            seekable = reader.rewindable
+        elif isinstance(content, AsyncIterable):
+            # bound to the handle performing the request by AsyncSession
+            reader = _AsyncIterableReader(content, self._curl)
+            self._async_readers.append(reader)
+        else:
+            reader = _IterableReader(content)
+        handle = ffi.new_handle(_CallbackContext(reader))
+        self._sources.append(handle)
+        ret = lib.curl_mime_data_cb(
+            part,
+            -1 if size is None else size,
+            lib.read_buffer_callback,
+            lib.seek_buffer_callback if seekable else ffi.NULL,
+            ffi.NULL,
+            handle,
+        )
+        if ret != 0:
+            raise CurlError("Add field failed.")
+
+    def _get_callback_exception(self) -> BaseException | None:
+        for source in self._sources:
+            if isinstance(source, CurlFileSource):
+                exception: BaseException | None = source.exception
+            else:
+                exception = ffi.from_handle(source).exception
+            if exception is not None:
+                return exception
+        return None
+
     @classmethod
     def from_list(cls, files: list[dict]):
         """Create a multipart instance from a list of dict, for keys, see ``addpart``"""
@@ -868,13 +1946,15 @@ class CurlMime:
     def attach(self, curl: Curl | None = None) -> None:
         """Attach the mime instance to a curl instance."""
         c = curl if curl else self._curl
-        c.setopt(CurlOpt.MIMEPOST, self._form)
+        c.setopt(CurlOpt.MIMEPOST, self)
 
     def close(self) -> None:
         """Close the mime instance and underlying files. This method must be called
         after ``perform`` or ``request``."""
         lib.curl_mime_free(self._form)
         self._form = ffi.NULL
+        self._sources = []
+        self._async_readers = []
 
     def __del__(self) -> None:
         self.close()
@@ -1,6 +1,7 @@
 __all__ = [
     "Session",
     "AsyncSession",
+    "ShardedAsyncSession",
     "BrowserType",
     "BrowserTypeLiteral",
     "CurlWsFlag",
@@ -14,6 +15,7 @@ __all__ = [
     "options",
     "RequestsError",
     "Cookies",
+    "CurlCookies",
     "Headers",
     "Request",
     "Response",
@@ -26,8 +28,18 @@ __all__ = [
     "WsCloseCode",
     "ExtraFingerprints",
     "RetryStrategy",
+    "RateLimit",
+    "HedgeStrategy",
+    "AdaptiveTimeout",
+    "SessionMetrics",
+    "RequestMetrics",
+    "OriginMetrics",
+    "ConnectionStats",
     "CacheBackend",
+    "BinaryCacheBackend",
     "FileCacheBackend",
+    "MemoryCacheBackend",
+    "PersistentStore",
     "CookieTypes",
     "HeaderTypes",
     "ProxySpec",
@@ -36,11 +48,20 @@ __all__ = [
 from typing import Optional, TYPE_CHECKING, TypedDict
 
 from ..const import CurlWsFlag
-from .cache import CacheBackend, FileCacheBackend
-from .cookies import Cookies, CookieTypes
+from .cache import (
+    BinaryCacheBackend,
+    CacheBackend,
+    FileCacheBackend,
+    MemoryCacheBackend,
+)
+from .connections import ConnectionStats
+from .cookies import Cookies, CookieTypes, CurlCookies
 from .errors import RequestsError
 from .headers import Headers, HeaderTypes
 from .impersonate import BrowserType, BrowserTypeLiteral, ExtraFingerprints
+from .latency import AdaptiveTimeout, HedgeStrategy
+from .limits import RateLimit
+from .metrics import OriginMetrics, RequestMetrics, SessionMetrics
 from .models import Request, Response
 from .session import (
     AsyncSession,
@@ -52,6 +73,8 @@ from .session import (
     RequestParams,
     Unpack,
 )
+from .shards import ShardedAsyncSession
+from .store import PersistentStore
 from .websockets import (
     AsyncWebSocket,
     WebSocket,
@@ -91,6 +114,8 @@ def request(
             ``Content-Type: application/x-www-form-urlencoded`` will be added if a dict
             is given.
         content: raw request body as str, bytes, a byte iterable, or a binary file.
+            ``bytearray``, ``memoryview`` and ``mmap`` bodies are sent in place
+            without a copy, and regular files are read by libcurl directly.
             ``AsyncSession`` also accepts an async byte iterable.
         json: json values to use in body, `Content-Type: application/json` will be added
             automatically.
@@ -134,6 +159,13 @@ def request(
         cert: a tuple of (cert, key) filenames for client cert.
         stream: streaming the response, default False.
         max_recv_speed: maximum receive speed, bytes per second.
+        stream_buffer_size: in stream mode, buffer the body in a ring of this many
+            bytes instead of a queue, the transfer is paused while it is full. The
+            chunks are then memoryviews into the ring, released when the next chunk
+            is requested.
+        stream_to: write the body to this file descriptor or binary file from C,
+            starting at its current position. If that is not 0, the download is
+            resumed with a range request. ``content`` is left empty.
         multipart: upload files using the multipart format, see examples for details.
         discard_cookies: discard cookies from server. Default to False.
 
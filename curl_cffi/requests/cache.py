@@ -1,33 +1,68 @@
 from __future__ import annotations
 
+import asyncio
 import base64
 import hashlib
 import json
+import mmap
 import os
+import struct
+import sys
 import tempfile
+import threading
 import time
+import warnings
 from abc import ABC, abstractmethod
-from collections.abc import Sequence
+from collections.abc import Callable, Mapping, Sequence
+from concurrent.futures import ThreadPoolExecutor
 from contextlib import suppress
 from datetime import datetime, timedelta, timezone
-from http.cookies import SimpleCookie
+from email.utils import parsedate_to_datetime
+from functools import partial
 from pathlib import Path
-from typing import Any, Optional, Union
+from typing import IO, Any, NamedTuple, Optional, TypeVar, Union, cast
 from urllib.parse import parse_qsl, urlencode, urlsplit, urlunsplit
 
-from .cookies import Cookies
+from ..utils import CurlCffiWarning
 from .headers import Headers
-from .models import Request, Response
+from .models import Request, Response, cookies_from_headers
 
 __all__ = [
+    "BinaryCacheBackend",
     "CacheBackend",
     "CacheSpec",
+    "CacheLookup",
     "FileCacheBackend",
+    "MemoryCacheBackend",
     "normalize_cache_backend",
 ]
 
 
 CacheSpec = Union["CacheBackend", int, timedelta]
+T = TypeVar("T")
+
+if sys.platform == "win32":
+    import msvcrt
+
+    def _try_lock(f: IO[bytes]) -> bool:
+        """Lock the file without waiting, until it is closed."""
+        f.seek(0)
+        try:
+            msvcrt.locking(f.fileno(), msvcrt.LK_NBLCK, 1)
+        except OSError:
+            return False
+        return True
+
+else:
+    import fcntl
+
+    def _try_lock(f: IO[bytes]) -> bool:
+        """Lock the file without waiting, until it is closed."""
+        try:
+            fcntl.flock(f.fileno(), fcntl.LOCK_EX | fcntl.LOCK_NB)
+        except OSError:
+            return False
+        return True
 
 
 def _encode_bytes(value: bytes) -> str:
@@ -61,25 +96,81 @@ def _parse_har_timestamp(value: str) -> float:
     return datetime.fromisoformat(value.replace("Z", "+00:00")).timestamp()
 
 
-def _response_cookies(headers: Headers) -> Cookies:
-    cookies = Cookies()
-    for set_cookie in headers.get_list("set-cookie"):
-        if not set_cookie:
-            continue
-        try:
-            parsed = SimpleCookie()
-            parsed.load(set_cookie)
-            for name, morsel in parsed.items():
-                cookies.set(
-                    name,
-                    morsel.value,
-                    domain=morsel.get("domain", ""),
-                    path=morsel.get("path", "/"),
-                    secure=bool(morsel.get("secure")),
-                )
-        except Exception:
-            continue
-    return cookies
+def _response_extra(response: Response) -> dict[str, Any]:
+    default_encoding = response.default_encoding
+    if not isinstance(default_encoding, str):
+        default_encoding = "utf-8"
+    return {
+        "url": response.url,
+        "default_encoding": default_encoding,
+        "redirect_count": response.redirect_count,
+        "primary_ip": response.primary_ip,
+        "primary_port": response.primary_port,
+        "local_ip": response.local_ip,
+        "local_port": response.local_port,
+        "download_size": response.download_size,
+        "upload_size": response.upload_size,
+        "header_size": response.header_size,
+        "request_size": response.request_size,
+        "response_size": response.response_size,
+    }
+
+
+def _build_response(
+    request: Request,
+    response_class: type[Response],
+    *,
+    content: Union[bytes, memoryview],
+    status: int,
+    reason: str,
+    headers: Headers,
+    http_version: int,
+    redirect_url: str,
+    elapsed_ms: float,
+    extra: dict[str, Any],
+) -> Response:
+    try:
+        response = response_class(request=request)
+    except TypeError:
+        response = response_class()
+        response.request = request
+    response.url = extra.get("url", request.url)
+    response.content = content  # type: ignore[assignment]
+    response.status_code = status
+    response.reason = reason
+    response.ok = 200 <= response.status_code < 400
+    response.headers = headers
+    response.cookies = cookies_from_headers(response.headers)
+    response.default_encoding = extra.get("default_encoding", "utf-8")
+    response.elapsed = timedelta(milliseconds=elapsed_ms)
+    response.redirect_count = int(extra.get("redirect_count", 0))
+    response.redirect_url = redirect_url
+    response.http_version = http_version
+    response.primary_ip = extra.get("primary_ip", "")
+    response.primary_port = int(extra.get("primary_port", 0))
+    response.local_ip = extra.get("local_ip", "")
+    response.local_port = int(extra.get("local_port", 0))
+    response.download_size = int(extra.get("download_size", len(content)))
+    response.upload_size = int(extra.get("upload_size", 0))
+    response.header_size = int(extra.get("header_size", 0))
+    response.request_size = int(extra.get("request_size", 0))
+    response.response_size = int(
+        extra.get("response_size", response.download_size + response.header_size)
+    )
+    return response
+
+
+class CacheLookup(NamedTuple):
+    """Outcome of ``CacheBackend.lookup``."""
+
+    response: Optional[Response]
+    """Response to serve without a transfer, None on a miss."""
+    validators: Mapping[str, str] = {}
+    """Conditional headers, e.g. ``If-None-Match``, to revalidate a stale entry."""
+    refresh: bool = False
+    """The response is stale, revalidate it in the background."""
+    leader: bool = False
+    """The caller fetches the entry for everyone and must call ``finish``."""
 
 
 class CacheBackend(ABC):
@@ -97,6 +188,11 @@ class CacheBackend(ABC):
         self.expires_seconds = expires.total_seconds()
         self.methods = frozenset(method.upper() for method in (methods or ("GET",)))
         self.ignored = frozenset(ignored or ())
+        # the blocking I/O of the async methods runs here, one call at a time
+        self._io: Optional[ThreadPoolExecutor] = None
+        # writes queued by ``aset``, by key, oldest first
+        self._writes: dict[str, tuple[Request, Response]] = {}
+        self._writes_lock = threading.Lock()
 
     def should_cache_request(
         self,
@@ -126,14 +222,36 @@ class CacheBackend(ABC):
         if payload is None:
             return None
 
-        entry = payload["log"]["entries"][0]
-        created_at = _parse_har_timestamp(entry["startedDateTime"])
+        created_at = self._payload_created_at(payload)
         if self.expires_seconds and (time.time() - created_at) > self.expires_seconds:
             self.delete(request)
             return None
 
         return self._response_from_payload(request, payload, response_class)
 
+    def lookup(
+        self,
+        request: Request,
+        response_class: type[Response] = Response,
+    ) -> CacheLookup:
+        """Like ``get``, for the backends which also revalidate stale entries."""
+        return CacheLookup(self.get(request, response_class))
+
+    def revalidated(
+        self,
+        request: Request,
+        response: Response,
+        response_class: type[Response] = Response,
+    ) -> Optional[Response]:
+        """Refresh the entry of ``request`` with a 304 ``response``.
+
+        Returns the cached response to serve instead, or None if it is gone.
+        """
+        return None
+
+    def finish(self, request: Request) -> None:
+        """Called by the ``leader`` of a lookup once its transfer is done."""
+
     def set(self, request: Request, response: Response) -> None:
         if not self.should_store_response(response):
             return
@@ -144,6 +262,83 @@ class CacheBackend(ABC):
     def delete(self, request: Request) -> None:
         self._delete_payload(self._cache_key(request))
 
+    async def aget(
+        self,
+        request: Request,
+        response_class: type[Response] = Response,
+    ) -> Response | None:
+        """``get`` run in the I/O thread of the backend, for ``AsyncSession``."""
+        return await self._run_io(self.get, request, response_class)
+
+    async def alookup(
+        self,
+        request: Request,
+        response_class: type[Response] = Response,
+    ) -> CacheLookup:
+        """``lookup`` run in the I/O thread of the backend."""
+        return await self._run_io(self.lookup, request, response_class)
+
+    async def arevalidated(
+        self,
+        request: Request,
+        response: Response,
+        response_class: type[Response] = Response,
+    ) -> Optional[Response]:
+        """``revalidated`` run in the I/O thread of the backend."""
+        return await self._run_io(self.revalidated, request, response, response_class)
+
+    async def aset(self, request: Request, response: Response) -> None:
+        """Queue ``set`` for the I/O thread and return at once.
+
+        The writes queued while the thread is busy are done as one batch, a newer
+        response of the same request replacing the older one. The lookups run after
+        the writes queued before them.
+        """
+        if not self.should_store_response(response):
+            return
+        key = self._cache_key(request)
+        with self._writes_lock:
+            idle = not self._writes
+            self._writes[key] = (request, response)
+        if idle:
+            self._executor().submit(self._flush_writes)
+
+    async def aflush(self) -> None:
+        """Wait for the writes queued by ``aset``."""
+        await self._run_io(self._flush_writes)
+
+    def _executor(self) -> ThreadPoolExecutor:
+        if self._io is None:
+            self._io = ThreadPoolExecutor(1, thread_name_prefix="curl_cffi_cache")
+        return self._io
+
+    async def _run_io(self, func: Callable[..., T], *args: Any) -> T:
+        loop = asyncio.get_running_loop()
+        return await loop.run_in_executor(self._executor(), partial(func, *args))
+
+    def _flush_writes(self) -> None:
+        with self._writes_lock:
+            writes, self._writes = self._writes, {}
+        for request, response in writes.values():
+            # nobody awaits these writes, a failed one must not drop the others
+            try:
+                self.set(request, response)
+            except Exception as e:
+                warnings.warn(
+                    f"Failed to write the cache: {e!r}", CurlCffiWarning, stacklevel=1
+                )
+
+    def close(self) -> None:
+        """Do the writes queued by ``aset`` and stop the I/O thread."""
+        io, self._io = self._io, None
+        if io is not None:
+            io.shutdown(wait=True)
+        self._flush_writes()
+
+    def _payload_created_at(self, payload: Any) -> float:
+        entry = payload["log"]["entries"][0]
+        return _parse_har_timestamp(entry["startedDateTime"])
+
     def _cache_key(self, request: Request) -> str:
         normalized = self._normalized_url(request.url)
         body_hash = hashlib.sha256(request.body or b"").hexdigest()
@@ -171,11 +366,7 @@ class CacheBackend(ABC):
             )
         )
 
-    def _payload_from_response(self, response: Response) -> dict[str, Any]:
-        default_encoding = response.default_encoding
-        if not isinstance(default_encoding, str):
-            default_encoding = "utf-8"
-
+    def _payload_from_response(self, response: Response) -> Any:
         return {
             "log": {
                 "version": "1.2",
@@ -247,20 +438,7 @@ class CacheBackend(ABC):
                             "redirectURL": response.redirect_url,
                             "headersSize": response.header_size,
                             "bodySize": response.download_size,
-                            "_curl_cffi": {
-                                "url": response.url,
-                                "default_encoding": default_encoding,
-                                "redirect_count": response.redirect_count,
-                                "primary_ip": response.primary_ip,
-                                "primary_port": response.primary_port,
-                                "local_ip": response.local_ip,
-                                "local_port": response.local_port,
-                                "download_size": response.download_size,
-                                "upload_size": response.upload_size,
-                                "header_size": response.header_size,
-                                "request_size": response.request_size,
-                                "response_size": response.response_size,
-                            },
+                            "_curl_cffi": _response_extra(response),
                         },
                         "cache": {},
                         "timings": {
@@ -281,53 +459,36 @@ class CacheBackend(ABC):
     ) -> Response:
         entry = payload["log"]["entries"][0]
         har_response = entry["response"]
-        extra = har_response.get("_curl_cffi", {})
+        extra = dict(har_response.get("_curl_cffi", {}))
+        content = _decode_bytes(har_response["content"]["text"])
+        extra.setdefault(
+            "download_size", har_response["content"].get("size", len(content))
+        )
         header_items = [
             [item.get("name", ""), item.get("value", "")]
             for item in har_response["headers"]
         ]
-        headers = _deserialize_headers(header_items)
-        try:
-            response = response_class(request=request)
-        except TypeError:
-            response = response_class()
-            response.request = request
-        response.url = extra.get("url", request.url)
-        response.content = _decode_bytes(har_response["content"]["text"])
-        response.status_code = int(har_response["status"])
-        response.reason = har_response.get("statusText", "")
-        response.ok = 200 <= response.status_code < 400
-        response.headers = headers
-        response.cookies = _response_cookies(response.headers)
-        response.default_encoding = extra.get("default_encoding", "utf-8")
-        response.elapsed = timedelta(milliseconds=float(entry.get("time", 0.0)))
-        response.redirect_count = int(extra.get("redirect_count", 0))
-        response.redirect_url = har_response.get("redirectURL", "")
-        response.http_version = int(har_response.get("httpVersion", 0) or 0)
-        response.primary_ip = extra.get("primary_ip", "")
-        response.primary_port = int(extra.get("primary_port", 0))
-        response.local_ip = extra.get("local_ip", "")
-        response.local_port = int(extra.get("local_port", 0))
-        response.download_size = int(
-            extra.get(
-                "download_size",
-                har_response["content"].get("size", len(response.content)),
-            )
+        return _build_response(
+            request,
+            response_class,
+            content=content,
+            status=int(har_response["status"]),
+            reason=har_response.get("statusText", ""),
+            headers=_deserialize_headers(header_items),
+            http_version=int(har_response.get("httpVersion", 0) or 0),
+            redirect_url=har_response.get("redirectURL", ""),
+            elapsed_ms=float(entry.get("time", 0.0)),
+            extra=extra,
         )
-        response.upload_size = int(extra.get("upload_size", 0))
-        response.header_size = int(extra.get("header_size", 0))
-        response.request_size = int(extra.get("request_size", 0))
-        response.response_size = int(
-            extra.get("response_size", response.download_size + response.header_size)
-        )
-        return response
 
     @abstractmethod
-    def _read_payload(self, key: str) -> dict[str, Any] | None:
+    def _read_payload(self, key: str) -> Any:
+        """Payload stored for ``key``, a HAR dict unless ``_payload_from_response``
+        and ``_response_from_payload`` are overridden, or None on a miss."""
         raise NotImplementedError
 
     @abstractmethod
-    def _write_payload(self, key: str, payload: dict[str, Any]) -> None:
+    def _write_payload(self, key: str, payload: Any) -> None:
         raise NotImplementedError
 
     @abstractmethod
@@ -406,6 +567,757 @@ class FileCacheBackend(CacheBackend):
                 file_path.unlink()
 
 
+# record: magic, key, created at, flags, meta size, body size, then meta and body
+_RECORD = struct.Struct("<4s32sdBIQ")
+_RECORD_MAGIC = b"CCR1"
+_TOMBSTONE = 1
+# index: magic, size of the data file it covers, then one entry for each live record
+_INDEX_HEADER = struct.Struct("<4sQ")
+_INDEX_MAGIC = b"CCI1"
+_INDEX_ENTRY = struct.Struct("<32sQQd")
+# dead space below this is not worth a compaction
+_COMPACT_MIN = 1 << 20
+
+
+class _BinaryPayload(NamedTuple):
+    created_at: float
+    meta: dict[str, Any]
+    body: Union[bytes, memoryview]
+
+
+class BinaryCacheBackend(CacheBackend):
+    """Cache stored in an append-only data file read through ``mmap``, plus an index.
+
+    Bodies are stored raw and the other fields as compact JSON, so a hit neither
+    parses HAR nor decodes base64. With ``zero_copy``, the content of a hit is a
+    read-only memoryview into the mapped data file instead of a copy.
+
+    Overwritten, deleted and evicted entries leave dead space in the data file, which
+    is compacted when more than half of it is dead. With ``max_size``, the least
+    recently used entries are evicted to keep the live data under ``max_size`` bytes.
+
+    The index is saved by ``close`` and ``compact``, the entries written after the
+    last save are recovered by scanning the data file when opened.
+
+    The directory is locked until ``close``, it can only be used by one backend at
+    a time, a second one raises ``RuntimeError``.
+    """
+
+    def __init__(
+        self,
+        *,
+        expires: timedelta,
+        path: str | os.PathLike[str] | None = None,
+        methods: Sequence[str] | None = None,
+        ignored: Sequence[str] | None = None,
+        max_size: Optional[int] = None,
+        zero_copy: bool = False,
+    ) -> None:
+        super().__init__(expires=expires, methods=methods, ignored=ignored)
+        self.path = Path(path) if path is not None else self._default_path()
+        self.path.mkdir(parents=True, exist_ok=True)
+        # the offsets of the index only hold for the appends of this backend
+        self._lock_file = open(self.path / "lock", "a+b")  # noqa: SIM115
+        if not _try_lock(self._lock_file):
+            self._lock_file.close()
+            raise RuntimeError(f"The cache at {self.path} is used by another backend")
+        self.max_size = max_size
+        self.zero_copy = zero_copy
+        self._lock = threading.RLock()
+        # key -> (offset, size, created at), least recently used first
+        self._index: dict[bytes, tuple[int, int, float]] = {}
+        self._live = 0
+        self._map: Optional[mmap.mmap] = None
+        self._data = open(self._data_path, "a+b")  # noqa: SIM115
+        self._size = self._data.seek(0, os.SEEK_END)
+        self._load()
+
+    @staticmethod
+    def _default_path() -> Path:
+        return Path(tempfile.gettempdir()) / "curl_cffi_binary_cache"
+
+    @property
+    def _data_path(self) -> Path:
+        return self.path / "data.bin"
+
+    @property
+    def _index_path(self) -> Path:
+        return self.path / "index.bin"
+
+    def _load(self) -> None:
+        start = 0
+        try:
+            raw = self._index_path.read_bytes()
+        except FileNotFoundError:
+            raw = b""
+        header_size = _INDEX_HEADER.size
+        if len(raw) >= header_size:
+            magic, covered = _INDEX_HEADER.unpack_from(raw)
+            if (
+                magic == _INDEX_MAGIC
+                and covered <= self._size
+                and (len(raw) - header_size) % _INDEX_ENTRY.size == 0
+            ):
+                entries = _INDEX_ENTRY.iter_unpack(memoryview(raw)[header_size:])
+                for key, offset, size, created_at in entries:
+                    self._index[key] = (offset, size, created_at)
+                    self._live += size
+                start = covered
+        self._scan(start)
+
+    def _scan(self, start: int) -> None:
+        data = self._mapped()
+        pos = start
+        while data is not None and pos + _RECORD.size <= self._size:
+            magic, key, created_at, flags, meta_size, body_size = _RECORD.unpack_from(
+                data, pos
+            )
+            size = _RECORD.size + meta_size + body_size
+            if magic != _RECORD_MAGIC or pos + size > self._size:
+                break
+            self._forget(key)
+            if not flags & _TOMBSTONE:
+                self._index[key] = (pos, size, created_at)
+                self._live += size
+            pos += size
+        if pos < self._size:
+            # a torn write at the end
+            self._release_map()
+            self._data.truncate(pos)
+            self._size = pos
+
+    def _mapped(self) -> Optional[mmap.mmap]:
+        if self._size == 0:
+            return None
+        if self._map is None or len(self._map) < self._size:
+            self._data.flush()
+            self._release_map()
+            self._map = mmap.mmap(self._data.fileno(), 0, access=mmap.ACCESS_READ)
+        return self._map
+
+    def _release_map(self) -> None:
+        if self._map is not None:
+            # still used by zero copy responses, freed along with them
+            with suppress(BufferError):
+                self._map.close()
+            self._map = None
+
+    def _append(self, *chunks: Union[bytes, memoryview]) -> int:
+        offset = self._size
+        for chunk in chunks:
+            self._data.write(chunk)
+            self._size += len(chunk)
+        return offset
+
+    def _forget(self, key: bytes) -> bool:
+        entry = self._index.pop(key, None)
+        if entry is None:
+            return False
+        self._live -= entry[1]
+        return True
+
+    def _tombstone(self, key: bytes) -> None:
+        self._append(_RECORD.pack(_RECORD_MAGIC, key, time.time(), _TOMBSTONE, 0, 0))
+
+    def _payload_created_at(self, payload: _BinaryPayload) -> float:
+        return payload.created_at
+
+    def _payload_from_response(self, response: Response) -> _BinaryPayload:
+        meta = {
+            "status": response.status_code,
+            "reason": response.reason,
+            "http_version": response.http_version,
+            "headers": list(response.headers.multi_items()),
+            "redirect_url": response.redirect_url,
+            "time": response.elapsed.total_seconds() * 1000,
+            "extra": _response_extra(response),
+        }
+        return _BinaryPayload(time.time(), meta, response.content)
+
+    def _response_from_payload(
+        self,
+        request: Request,
+        payload: _BinaryPayload,
+        response_class: type[Response],
+    ) -> Response:
+        meta = payload.meta
+        return _build_response(
+            request,
+            response_class,
+            content=payload.body,
+            status=meta["status"],
+            reason=meta["reason"],
+            headers=_deserialize_headers(meta["headers"]),
+            http_version=meta["http_version"],
+            redirect_url=meta["redirect_url"],
+            elapsed_ms=meta["time"],
+            extra=meta["extra"],
+        )
+
+    def _read_payload(self, key: str) -> Optional[_BinaryPayload]:
+        raw_key = bytes.fromhex(key)
+        with self._lock:
+            entry = self._index.pop(raw_key, None)
+            if entry is None:
+                return None
+            self._index[raw_key] = entry  # most recently used last
+            offset, size, created_at = entry
+            data = self._mapped()
+            if data is None or offset + size > self._size:
+                self._forget(raw_key)
+                return None
+            magic, record_key, _, flags, meta_size, body_size = _RECORD.unpack_from(
+                data, offset
+            )
+            if (
+                magic != _RECORD_MAGIC
+                or record_key != raw_key
+                or flags & _TOMBSTONE
+                or _RECORD.size + meta_size + body_size != size
+            ):
+                # the data file changed under the index, e.g. written by another
+                # process, dropped rather than served as another entry
+                self._forget(raw_key)
+                return None
+            meta_start = offset + _RECORD.size
+            body_start = meta_start + meta_size
+            meta = json.loads(data[meta_start:body_start])
+            body_end = body_start + body_size
+            if self.zero_copy:
+                body: Union[bytes, memoryview] = memoryview(data)[body_start:body_end]
+            else:
+                body = data[body_start:body_end]
+        return _BinaryPayload(created_at, meta, body)
+
+    def _write_payload(self, key: str, payload: _BinaryPayload) -> None:
+        raw_key = bytes.fromhex(key)
+        meta = json.dumps(payload.meta, separators=(",", ":")).encode("utf-8")
+        header = _RECORD.pack(
+            _RECORD_MAGIC, raw_key, payload.created_at, 0, len(meta), len(payload.body)
+        )
+        with self._lock:
+            offset = self._append(header, meta, payload.body)
+            self._forget(raw_key)
+            size = self._size - offset
+            self._index[raw_key] = (offset, size, payload.created_at)
+            self._live += size
+            self._evict()
+            self._maybe_compact()
+
+    def _delete_payload(self, key: str) -> None:
+        raw_key = bytes.fromhex(key)
+        with self._lock:
+            if self._forget(raw_key):
+                self._tombstone(raw_key)
+                self._maybe_compact()
+
+    def _evict(self) -> None:
+        if self.max_size is None:
+            return
+        while self._live > self.max_size and self._index:
+            key = next(iter(self._index))
+            self._forget(key)
+            self._tombstone(key)
+
+    def _maybe_compact(self) -> None:
+        dead = self._size - self._live
+        if dead > _COMPACT_MIN and dead > self._live:
+            self.compact()
+
+    def compact(self) -> None:
+        """Rewrite the live entries into a new data file and save the index."""
+        with self._lock:
+            data = self._mapped()
+            index: dict[bytes, tuple[int, int, float]] = {}
+            tmp_path = self._data_path.with_suffix(".tmp")
+            pos = 0
+            with tmp_path.open("wb") as f:
+                for key, (offset, size, created_at) in self._index.items():
+                    f.write(memoryview(cast(mmap.mmap, data))[offset : offset + size])
+                    index[key] = (pos, size, created_at)
+                    pos += size
+            del data
+            self._release_map()
+            self._data.close()
+            os.replace(tmp_path, self._data_path)
+            self._data = open(self._data_path, "a+b")  # noqa: SIM115
+            self._size = self._live = pos
+            self._index = index
+            self._save_index()
+
+    def _save_index(self) -> None:
+        self._data.flush()
+        tmp_path = self._index_path.with_suffix(".tmp")
+        with tmp_path.open("wb") as f:
+            f.write(_INDEX_HEADER.pack(_INDEX_MAGIC, self._size))
+            for key, (offset, size, created_at) in self._index.items():
+                f.write(_INDEX_ENTRY.pack(key, offset, size, created_at))
+        os.replace(tmp_path, self._index_path)
+
+    def close(self) -> None:
+        """Save the index and close the data file."""
+        # outside of the lock, which the queued writes take
+        super().close()
+        with self._lock:
+            if self._data.closed:
+                return
+            self._save_index()
+            self._release_map()
+            self._data.close()
+            self._lock_file.close()
+
+    def clear(self) -> None:
+        with self._lock:
+            self._index.clear()
+            self._live = 0
+            self._release_map()
+            self._data.close()
+            # a new file, zero copy responses may still map the old one
+            tmp_path = self._data_path.with_suffix(".tmp")
+            tmp_path.write_bytes(b"")
+            os.replace(tmp_path, self._data_path)
+            self._data = open(self._data_path, "a+b")  # noqa: SIM115
+            self._size = 0
+            self._save_index()
+
+
+# statuses cacheable by default, RFC 9110 section 15.1
+_CACHEABLE_STATUS = frozenset((200, 203, 204, 300, 301, 308, 404, 405, 410, 414, 501))
+# headers of a 304 which must not replace the stored ones
+_NOT_REVALIDATED = frozenset(
+    ("content-length", "content-encoding", "transfer-encoding")
+)
+# rough cost of an entry besides its body and headers
+_ENTRY_OVERHEAD = 512
+# how long a collapsed miss waits for its leader before fetching on its own
+_LEADER_WAIT = 60.0
+
+
+def _cache_control(value: Optional[str]) -> dict[str, Optional[str]]:
+    directives: dict[str, Optional[str]] = {}
+    for item in (value or "").split(","):
+        name, sep, arg = item.strip().partition("=")
+        if name:
+            directives[name.lower()] = arg.strip('"') if sep else None
+    return directives
+
+
+def _seconds(value: Optional[str]) -> Optional[int]:
+    try:
+        return max(0, int(value)) if value is not None else None
+    except ValueError:
+        return None
+
+
+def _http_date(value: Optional[str]) -> Optional[float]:
+    if not value:
+        return None
+    try:
+        return parsedate_to_datetime(value).timestamp()
+    except (TypeError, ValueError):
+        return None
+
+
+class _MemoryEntry(NamedTuple):
+    created_at: float
+    fresh_until: float
+    stale_until: float
+    """Served while revalidated in the background until then."""
+    status: int
+    reason: str
+    headers: tuple[tuple[str, Optional[str]], ...]
+    content: bytes
+    http_version: int
+    redirect_url: str
+    elapsed_ms: float
+    extra: dict[str, Any]
+    vary: tuple[tuple[str, Optional[str]], ...]
+    """Request headers named by ``Vary`` and their values."""
+    size: int
+
+
+def _wake(future: asyncio.Future[None]) -> None:
+    if not future.done():
+        future.set_result(None)
+
+
+class _Pending:
+    """Set once the leader of a collapsed miss is done, for threads and tasks."""
+
+    __slots__ = ("event", "lock", "futures")
+
+    def __init__(self) -> None:
+        self.event = threading.Event()
+        self.lock = threading.Lock()
+        self.futures: list[tuple[asyncio.AbstractEventLoop, asyncio.Future[None]]] = []
+
+    async def wait_async(self) -> None:
+        loop = asyncio.get_running_loop()
+        future = loop.create_future()
+        with self.lock:
+            if self.event.is_set():
+                return
+            self.futures.append((loop, future))
+        await future
+
+    def set(self) -> None:
+        with self.lock:
+            self.event.set()
+            futures, self.futures = self.futures, []
+        for loop, future in futures:
+            loop.call_soon_threadsafe(_wake, future)
+
+
+class MemoryCacheBackend(CacheBackend):
+    """In-process cache following the ``Cache-Control`` of the responses.
+
+    Entries are immutable payloads, a hit builds a new response from one. The least
+    recently used entries are evicted to keep the bodies and headers under
+    ``max_size`` bytes.
+
+    The responses are fresh for their ``max-age`` or until their ``Expires``, else
+    for ``expires`` if it is not zero. Without any of them, a response is stored
+    stale, to be revalidated, and only if it has a validator. ``no-store`` responses
+    are not stored, ``no-cache`` ones are always revalidated.
+
+    A stale entry with an ``ETag`` or a ``Last-Modified`` is revalidated with
+    ``If-None-Match`` or ``If-Modified-Since``, and kept if the server answers 304.
+    Within its ``stale-while-revalidate`` window, the stale response is served while
+    it is revalidated in the background.
+
+    Concurrent misses for the same entry are collapsed, the first request fetches it
+    and the others wait for its response.
+    """
+
+    def __init__(
+        self,
+        *,
+        expires: timedelta = timedelta(0),
+        methods: Sequence[str] | None = None,
+        ignored: Sequence[str] | None = None,
+        max_size: int = 64 << 20,
+    ) -> None:
+        super().__init__(expires=expires, methods=methods, ignored=ignored)
+        if max_size < 1:
+            raise ValueError("max_size must be at least 1")
+        self.max_size = max_size
+        self._lock = threading.Lock()
+        # least recently used first
+        self._entries: dict[str, _MemoryEntry] = {}
+        self._size = 0
+        # keys being fetched by a leader, set when it is done
+        self._pending: dict[str, _Pending] = {}
+
+    @property
+    def size(self) -> int:
+        """Bytes taken by the entries."""
+        return self._size
+
+    def should_cache_request(
+        self,
+        request: Request,
+        *,
+        stream: bool = False,
+        content_callback: Any = None,
+    ) -> bool:
+        # conditional and range requests are answered by the server
+        headers = request.headers
+        return (
+            super().should_cache_request(
+                request, stream=stream, content_callback=content_callback
+            )
+            and "no-store" not in _cache_control(headers.get("cache-control"))
+            and not any(
+                name in headers
+                for name in ("if-none-match", "if-modified-since", "range")
+            )
+        )
+
+    def should_store_response(self, response: Response) -> bool:
+        headers = response.headers
+        directives = _cache_control(headers.get("cache-control"))
+        if (
+            response.status_code not in _CACHEABLE_STATUS
+            or "no-store" in directives
+            or headers.get("vary", "").strip() == "*"
+        ):
+            return False
+        # useless if it can neither be served nor revalidated
+        now = time.time()
+        return (
+            "etag" in headers
+            or "last-modified" in headers
+            or self._lifetime(headers, now)[1] > now
+        )
+
+    def get(
+        self,
+        request: Request,
+        response_class: type[Response] = Response,
+    ) -> Response | None:
+        key = self._cache_key(request)
+        with self._lock:
+            entry = self._entry(key, request)
+            if entry is None or time.time() >= entry.fresh_until:
+                return None
+        return self._response_from_payload(request, entry, response_class)
+
+    def lookup(
+        self,
+        request: Request,
+        response_class: type[Response] = Response,
+    ) -> CacheLookup:
+        waited = False
+        while True:
+            result = self._lookup(request, response_class, waited)
+            if isinstance(result, CacheLookup):
+                return result
+            # another request is fetching the entry, wait for it and look again
+            result.event.wait(_LEADER_WAIT)
+            waited = True
+
+    def _lookup(
+        self,
+        request: Request,
+        response_class: type[Response],
+        waited: bool,
+    ) -> Union[CacheLookup, _Pending]:
+        key = self._cache_key(request)
+        directives = _cache_control(request.headers.get("cache-control"))
+        no_cache = "no-cache" in directives or directives.get("max-age") == "0"
+        with self._lock:
+            entry = self._entry(key, request)
+            now = time.time()
+            if entry is not None and not no_cache and now < entry.stale_until:
+                response = self._response_from_payload(request, entry, response_class)
+                if now < entry.fresh_until or key in self._pending:
+                    return CacheLookup(response)
+                self._pending[key] = _Pending()
+                return CacheLookup(
+                    response, self._validators(entry), refresh=True, leader=True
+                )
+            if entry is not None and not self._validators(entry):
+                self._drop(key)
+                entry = None
+            validators = self._validators(entry) if entry is not None else {}
+            pending = self._pending.get(key)
+            if pending is None:
+                self._pending[key] = _Pending()
+                return CacheLookup(None, validators, leader=True)
+            if waited or no_cache:
+                return CacheLookup(None, validators)
+            return pending
+
+    def revalidated(
+        self,
+        request: Request,
+        response: Response,
+        response_class: type[Response] = Response,
+    ) -> Optional[Response]:
+        key = self._cache_key(request)
+        with self._lock:
+            entry = self._entry(key, request)
+            if entry is None:
+                return None
+            updated = {
+                name.lower()
+                for name in response.headers
+                if name.lower() not in _NOT_REVALIDATED
+            }
+            items = [
+                (name, value)
+                for name, value in entry.headers
+                if name.lower() not in updated
+            ]
+            items += [
+                (name, value)
+                for name, value in response.headers.multi_items()
+                if name.lower() in updated
+            ]
+            headers = Headers(items)
+            now = time.time()
+            fresh_until, stale_until = self._lifetime(headers, now)
+            entry = entry._replace(
+                created_at=now,
+                fresh_until=fresh_until,
+                stale_until=stale_until,
+                headers=tuple(items),
+            )
+            self._entries[key] = entry
+        return self._response_from_payload(request, entry, response_class)
+
+    def finish(self, request: Request) -> None:
+        with self._lock:
+            pending = self._pending.pop(self._cache_key(request), None)
+        if pending is not None:
+            pending.set()
+
+    # nothing to offload, and waiting in the I/O thread would hold back the others
+
+    async def aget(
+        self,
+        request: Request,
+        response_class: type[Response] = Response,
+    ) -> Response | None:
+        return self.get(request, response_class)
+
+    async def alookup(
+        self,
+        request: Request,
+        response_class: type[Response] = Response,
+    ) -> CacheLookup:
+        waited = False
+        while True:
+            result = self._lookup(request, response_class, waited)
+            if isinstance(result, CacheLookup):
+                return result
+            with suppress(asyncio.TimeoutError):
+                await asyncio.wait_for(result.wait_async(), _LEADER_WAIT)
+            waited = True
+
+    async def arevalidated(
+        self,
+        request: Request,
+        response: Response,
+        response_class: type[Response] = Response,
+    ) -> Optional[Response]:
+        return self.revalidated(request, response, response_class)
+
+    async def aset(self, request: Request, response: Response) -> None:
+        self.set(request, response)
+
+    def set(self, request: Request, response: Response) -> None:
+        if not self.should_store_response(response):
+            return
+        vary = tuple(
+            (name, request.headers.get(name))
+            for name in (
+                item.strip().lower()
+                for item in response.headers.get("vary", "").split(",")
+            )
+            if name
+        )
+        entry = self._payload_from_response(response)._replace(vary=vary)
+        self._write_payload(self._cache_key(request), entry)
+
+    def _entry(self, key: str, request: Request) -> Optional[_MemoryEntry]:
+        entry = self._entries.pop(key, None)
+        if entry is None:
+            return None
+        self._entries[key] = entry  # most recently used last
+        for name, value in entry.vary:
+            if request.headers.get(name) != value:
+                return None
+        return entry
+
+    def _lifetime(self, headers: Headers, now: float) -> tuple[float, float]:
+        directives = _cache_control(headers.get("cache-control"))
+        max_age = _seconds(directives.get("max-age"))
+        expires = _http_date(headers.get("expires"))
+        if "no-cache" in directives:
+            lifetime = 0.0
+        elif max_age is not None:
+            lifetime = max_age - (_seconds(headers.get("age")) or 0)
+        elif expires is not None:
+            lifetime = expires - (_http_date(headers.get("date")) or now)
+        else:
+            # no implicit freshness, revalidated right away when not given
+            lifetime = self.expires_seconds
+        fresh_until = now + max(0.0, lifetime)
+        stale = _seconds(directives.get("stale-while-revalidate")) or 0
+        if "must-revalidate" in directives or "no-cache" in directives:
+            stale = 0
+        return fresh_until, fresh_until + stale
+
+    @staticmethod
+    def _validators(entry: _MemoryEntry) -> dict[str, str]:
+        validators = {}
+        for name, value in entry.headers:
+            if not value:
+                continue
+            if name.lower() == "etag":
+                validators["If-None-Match"] = value
+            elif name.lower() == "last-modified":
+                validators["If-Modified-Since"] = value
+        return validators
+
+    def _payload_created_at(self, payload: _MemoryEntry) -> float:
+        return payload.created_at
+
+    def _payload_from_response(self, response: Response) -> _MemoryEntry:
+        now = time.time()
+        fresh_until, stale_until = self._lifetime(response.headers, now)
+        headers = tuple(response.headers.multi_items())
+        content = bytes(response.content)
+        size = (
+            _ENTRY_OVERHEAD
+            + len(content)
+            + sum(len(name) + len(value or "") for name, value in headers)
+        )
+        return _MemoryEntry(
+            created_at=now,
+            fresh_until=fresh_until,
+            stale_until=stale_until,
+            status=response.status_code,
+            reason=response.reason,
+            headers=headers,
+            content=content,
+            http_version=response.http_version,
+            redirect_url=response.redirect_url,
+            elapsed_ms=response.elapsed.total_seconds() * 1000,
+            extra=_response_extra(response),
+            vary=(),
+            size=size,
+        )
+
+    def _response_from_payload(
+        self,
+        request: Request,
+        payload: _MemoryEntry,
+        response_class: type[Response],
+    ) -> Response:
+        return _build_response(
+            request,
+            response_class,
+            content=payload.content,
+            status=payload.status,
+            reason=payload.reason,
+            headers=Headers(list(payload.headers)),
+            http_version=payload.http_version,
+            redirect_url=payload.redirect_url,
+            elapsed_ms=payload.elapsed_ms,
+            extra=payload.extra,
+        )
+
+    def _read_payload(self, key: str) -> Optional[_MemoryEntry]:
+        with self._lock:
+            return self._entries.get(key)
+
+    def _write_payload(self, key: str, payload: _MemoryEntry) -> None:
+        with self._lock:
+            self._drop(key)
+            if payload.size > self.max_size:
+                return
+            self._entries[key] = payload
+            self._size += payload.size
+            while self._size > self.max_size:
+                self._drop(next(iter(self._entries)))
+
+    def _delete_payload(self, key: str) -> None:
+        with self._lock:
+            self._drop(key)
+
+    def _drop(self, key: str) -> None:
+        entry = self._entries.pop(key, None)
+        if entry is not None:
+            self._size -= entry.size
+
+    def clear(self) -> None:
+        with self._lock:
+            self._entries.clear()
+            self._size = 0
+
+
 def normalize_cache_backend(cache: CacheSpec | None) -> CacheBackend | None:
     if cache is None:
         return None
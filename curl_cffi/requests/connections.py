@@ -0,0 +1,109 @@
+from __future__ import annotations
+
+import time
+from dataclasses import dataclass
+from typing import Optional, Union
+
+from ..const import CurlHttpVersion, CurlInfo
+from ..curl import Curl
+from ..utils import HttpVersionLiteral
+from .metrics import origin_of
+from .utils import normalize_http_version
+
+__all__ = ["ConnectionStats", "ConnectionTracker"]
+
+# fetched from every handle going back to the pool, in a single call
+CONNECTION_INFOS = (CurlInfo.CONN_ID, CurlInfo.HTTP_VERSION, CurlInfo.EFFECTIVE_URL)
+
+_HTTP1 = (CurlHttpVersion.V1_0, CurlHttpVersion.V1_1)
+
+
+@dataclass
+class ConnectionStats:
+    """The streams of one connection of an ``AsyncSession``."""
+
+    conn_id: int
+    """Connection id of libcurl, unique within the session."""
+    origin: str
+    http_version: int
+    """``CurlHttpVersion`` of the last response, ``NONE`` before the first one."""
+    active_streams: int
+    """Transfers running on the connection right now."""
+    total_streams: int
+    """Transfers completed on the connection."""
+    last_used: float
+    """``time.monotonic()`` of the last completed transfer."""
+
+    @property
+    def multiplexed(self) -> bool:
+        return self.http_version not in (CurlHttpVersion.NONE, *_HTTP1)
+
+
+class ConnectionTracker:
+    """Learns which origins multiplex, and counts the streams of each connection.
+
+    Requests to an origin that is not known to be HTTP/1.x wait for a connection
+    that may multiplex, with ``CURLOPT_PIPEWAIT``, instead of opening one connection
+    each. A burst of requests to a new HTTP/2 origin then opens a single connection.
+    Once an origin answered in HTTP/1.x, its requests open parallel connections
+    right away again.
+
+    libcurl does not tell when a connection is closed, the least recently used ones
+    are forgotten beyond ``max_connections``.
+    """
+
+    def __init__(self, max_connections: int = 256) -> None:
+        self.max_connections = max_connections
+        # origin: whether its last response was multiplexed
+        self._origins: dict[str, bool] = {}
+        # conn_id: stats, least recently used first
+        self._connections: dict[int, ConnectionStats] = {}
+
+    def pipewait(
+        self,
+        url: str,
+        http_version: Optional[Union[CurlHttpVersion, HttpVersionLiteral]] = None,
+    ) -> bool:
+        """Whether a request should wait for a connection that may multiplex."""
+        if http_version and normalize_http_version(http_version) in _HTTP1:
+            return False
+        return self._origins.get(origin_of(url), True)
+
+    def record(self, curl: Curl) -> None:
+        """Record the transfer a handle just completed, if it got a connection."""
+        conn_id, http_version, url = curl.getinfo_many(CONNECTION_INFOS)
+        if not isinstance(conn_id, int) or conn_id < 0 or not http_version:
+            return
+        origin = origin_of(url.decode() if isinstance(url, bytes) else str(url))
+        self._origins[origin] = http_version not in _HTTP1
+        stats = self._connections.pop(conn_id, None)
+        if stats is None:
+            stats = ConnectionStats(conn_id, origin, 0, 0, 0, 0.0)
+            if len(self._connections) >= self.max_connections:
+                del self._connections[next(iter(self._connections))]
+        stats.http_version = int(http_version)
+        stats.total_streams += 1
+        stats.last_used = time.monotonic()
+        self._connections[conn_id] = stats
+
+    def snapshot(self, running: list[Curl]) -> list[ConnectionStats]:
+        """Stats of the known connections and of those the ``running`` handles use,
+        the busy ones first, then the most recently used."""
+        stats = {
+            conn_id: ConnectionStats(**vars(s))
+            for conn_id, s in self._connections.items()
+        }
+        for curl in running:
+            conn_id, _, url = curl.getinfo_many(CONNECTION_INFOS)
+            if not isinstance(conn_id, int) or conn_id < 0:
+                continue  # still waiting for a connection
+            s = stats.get(conn_id)
+            if s is None:
+                origin = origin_of(url.decode() if isinstance(url, bytes) else str(url))
+                s = stats[conn_id] = ConnectionStats(conn_id, origin, 0, 0, 0, 0.0)
+            s.active_streams += 1
+        return sorted(
+            stats.values(),
+            key=lambda s: (s.active_streams > 0, s.last_used),
+            reverse=True,
+        )
@@ -2,7 +2,7 @@
 # which is licensed under the BSD License.
 # See https://github.com/encode/httpx/blob/master/LICENSE.md
 
-__all__ = ["Cookies"]
+__all__ = ["Cookies", "CurlCookies"]
 
 import re
 import threading
@@ -12,13 +12,17 @@ from contextlib import suppress
 from dataclasses import dataclass
 from http.cookiejar import Cookie, CookieJar
 from http.cookies import _unquote
-from typing import Optional, Union
+from typing import TYPE_CHECKING, Optional, Union
 from collections.abc import Iterator, MutableMapping
 from urllib.parse import urlparse
 
+from ..const import CurlOpt
 from ..utils import CurlCffiWarning
 from .errors import CookieConflict, RequestsError
 
+if TYPE_CHECKING:
+    from ..curl import Curl
+
 CookieTypes = Union["Cookies", CookieJar, dict[str, str], list[tuple[str, str]]]
 
 
@@ -407,3 +411,176 @@ class Cookies(MutableMapping[str, str]):
         )
 
         return f"<Cookies[{cookies_repr}]>"
+
+
+def _domain_match(host: str, domain: str) -> bool:
+    domain = domain.lstrip(".").lower()
+    return not domain or host == domain or host.endswith(f".{domain}")
+
+
+class CurlCookies(Cookies):
+    """Cookies of a session with ``cookie_engine=True``, kept by the cookie engine of
+    libcurl, which the curl handles of the session share through a ``CurlShare``.
+
+    Requests don't load the jar into curl and responses don't parse their cookies
+    back, so the cost does not grow with the jar. Changes made through this mapping
+    are pushed to curl before the next request, while the changes made by responses
+    are applied here only when the cookies are read.
+
+    Cookies without a domain are sent to every host, in a ``Cookie`` header, as the
+    jar of the session would. Changes made directly to ``jar`` are not pushed.
+    """
+
+    def __init__(
+        self, cookies: Optional[CookieTypes] = None, clear_engine: bool = True
+    ) -> None:
+        """
+        Parameters:
+            cookies: cookies to add to the engine.
+            clear_engine: start from an empty engine, False when the engine belongs
+                to a ``CurlShare`` given by the user, whose cookies are kept.
+        """
+        self._lock = threading.Lock()
+        self._pulls: list[bytes] = []
+        self._pushes: list[str] = []
+        self._header: Optional[str] = None
+        super().__init__(cookies)
+        self._pushes = ["ALL"] if clear_engine else []
+        self._pushes.extend(
+            self._curl_line(cookie) for cookie in self._jar if cookie.domain
+        )
+
+    @property
+    def jar(self) -> CookieJar:  # type: ignore
+        if self._pulls:
+            with self._lock:
+                changes, self._pulls = self._pulls, []
+            super().update_cookies_from_curl_changes(changes)
+        return self._jar
+
+    @jar.setter
+    def jar(self, jar: CookieJar) -> None:
+        self._jar = jar
+
+    def __reduce__(self):
+        # a copy is not attached to any curl handle
+        return Cookies, (), Cookies(self).__getstate__()
+
+    @staticmethod
+    def _curl_line(cookie: Cookie, expired: bool = False) -> str:
+        morsel = CurlMorsel.from_cookiejar_cookie(cookie)
+        if expired:
+            # curl replaces the cookie, then drops it as expired
+            morsel.expires = 1
+        return morsel.to_curl_format()
+
+    def _push(self, cookies: list[Cookie], expired: bool = False) -> None:
+        with self._lock:
+            for cookie in cookies:
+                if cookie.domain:
+                    self._pushes.append(self._curl_line(cookie, expired))
+                else:
+                    self._header = None
+
+    def update_cookies_from_curl_changes(self, changes: list[bytes]) -> None:
+        with self._lock:
+            self._pulls.extend(changes)
+
+    def revert_curl_changes(self, curl: "Curl", changes: list[bytes]) -> None:
+        """Undo the changes of a response whose cookies are discarded, the engine
+        has stored them anyway."""
+        for change in changes:
+            _, _, curl_format = change.partition(b"\t")
+            morsel = CurlMorsel.from_curl_format(curl_format)
+            domains = {morsel.hostname, morsel.hostname.lstrip(".")}
+            domains.add(f".{morsel.hostname.lstrip('.')}")
+            previous = [
+                cookie
+                for cookie in self.jar
+                if cookie.name == morsel.name
+                and cookie.path == morsel.path
+                and cookie.domain in domains
+            ]
+            if previous:
+                line = self._curl_line(previous[0])
+            else:
+                morsel.expires = 1
+                line = morsel.to_curl_format()
+            curl.setopt(CurlOpt.COOKIELIST, line)
+
+    def sync_to_curl(
+        self, curl: "Curl", host: str, cookies: Optional[CookieTypes] = None
+    ) -> None:
+        """Push the pending changes to the engine shared by ``curl``, and set the
+        ``Cookie`` header for the cookies without a domain and the ``cookies`` of the
+        request."""
+        with self._lock:
+            pushes, self._pushes = self._pushes, []
+        for line in pushes:
+            curl.setopt(CurlOpt.COOKIELIST, line)
+
+        if self._header is None:
+            self._header = "; ".join(
+                f"{cookie.name}={cookie.value}"
+                for cookie in self.jar
+                if not cookie.domain
+            )
+        header = self._header
+        if cookies:
+            extra = "; ".join(
+                f"{cookie.name}={cookie.value}"
+                for cookie in Cookies(cookies).jar
+                if _domain_match(host.lower(), cookie.domain)
+            )
+            header = f"{header}; {extra}" if header and extra else header or extra
+        if header:
+            curl.setopt(CurlOpt.COOKIE, header)
+
+    def set(
+        self, name: str, value: str, domain: str = "", path: str = "/", secure=False
+    ) -> None:
+        super().set(name, value, domain, path, secure)
+        if name.startswith("__Host-"):
+            domain, path = "", "/"
+        if domain:
+            with suppress(KeyError):
+                self._push([self._jar._cookies[domain][path][name]])  # type: ignore
+        else:
+            self._header = None
+
+    def delete(
+        self,
+        name: str,
+        domain: Optional[str] = None,
+        path: Optional[str] = None,
+    ) -> None:
+        removed = [
+            cookie
+            for cookie in self.jar
+            if cookie.name == name
+            and (domain is None or cookie.domain == domain)
+            and (path is None or cookie.path == path)
+        ]
+        super().delete(name, domain, path)
+        self._push(removed, expired=True)
+
+    def clear(self, domain: Optional[str] = None, path: Optional[str] = None) -> None:
+        if domain is None:
+            super().clear()
+            with self._lock:
+                self._pushes.append("ALL")
+                self._header = None
+            return
+        removed = [
+            cookie
+            for cookie in self.jar
+            if cookie.domain == domain and (path is None or cookie.path == path)
+        ]
+        super().clear(domain, path)
+        self._push(removed, expired=True)
+
+    def update(self, cookies: Optional[CookieTypes] = None) -> None:  # type: ignore
+        cookies = Cookies(cookies)
+        for cookie in cookies.jar:
+            self.jar.set_cookie(cookie)
+        self._push(list(cookies.jar))
@@ -122,6 +122,37 @@ class Headers(MutableMapping[str, Optional[str]]):
 
         self._encoding = encoding
 
+    @classmethod
+    def from_raw_pairs(
+        cls, pairs: Iterable[tuple[bytes, bytes]], encoding: Optional[str] = None
+    ) -> "Headers":
+        """
+        Build headers from already split ``(name, value)`` byte pairs, e.g. the ones
+        collected by libcurl, without going through normalization again.
+
+        The pairs are kept as they are, the lowercased keys are only computed when
+        the headers are first used.
+        """
+        headers = cls.__new__(cls)
+        headers._pairs = pairs
+        headers._encoding = encoding
+        return headers
+
+    def __getattr__(self, name: str) -> Any:
+        # only called for the attributes built on first use
+        if name == "_list":
+            pairs = self.__dict__.pop("_pairs", ())
+            self._list = [(key, key.lower(), value) for key, value in pairs]
+            return self._list
+        if name == "_index":
+            # lowercased key -> values, for lookups without scanning the list
+            index: dict[bytes, list[Optional[bytes]]] = {}
+            for _, key, value in self._list:
+                index.setdefault(key, []).append(value)
+            self._index = index
+            return index
+        raise AttributeError(name)
+
     @property
     def encoding(self) -> str:
         """
@@ -156,6 +187,8 @@ class Headers(MutableMapping[str, Optional[str]]):
         """
         Returns a list of the raw header items, as byte pairs.
         """
+        if "_pairs" in self.__dict__:
+            return list(self._pairs)
         return [(raw_key, value) for raw_key, _, value in self._list]
 
     def keys(self) -> KeysView[str]:
@@ -221,8 +254,7 @@ class Headers(MutableMapping[str, Optional[str]]):
 
         values = [
             item_value.decode(self.encoding) if item_value is not None else item_value
-            for _, item_key, item_value in self._list
-            if item_key.lower() == get_header_key
+            for item_value in self._index.get(get_header_key, ())
         ]
 
         if not split_commas:
@@ -239,6 +271,7 @@ class Headers(MutableMapping[str, Optional[str]]):
             if key in self:
                 self.pop(key)
         self._list.extend(headers._list)
+        self.__dict__.pop("_index", None)
 
     def copy(self) -> "Headers":
         return Headers(self, encoding=self.encoding)
@@ -257,8 +290,7 @@ class Headers(MutableMapping[str, Optional[str]]):
                 if header_value is not None
                 else header_value
             )
-            for _, header_key, header_value in self._list
-            if header_key == normalized_key
+            for header_value in self._index.get(normalized_key, ())
         ]
 
         if items == [None]:
@@ -294,6 +326,7 @@ class Headers(MutableMapping[str, Optional[str]]):
             self._list[idx] = (set_key, lookup_key, set_value)
         else:
             self._list.append((set_key, lookup_key, set_value))
+        self.__dict__.pop("_index", None)
 
     def __delitem__(self, key: str) -> None:
         """
@@ -312,10 +345,11 @@ class Headers(MutableMapping[str, Optional[str]]):
 
         for idx in reversed(pop_indexes):
             del self._list[idx]
+        self.__dict__.pop("_index", None)
 
     def __contains__(self, key: Any) -> bool:
         header_key = key.lower().encode(self.encoding)
-        return header_key in [key for _, key, _ in self._list]
+        return header_key in self._index
 
     def __iter__(self) -> Iterator[Any]:
         return iter(self.keys())
@@ -0,0 +1,151 @@
+from __future__ import annotations
+
+import math
+from dataclasses import dataclass
+from typing import Optional
+
+# log-scale buckets, four per doubling from 1ms, the last one is open ended
+_BASE = 0.001
+_STEPS_PER_DOUBLING = 4
+_BUCKETS = 72  # up to ~220s
+
+
+def _bucket(seconds: float) -> int:
+    if seconds <= _BASE:
+        return 0
+    index = math.ceil(math.log2(seconds / _BASE) * _STEPS_PER_DOUBLING)
+    return min(index, _BUCKETS - 1)
+
+
+def _upper_bound(index: int) -> float:
+    return _BASE * 2 ** (index / _STEPS_PER_DOUBLING)
+
+
+class LatencyHistogram:
+    """Latencies of one host in log-scale buckets, about 19% wide.
+
+    After ``window`` samples, all the counts are halved, so that the percentiles
+    follow the recent latencies of long-running sessions. With a ``window`` of None,
+    the counts keep growing.
+    """
+
+    __slots__ = ("counts", "total", "sum", "window")
+
+    def __init__(self, window: Optional[int] = 1000) -> None:
+        self.counts = [0.0] * _BUCKETS
+        self.total = 0.0
+        self.sum = 0.0
+        self.window = window
+
+    def observe(self, seconds: float) -> None:
+        self.counts[_bucket(seconds)] += 1
+        self.total += 1
+        self.sum += seconds
+        if self.window is not None and self.total >= self.window:
+            self.counts = [count / 2 for count in self.counts]
+            self.total /= 2
+            self.sum /= 2
+
+    def copy(self) -> LatencyHistogram:
+        histogram = LatencyHistogram(self.window)
+        histogram.counts = list(self.counts)
+        histogram.total = self.total
+        histogram.sum = self.sum
+        return histogram
+
+    def cumulative(self, step: int = _STEPS_PER_DOUBLING) -> list[tuple[float, float]]:
+        """``(upper bound, count of latencies up to it)`` of every ``step`` buckets,
+        i.e. of each doubling by default, the last bound is infinite."""
+        bounds: list[tuple[float, float]] = []
+        seen = 0.0
+        for index, count in enumerate(self.counts[:-1]):
+            seen += count
+            if index % step == 0:
+                bounds.append((_upper_bound(index), seen))
+        bounds.append((math.inf, self.total))
+        return bounds
+
+    def percentile(self, p: float) -> float:
+        """Upper bound of the bucket holding the ``p`` percentile, 0 < p <= 1."""
+        if not self.total:
+            return 0.0
+        rank = p * self.total
+        seen = 0.0
+        for index, count in enumerate(self.counts):
+            seen += count
+            if seen >= rank:
+                return _upper_bound(index)
+        return _upper_bound(_BUCKETS - 1)
+
+
+class LatencyTracker:
+    """Latency histograms of the hosts of a session."""
+
+    def __init__(self, window: int = 1000) -> None:
+        self.window = window
+        self._hosts: dict[str, LatencyHistogram] = {}
+
+    def observe(self, host: str, seconds: float) -> None:
+        histogram = self._hosts.get(host)
+        if histogram is None:
+            histogram = self._hosts[host] = LatencyHistogram(self.window)
+        histogram.observe(seconds)
+
+    def samples(self, host: str) -> float:
+        histogram = self._hosts.get(host)
+        return histogram.total if histogram is not None else 0.0
+
+    def percentile(self, host: str, p: float) -> Optional[float]:
+        """Latency of ``host`` at percentile ``p``, None if never observed."""
+        histogram = self._hosts.get(host)
+        if histogram is None or not histogram.total:
+            return None
+        return histogram.percentile(p)
+
+
+@dataclass
+class HedgeStrategy:
+    """Send a duplicate of a slow request on another curl handle, the first response
+    wins and the other transfer is cancelled.
+
+    The duplicate is sent once the request has been running for the ``percentile``
+    latency of its host, i.e. for about 5% of the requests with the default.
+    """
+
+    percentile: float = 0.95
+    delay: float = 1.0
+    """Hedge delay until ``min_samples`` latencies of the host are observed."""
+    min_delay: float = 0.01
+    max_delay: float = 10.0
+    min_samples: int = 20
+    max_hedges: int = 1
+    """Max duplicates of one request."""
+    methods: tuple[str, ...] = ("GET", "HEAD", "OPTIONS")
+    """Only idempotent requests are hedged."""
+
+    def delay_for(self, latencies: LatencyTracker, host: str) -> float:
+        latency = latencies.percentile(host, self.percentile)
+        if latency is None or latencies.samples(host) < self.min_samples:
+            return self.delay
+        return min(self.max_delay, max(self.min_delay, latency))
+
+
+@dataclass
+class AdaptiveTimeout:
+    """Derive the timeout of a request from the observed latencies of its host.
+
+    The timeout is ``factor`` times the ``percentile`` latency, at least
+    ``min_timeout``. It never exceeds the ``timeout`` of the session, and requests
+    with an explicit ``timeout`` are not affected.
+    """
+
+    percentile: float = 0.99
+    factor: float = 3.0
+    min_timeout: float = 1.0
+    min_samples: int = 20
+
+    def timeout_for(self, latencies: LatencyTracker, host: str) -> Optional[float]:
+        latency = latencies.percentile(host, self.percentile)
+        if latency is None or latencies.samples(host) < self.min_samples:
+            return None
+        return max(self.min_timeout, latency * self.factor)
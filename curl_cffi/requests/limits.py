@@ -0,0 +1,123 @@
+from __future__ import annotations
+
+import threading
+import time
+from dataclasses import dataclass
+from typing import Optional, Union
+
+RateLimitSpec = Union["RateLimit", dict[str, "RateLimit"]]
+
+
+@dataclass
+class RateLimit:
+    """Limits of the requests sent to one host.
+
+    Requests are admitted by a token bucket: ``burst`` requests may start at once,
+    then ``rate`` requests per second.
+    """
+
+    rate: float
+    burst: int = 1
+    max_in_flight: Optional[int] = None
+    """Max requests in flight to the host, only enforced by ``AsyncSession``."""
+
+
+class _Bucket:
+    __slots__ = ("tokens", "updated", "paused_until")
+
+    def __init__(self, tokens: float, now: float) -> None:
+        self.tokens = tokens
+        self.updated = now
+        self.paused_until = 0.0
+
+
+class RateLimiter:
+    """Token buckets of the hosts of a session.
+
+    ``limits`` is either one ``RateLimit`` applied to every host on its own, or a
+    dict from host, i.e. ``netloc`` of the url, to its ``RateLimit``. The ``"*"``
+    key of the dict applies to the hosts not listed, other hosts are unlimited.
+    """
+
+    def __init__(self, limits: RateLimitSpec) -> None:
+        if isinstance(limits, RateLimit):
+            limits = {"*": limits}
+        for limit in limits.values():
+            if limit.rate <= 0:
+                raise ValueError("rate must be > 0")
+            if limit.burst < 1:
+                raise ValueError("burst must be at least 1")
+            if limit.max_in_flight is not None and limit.max_in_flight < 1:
+                raise ValueError("max_in_flight must be at least 1")
+        self._limits = dict(limits)
+        self._default = self._limits.get("*")
+        self._buckets: dict[str, _Bucket] = {}
+        # the sync session consumes tokens from many threads
+        self._lock = threading.Lock()
+
+    def limit_for(self, host: str) -> Optional[RateLimit]:
+        return self._limits.get(host, self._default)
+
+    def max_in_flight(self, host: str) -> Optional[int]:
+        limit = self.limit_for(host)
+        return limit.max_in_flight if limit is not None else None
+
+    def _refill(self, host: str, limit: RateLimit, now: float) -> _Bucket:
+        bucket = self._buckets.get(host)
+        if bucket is None:
+            bucket = self._buckets[host] = _Bucket(limit.burst, now)
+        else:
+            elapsed = now - bucket.updated
+            bucket.tokens = min(limit.burst, bucket.tokens + elapsed * limit.rate)
+            bucket.updated = now
+        return bucket
+
+    def delay(self, host: str, now: Optional[float] = None) -> float:
+        """Seconds until a request to ``host`` may start, without taking a token."""
+        limit = self.limit_for(host)
+        if limit is None:
+            return 0.0
+        now = time.monotonic() if now is None else now
+        with self._lock:
+            bucket = self._refill(host, limit, now)
+            wait = max(0.0, bucket.paused_until - now)
+            if bucket.tokens < 1:
+                wait = max(wait, (1 - bucket.tokens) / limit.rate)
+            return wait
+
+    def consume(self, host: str, now: Optional[float] = None) -> None:
+        """Take a token for a request starting now, after ``delay`` returned 0."""
+        limit = self.limit_for(host)
+        if limit is None:
+            return
+        now = time.monotonic() if now is None else now
+        with self._lock:
+            self._refill(host, limit, now).tokens -= 1
+
+    def reserve(self, host: str) -> float:
+        """Take a token now and return the seconds to wait before using it.
+
+        The bucket goes into debt, so that concurrent callers are spread over time
+        instead of all waking up at once.
+        """
+        limit = self.limit_for(host)
+        if limit is None:
+            return 0.0
+        now = time.monotonic()
+        with self._lock:
+            bucket = self._refill(host, limit, now)
+            bucket.tokens -= 1
+            wait = max(0.0, bucket.paused_until - now)
+            if bucket.tokens < 0:
+                wait = max(wait, -bucket.tokens / limit.rate)
+            return wait
+
+    def pause(self, host: str, seconds: float) -> None:
+        """Hold all requests to ``host`` for ``seconds``, e.g. after a 429."""
+        limit = self.limit_for(host)
+        if limit is None:
+            return
+        now = time.monotonic()
+        with self._lock:
+            bucket = self._refill(host, limit, now)
+            bucket.paused_until = max(bucket.paused_until, now + seconds)
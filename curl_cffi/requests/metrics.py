@@ -0,0 +1,280 @@
+from __future__ import annotations
+
+import math
+import threading
+from dataclasses import dataclass, field
+from typing import TYPE_CHECKING, Any, Callable, Optional
+from urllib.parse import urlsplit
+
+from ..const import CurlInfo
+from .latency import LatencyHistogram
+
+if TYPE_CHECKING:
+    from .models import Response
+
+__all__ = ["OriginMetrics", "RequestMetrics", "SessionMetrics"]
+
+# Appended to the infos every response fetches with a single getinfo_many call, only
+# when the session has metrics.
+METRIC_INFOS = (
+    CurlInfo.NAMELOOKUP_TIME,
+    CurlInfo.CONNECT_TIME,
+    CurlInfo.APPCONNECT_TIME,
+    CurlInfo.STARTTRANSFER_TIME,
+    CurlInfo.NUM_CONNECTS,
+)
+
+_PHASES = ("total", "ttfb", "dns", "connect", "tls", "pool_wait")
+
+
+def origin_of(url: str) -> str:
+    parts = urlsplit(url)
+    return f"{parts.scheme}://{parts.netloc}"
+
+
+@dataclass
+class RequestMetrics:
+    """Timings and sizes of one transfer, in seconds and bytes.
+
+    The phases are those of the transfer itself, ``dns``, ``connect`` and ``tls`` are
+    0 when a connection was reused.
+    """
+
+    origin: str
+    status_code: int
+    total: float
+    ttfb: float
+    """Time to the first byte of the response."""
+    dns: float
+    connect: float
+    tls: float
+    """Time of the TLS handshake."""
+    new_connections: int
+    bytes_sent: int
+    bytes_received: int
+
+
+@dataclass
+class OriginMetrics:
+    """Counters and latency histograms of one origin, a snapshot of
+    ``SessionMetrics``."""
+
+    requests: int = 0
+    """Transfers, failed ones included, streams are counted when their headers
+    arrive."""
+    errors: int = 0
+    """Failed attempts, retried or not."""
+    retries: int = 0
+    new_connections: int = 0
+    reused_connections: int = 0
+    """Responses received on an already open connection."""
+    tls_handshakes: int = 0
+    bytes_sent: int = 0
+    bytes_received: int = 0
+    total: LatencyHistogram = field(default_factory=lambda: LatencyHistogram(None))
+    ttfb: LatencyHistogram = field(default_factory=lambda: LatencyHistogram(None))
+    dns: LatencyHistogram = field(default_factory=lambda: LatencyHistogram(None))
+    """Only observed for new connections, and so are ``connect`` and ``tls``."""
+    connect: LatencyHistogram = field(default_factory=lambda: LatencyHistogram(None))
+    tls: LatencyHistogram = field(default_factory=lambda: LatencyHistogram(None))
+    pool_wait: LatencyHistogram = field(
+        default_factory=lambda: LatencyHistogram(None)
+    )
+    """Time spent waiting for a curl handle of ``AsyncSession``."""
+
+    def copy(self) -> OriginMetrics:
+        return OriginMetrics(
+            self.requests,
+            self.errors,
+            self.retries,
+            self.new_connections,
+            self.reused_connections,
+            self.tls_handshakes,
+            self.bytes_sent,
+            self.bytes_received,
+            *(getattr(self, phase).copy() for phase in _PHASES),
+        )
+
+
+class SessionMetrics:
+    """Latencies, connection reuse, bytes and retries of the requests of a session,
+    for each origin, i.e. ``scheme://host:port`` of the final url.
+
+    The timings are read with the other infos of the response in a single call into
+    libcurl, so the cost is a few dict updates per request. Sessions without metrics
+    pay nothing.
+
+    .. code-block:: python
+
+        metrics = SessionMetrics()
+        s = AsyncSession(metrics=metrics, max_clients=20)
+        ...
+        for origin, m in metrics.snapshot().items():
+            print(origin, m.total.percentile(0.99), m.pool_wait.percentile(0.99))
+    """
+
+    def __init__(self, hook: Optional[Callable[[RequestMetrics], None]] = None) -> None:
+        """
+        Parameters:
+            hook: called with the ``RequestMetrics`` of every response, in the thread
+                or the loop of the session, keep it cheap.
+        """
+        self.hook = hook
+        self._origins: dict[str, OriginMetrics] = {}
+        # sync sessions may be shared by threads
+        self._lock = threading.Lock()
+
+    def _origin(self, origin: str) -> OriginMetrics:
+        metrics = self._origins.get(origin)
+        if metrics is None:
+            metrics = self._origins[origin] = OriginMetrics()
+        return metrics
+
+    def record_response(
+        self, response: Response, infos: list[Any], origin: Optional[str] = None
+    ) -> None:
+        """Record a response with the values of ``METRIC_INFOS``, under the origin
+        of its final url unless given."""
+        namelookup, connect, appconnect, starttransfer, num_connects = infos
+        request = RequestMetrics(
+            origin=origin if origin is not None else origin_of(response.url),
+            status_code=response.status_code,
+            total=response.elapsed.total_seconds(),
+            ttfb=starttransfer,
+            dns=namelookup if num_connects else 0.0,
+            connect=max(0.0, connect - namelookup) if num_connects else 0.0,
+            tls=max(0.0, appconnect - connect) if num_connects and appconnect else 0.0,
+            new_connections=num_connects,
+            bytes_sent=response.upload_size + response.request_size,
+            bytes_received=response.download_size + response.header_size,
+        )
+        with self._lock:
+            metrics = self._origin(request.origin)
+            metrics.requests += 1
+            metrics.bytes_sent += request.bytes_sent
+            metrics.bytes_received += request.bytes_received
+            metrics.total.observe(request.total)
+            metrics.ttfb.observe(request.ttfb)
+            if num_connects:
+                metrics.new_connections += num_connects
+                metrics.dns.observe(request.dns)
+                metrics.connect.observe(request.connect)
+                if appconnect:
+                    metrics.tls_handshakes += 1
+                    metrics.tls.observe(request.tls)
+            else:
+                metrics.reused_connections += 1
+        if self.hook is not None:
+            self.hook(request)
+
+    def record_error(self, origin: str, retried: bool) -> None:
+        with self._lock:
+            metrics = self._origin(origin)
+            metrics.errors += 1
+            if retried:
+                metrics.retries += 1
+
+    def record_pool_wait(self, origin: str, seconds: float) -> None:
+        with self._lock:
+            self._origin(origin).pool_wait.observe(seconds)
+
+    def snapshot(self) -> dict[str, OriginMetrics]:
+        """A copy of the metrics of each origin."""
+        with self._lock:
+            return {origin: m.copy() for origin, m in self._origins.items()}
+
+    def reset(self) -> None:
+        with self._lock:
+            self._origins.clear()
+
+    def to_prometheus(self, prefix: str = "curl_cffi") -> str:
+        """The metrics in the Prometheus text format, to be served on ``/metrics``.
+
+        Latencies are histograms in seconds with a bucket for each doubling from 1ms.
+        """
+        lines: list[str] = []
+        snapshot = self.snapshot()
+        counters = (
+            ("requests", "Transfers, failed ones included."),
+            ("errors", "Failed attempts."),
+            ("retries", "Retried attempts."),
+            ("new_connections", "Connections opened."),
+            ("reused_connections", "Responses on a reused connection."),
+            ("tls_handshakes", "TLS handshakes."),
+            ("bytes_sent", "Bytes sent, headers included."),
+            ("bytes_received", "Bytes received, headers included."),
+        )
+        for name, help_text in counters:
+            metric = f"{prefix}_{name}_total"
+            lines.append(f"# HELP {metric} {help_text}")
+            lines.append(f"# TYPE {metric} counter")
+            for origin, m in snapshot.items():
+                value = getattr(m, name)
+                lines.append(f'{metric}{{origin="{_escape(origin)}"}} {value}')
+        for phase in _PHASES:
+            metric = f"{prefix}_{phase}_seconds"
+            lines.append(f"# HELP {metric} Latency of the {phase} phase.")
+            lines.append(f"# TYPE {metric} histogram")
+            for origin, m in snapshot.items():
+                label = f'origin="{_escape(origin)}"'
+                histogram: LatencyHistogram = getattr(m, phase)
+                for bound, count in histogram.cumulative():
+                    le = "+Inf" if math.isinf(bound) else f"{bound:.6g}"
+                    lines.append(f'{metric}_bucket{{{label},le="{le}"}} {count:g}')
+                lines.append(f"{metric}_sum{{{label}}} {histogram.sum:.6g}")
+                lines.append(f"{metric}_count{{{label}}} {histogram.total:g}")
+        return "\n".join(lines) + "\n"
+
+    def bind_opentelemetry(self, meter: Any, prefix: str = "curl_cffi") -> None:
+        """Report the metrics with observable instruments of an OpenTelemetry
+        ``meter``: a counter for each counter and p50/p90/p99 gauges for each phase,
+        with an ``origin`` attribute. Requires ``opentelemetry-api``."""
+        from opentelemetry.metrics import Observation
+
+        def counter(name: str) -> Callable[[Any], list[Any]]:
+            def observe(options: Any) -> list[Any]:
+                return [
+                    Observation(getattr(m, name), {"origin": origin})
+                    for origin, m in self.snapshot().items()
+                ]
+
+            return observe
+
+        def percentile(phase: str, p: float) -> Callable[[Any], list[Any]]:
+            def observe(options: Any) -> list[Any]:
+                observations = []
+                for origin, m in self.snapshot().items():
+                    histogram: LatencyHistogram = getattr(m, phase)
+                    if histogram.total:
+                        value = histogram.percentile(p)
+                        observations.append(Observation(value, {"origin": origin}))
+                return observations
+
+            return observe
+
+        for name in (
+            "requests",
+            "errors",
+            "retries",
+            "new_connections",
+            "reused_connections",
+            "tls_handshakes",
+        ):
+            meter.create_observable_counter(
+                f"{prefix}.{name}", callbacks=[counter(name)]
+            )
+        for name in ("bytes_sent", "bytes_received"):
+            meter.create_observable_counter(
+                f"{prefix}.{name}", callbacks=[counter(name)], unit="By"
+            )
+        for phase in _PHASES:
+            for p in (0.5, 0.9, 0.99):
+                meter.create_observable_gauge(
+                    f"{prefix}.{phase}.p{round(p * 100)}",
+                    callbacks=[percentile(phase, p)],
+                    unit="s",
+                )
+
+
+def _escape(value: str) -> str:
+    return value.replace("\\", "\\\\").replace('"', '\\"').replace("\n", "\\n")
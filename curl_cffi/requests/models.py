@@ -1,24 +1,36 @@
+import codecs
+import http.cookies
+import json as stdlib_json
 from contextlib import suppress
+import mmap
 import queue
 import re
 import warnings
 from concurrent.futures import Future
 from typing import Any, Optional, Union
-from collections.abc import Awaitable, Callable
+from collections.abc import AsyncIterator, Awaitable, Callable, Iterator
 from datetime import timedelta
+from functools import partial
 
 from ..curl import Curl
 from ..utils import CurlCffiWarning
 from .cookies import Cookies
 from .exceptions import HTTPError, RequestException
 from .headers import Headers
-from .streams import STREAM_END
+from .streams import STREAM_END, _AsyncRingQueue
 
-# Use orjson if present
+# Use orjson or simdjson if present, they parse utf-8 bytes without decoding them to
+# str first, orjson takes memoryviews too.
 try:
-    from orjson import loads
+    from orjson import loads as _loads
+
+    _LOADS_BUFFERS = True
 except ImportError:
-    from json import loads
+    _LOADS_BUFFERS = False
+    try:
+        from simdjson import loads as _loads  # type: ignore
+    except ImportError:
+        from json import loads as _loads
 
 with suppress(ImportError):
     from markdownify import markdownify as md
@@ -43,9 +55,138 @@ JSON_NATIVE_ENCODINGS = {
     "utf-32be",
     "utf-32le",
 }
+UTF8_ENCODINGS = {"utf-8", "utf8"}
 REDIRECT_STATI = (301, 302, 303, 307, 308)
 
 
+def cookies_from_headers(headers: Headers) -> Cookies:
+    """The cookies set by the ``Set-Cookie`` headers of a response."""
+    cookies = Cookies()
+    for set_cookie in headers.get_list("set-cookie"):
+        if not set_cookie:
+            continue
+        try:
+            parsed = http.cookies.SimpleCookie()
+            parsed.load(set_cookie)
+            for name, morsel in parsed.items():
+                cookies.set(
+                    name,
+                    morsel.value,
+                    domain=morsel.get("domain", ""),
+                    path=morsel.get("path", "/"),
+                    secure=bool(morsel.get("secure")),
+                )
+        except Exception:
+            continue
+    return cookies
+
+
+class _JsonRecords:
+    """Parse the records of a chunked stream of delimited JSON, e.g. NDJSON.
+
+    Records are parsed straight from the chunks, only a record spanning chunks is
+    copied into a buffer.
+    """
+
+    __slots__ = ("loads", "delimiter", "pending", "views")
+
+    def __init__(self, loads: Callable[[Any], Any], delimiter: bytes) -> None:
+        self.loads = loads
+        self.delimiter = delimiter
+        self.pending = bytearray()
+        # parse slices of the chunk without copying them, if the decoder can
+        self.views = _LOADS_BUFFERS and loads is _loads
+
+    def feed(self, chunk: Union[bytes, memoryview]) -> list[Any]:
+        if isinstance(chunk, memoryview):
+            # the ring buffer slot is reused for the next chunk
+            chunk = bytes(chunk)
+        data: Union[bytes, memoryview] = memoryview(chunk) if self.views else chunk
+        records = []
+        start = 0
+        step = len(self.delimiter)
+        end = chunk.find(self.delimiter)
+        while end != -1:
+            if self.pending:
+                self.pending += data[:end]
+                record: Union[bytes, memoryview] = bytes(self.pending)
+            else:
+                record = data[start:end]
+            if _has_value(record):
+                records.append(self.loads(record))
+            self.pending = bytearray()
+            start = end + step
+            end = chunk.find(self.delimiter, start)
+        if start < len(chunk):
+            self.pending += data[start:]
+        return records
+
+    def close(self) -> list[Any]:
+        record, self.pending = bytes(self.pending), bytearray()
+        return [self.loads(record)] if _has_value(record) else []
+
+
+def _has_value(record: Union[bytes, memoryview]) -> bool:
+    # skip blank records, e.g. keep-alive lines, without copying the record
+    return len(record) > 2 or bool(bytes(record).strip())
+
+
+class RawResponse:
+    """What libcurl collected for a response, ``headers``, ``cookies`` and
+    ``history`` are built from it when first accessed."""
+
+    __slots__ = ("blocks", "redirect_history", "response_class", "default_encoding")
+
+    def __init__(
+        self,
+        blocks: list[tuple[int, bytes, list[tuple[bytes, bytes]]]],
+        redirect_history: list[bytes],
+        response_class: type["Response"],
+        default_encoding: Union[str, Callable[[bytes], str]],
+    ):
+        # header blocks as split by the C collector, one per response of the
+        # transfer, a block with status 0 holds stray lines without a status line
+        self.blocks = blocks
+        self.redirect_history = redirect_history
+        self.response_class = response_class
+        self.default_encoding = default_encoding
+
+    def final_block(self) -> Optional[tuple[int, bytes, list[tuple[bytes, bytes]]]]:
+        for block in reversed(self.blocks):
+            if block[0]:
+                return block
+        # stray lines are only used if there is nothing else
+        return self.blocks[-1] if self.blocks else None
+
+    def history(self) -> list["Response"]:
+        history: list[Response] = []
+        blocks = [block for block in self.blocks if block[0]]
+        block_index = 0
+        for item in self.redirect_history:
+            try:
+                status_bytes, url_bytes = item.split(b"\t", 1)
+                status = int(status_bytes)
+            except (TypeError, ValueError):
+                continue
+
+            response = self.response_class(None)
+            response.url = url_bytes.decode(errors="replace")
+            response.status_code = status
+            response.reason = ""
+            response.ok = 200 <= status < 400
+            response.headers = Headers()
+            response.default_encoding = self.default_encoding
+            for index in range(block_index, len(blocks)):
+                block_status, reason, pairs = blocks[index]
+                if block_status == status:
+                    response.reason = reason.decode(errors="replace")
+                    response.headers = Headers.from_raw_pairs(pairs)
+                    block_index = index + 1
+                    break
+            history.append(response)
+        return history
+
+
 class Request:
     """Representing a sent request.
 
@@ -53,7 +194,8 @@ class Request:
         url: request url.
         headers: request headers.
         method: request http method.
-        body: request body as bytes, or None if not provided.
+        body: request body as bytes, or the bytes-like object it was sent from in
+            place, e.g. a ``bytearray`` or ``mmap``. None if not provided.
     """
 
     def __init__(
@@ -61,7 +203,7 @@ class Request:
         url: str,
         headers: Headers,
         method: str,
-        body: Optional[bytes] = None,
+        body: Optional[Union[bytes, bytearray, memoryview, mmap.mmap]] = None,
     ):
         self.url = url
         self.headers = headers
@@ -69,12 +211,54 @@ class Request:
         self.body = body
 
 
+# the attributes of a Response, _encoding and _text are only set once built
+_RESPONSE_ATTRS = (
+    "curl",
+    "request",
+    "url",
+    "content",
+    "status_code",
+    "reason",
+    "ok",
+    "_raw",
+    "_headers",
+    "_cookies",
+    "_history",
+    "_encoding",
+    "_text",
+    "elapsed",
+    "default_encoding",
+    "redirect_count",
+    "redirect_url",
+    "http_version",
+    "primary_ip",
+    "primary_port",
+    "local_ip",
+    "local_port",
+    "infos",
+    "queue",
+    "stream_task",
+    "astream_task",
+    "quit_now",
+    "_stream_closed",
+    "download_size",
+    "upload_size",
+    "header_size",
+    "request_size",
+    "response_size",
+)
+
+
 class Response:
     """Contains information the server sends.
 
+    ``headers``, ``cookies``, ``history``, ``encoding`` and ``text`` are built on first
+    access, responses only read for their status and content skip that work.
+
     Attributes:
         url: url used in the request.
-        content: response body in bytes.
+        content: response body in bytes, a read-only memoryview for the hits of a
+            ``BinaryCacheBackend`` with ``zero_copy``.
         text: response body in str.
         status_code: http status code.
         reason: http response reason, such as OK, Not Found.
@@ -104,6 +288,9 @@ class Response:
         response_size: download_size + header_size
     """
 
+    # __dict__ and __weakref__ are kept for the attributes set by subclasses or users
+    __slots__ = (*_RESPONSE_ATTRS, "__dict__", "__weakref__")
+
     def __init__(self, curl: Optional[Curl] = None, request: Optional[Request] = None):
         self.curl = curl
         self.request = request
@@ -112,8 +299,10 @@ class Response:
         self.status_code = 200
         self.reason = "OK"
         self.ok = True
-        self.headers = Headers()
-        self.cookies = Cookies()
+        self._raw: Optional[RawResponse] = None
+        self._headers: Optional[Headers] = None
+        self._cookies: Optional[Cookies] = None
+        self._history: Optional[list[Response]] = None
         self.elapsed: timedelta = timedelta()
         self.default_encoding: Union[str, Callable[[bytes], str]] = "utf-8"
         self.redirect_count = 0
@@ -123,7 +312,6 @@ class Response:
         self.primary_port: int = 0
         self.local_ip: str = ""
         self.local_port: int = 0
-        self.history: list[Response] = []
         self.infos: dict[str, Any] = {}
         self.queue: Optional[queue.Queue] = None
         self.stream_task: Optional[Future] = None
@@ -151,8 +339,14 @@ class Response:
                 "stream=True before pickling the response."
             )
 
-        state = self.__dict__.copy()
+        # build the lazy attributes, the raw data is not kept
+        _ = self.headers, self.cookies, self.history
+        state = {
+            name: getattr(self, name) for name in _RESPONSE_ATTRS if hasattr(self, name)
+        }
+        state.update(self.__dict__)
         for attribute in (
+            "_raw",
             "curl",
             "queue",
             "stream_task",
@@ -163,7 +357,12 @@ class Response:
         return state
 
     def __setstate__(self, state: dict[str, Any]) -> None:
-        self.__dict__.update(state)
+        for name in ("headers", "cookies", "history"):
+            if name in state:  # pickled before they became lazy
+                state[f"_{name}"] = state.pop(name)
+        for name, value in state.items():
+            setattr(self, name, value)
+        self._raw = None
         self.curl = None
         self.queue = None
         self.stream_task = None
@@ -171,6 +370,43 @@ class Response:
         self.quit_now = None
         self._stream_closed = True
 
+    @property
+    def headers(self) -> Headers:
+        if self._headers is None:
+            block = self._raw.final_block() if self._raw is not None else None
+            self._headers = (
+                Headers.from_raw_pairs(block[2]) if block is not None else Headers()
+            )
+        return self._headers
+
+    @headers.setter
+    def headers(self, headers: Headers) -> None:
+        self._headers = headers
+
+    @property
+    def cookies(self) -> Cookies:
+        if self._cookies is None:
+            self._cookies = (
+                cookies_from_headers(self.headers)
+                if self._raw is not None
+                else Cookies()
+            )
+        return self._cookies
+
+    @cookies.setter
+    def cookies(self, cookies: Cookies) -> None:
+        self._cookies = cookies
+
+    @property
+    def history(self) -> list["Response"]:
+        if self._history is None:
+            self._history = self._raw.history() if self._raw is not None else []
+        return self._history
+
+    @history.setter
+    def history(self, history: list["Response"]) -> None:
+        self._history = history
+
     @property
     def charset(self) -> str:
         """Alias for encoding."""
@@ -229,11 +465,12 @@ class Response:
         body_as_md = md(f"<h1>{title}</h1><main>{summary}</main>")
         return body_as_md
 
-    def _decode(self, content: bytes) -> str:
+    def _decode(self, content: Union[bytes, memoryview]) -> str:
+        # str() also decodes the memoryviews of cache hits without a copy
         try:
-            return content.decode(self.encoding, errors="replace")
+            return str(content, self.encoding, errors="replace")
         except (UnicodeDecodeError, LookupError):
-            return content.decode("utf-8-sig")
+            return str(content, "utf-8-sig")
 
     def raise_for_status(self):
         """Raise an error if status code is not in [200, 400)"""
@@ -259,6 +496,8 @@ class Response:
         ):
             if pending is not None:
                 chunk = pending + chunk
+            elif isinstance(chunk, memoryview):
+                chunk = bytes(chunk)
             lines = chunk.split(delimiter) if delimiter else chunk.splitlines()
             pending = (
                 lines.pop()
@@ -274,6 +513,9 @@ class Response:
     def iter_content(self, chunk_size=None, decode_unicode=False):
         """
         iterate streaming content chunk by chunk in bytes.
+
+        With ``stream_buffer_size``, chunks are memoryviews into the ring buffer,
+        released when the next chunk is requested, copy them with ``bytes`` to keep.
         """
         if chunk_size:
             warnings.warn(
@@ -301,14 +543,57 @@ class Response:
             yield chunk
         self._finalize_stream()
 
-    def json(self, **kw):
-        """return a parsed json object of the content."""
+    def json(self, *, loads: Optional[Callable[[Any], Any]] = None, **kw):
+        """return a parsed json object of the content.
+
+        UTF-8 content is parsed straight from bytes, without decoding it to ``text``
+        first, by orjson or simdjson when installed.
+
+        Parameters:
+            loads: JSON decoder to use instead, it gets bytes, or str if the charset
+                is not one of the encodings JSON parsers detect.
+            kw: passed to ``json.loads``, which is then used, not together with
+                ``loads``.
+        """
+        if kw:
+            if loads is not None:
+                raise TypeError("loads and json.loads arguments are exclusive")
+            loads = partial(stdlib_json.loads, **kw)
+        elif loads is None:
+            loads = _loads
         charset_encoding = self.charset_encoding
+        encoding = "utf-8"
         if charset_encoding is not None:
             encoding = charset_encoding.lower().replace("_", "-")
             if encoding not in JSON_NATIVE_ENCODINGS:
-                return loads(self.text, **kw)
-        return loads(self.content, **kw)
+                return loads(self.text)
+        content = self.content
+        if loads is _loads and (
+            encoding not in UTF8_ENCODINGS or content[:3] == codecs.BOM_UTF8
+        ):
+            # utf-16, utf-32 and a BOM are only detected by the standard library
+            loads = stdlib_json.loads
+        if isinstance(content, memoryview) and not (_LOADS_BUFFERS and loads is _loads):
+            content = content.tobytes()
+        return loads(content)
+
+    def iter_json(
+        self,
+        delimiter: bytes = b"\n",
+        loads: Optional[Callable[[Any], Any]] = None,
+    ) -> Iterator[Any]:
+        """
+        iterate the records of streaming JSON separated by ``delimiter``, e.g. NDJSON,
+        parsed as the chunks arrive. Blank records are skipped.
+
+        Parameters:
+            delimiter: separator of the records.
+            loads: JSON decoder, it gets the utf-8 bytes of each record.
+        """
+        records = _JsonRecords(loads or _loads, delimiter)
+        for chunk in self.iter_content():
+            yield from records.feed(chunk)
+        yield from records.close()
 
     def close(self):
         """Close the streaming connection, only valid in stream mode."""
@@ -341,6 +626,8 @@ class Response:
         ):
             if pending is not None:
                 chunk = pending + chunk
+            elif isinstance(chunk, memoryview):
+                chunk = bytes(chunk)
             lines = chunk.split(delimiter) if delimiter else chunk.splitlines()
             pending = (
                 lines.pop()
@@ -357,6 +644,9 @@ class Response:
     async def aiter_content(self, chunk_size=None, decode_unicode=False):
         """
         iterate streaming content chunk by chunk in bytes.
+
+        With ``stream_buffer_size``, chunks are memoryviews into the ring buffer,
+        released when the next chunk is requested, copy them with ``bytes`` to keep.
         """
         if chunk_size:
             warnings.warn(
@@ -384,6 +674,26 @@ class Response:
 
             yield chunk
 
+    async def aiter_json(
+        self,
+        delimiter: bytes = b"\n",
+        loads: Optional[Callable[[Any], Any]] = None,
+    ) -> AsyncIterator[Any]:
+        """
+        iterate the records of streaming JSON separated by ``delimiter``, e.g. NDJSON,
+        parsed as the chunks arrive. Blank records are skipped.
+
+        Parameters:
+            delimiter: separator of the records.
+            loads: JSON decoder, it gets the utf-8 bytes of each record.
+        """
+        records = _JsonRecords(loads or _loads, delimiter)
+        async for chunk in self.aiter_content():
+            for record in records.feed(chunk):
+                yield record
+        for record in records.close():
+            yield record
+
     async def atext(self) -> str:
         """
         Return a decoded string.
@@ -394,12 +704,15 @@ class Response:
         """wait and read the streaming content in one bytes object."""
         chunks = []
         async for chunk in self.aiter_content():
-            chunks.append(chunk)
+            chunks.append(bytes(chunk))
         return b"".join(chunks)
 
     async def aclose(self):
         """Close the streaming connection, only valid in stream mode."""
 
+        if isinstance(self.quit_now, _AsyncRingQueue):
+            # a full ring keeps the transfer paused, abort it instead of waiting
+            self.quit_now.set()
         if self.astream_task:
             await self.astream_task
 
@@ -0,0 +1,313 @@
+from __future__ import annotations
+
+import asyncio
+import time
+from collections import deque
+from dataclasses import dataclass, field
+from typing import Callable, Optional
+
+from ..curl import Curl
+from .exceptions import SessionClosed
+from .limits import RateLimiter
+
+
+@dataclass
+class PoolStats:
+    """A snapshot of the utilization of a ``CurlPool``."""
+
+    size: int
+    """Curl handles alive, idle or in use."""
+    idle: int
+    in_use: int
+    waiting: int
+    """Callers waiting for a handle."""
+    max_size: int
+    in_use_per_host: dict[str, int] = field(default_factory=dict)
+    acquired: int = 0
+    waited: int = 0
+    """Acquisitions that had to wait for a handle."""
+    wait_time: float = 0.0
+    """Total seconds spent waiting for handles."""
+    max_wait_time: float = 0.0
+    created: int = 0
+    evicted: int = 0
+    """Idle handles closed after ``idle_timeout``."""
+
+
+class _Waiter:
+    __slots__ = ("future", "host", "priority", "seq")
+
+    def __init__(
+        self, future: asyncio.Future[Curl], host: Optional[str], priority: int, seq: int
+    ) -> None:
+        self.future = future
+        self.host = host
+        self.priority = priority
+        self.seq = seq
+
+
+class CurlPool:
+    """A bounded pool of curl handles for ``AsyncSession``.
+
+    Handles are created on demand, up to ``max_size`` of them in use at once. Idle
+    handles are reused last-in first-out, so that the coldest ones stay idle and are
+    closed after ``idle_timeout`` seconds, down to ``min_size`` handles.
+
+    With ``max_per_host``, at most that many handles are in use for one host, callers
+    for a busy host wait without holding back the callers for other hosts. The
+    ``limiter`` adds a token bucket and an in-flight cap for each host.
+
+    Waiters are served by priority, higher first, then the hosts with the fewest
+    handles in use first, so that one busy host does not starve the others, then
+    first come, first served.
+    """
+
+    def __init__(
+        self,
+        factory: Callable[[], Curl],
+        max_size: int = 10,
+        min_size: int = 0,
+        idle_timeout: Optional[float] = None,
+        max_per_host: Optional[int] = None,
+        limiter: Optional[RateLimiter] = None,
+    ) -> None:
+        """
+        Parameters:
+            factory: creates a new curl handle.
+            max_size: max handles in use at once.
+            min_size: idle handles are not evicted below this many handles.
+            idle_timeout: seconds after which an idle handle is closed, never if None.
+            max_per_host: max handles in use at once for one host, unlimited if None.
+            limiter: rate limits of the hosts.
+        """
+        if max_size < 1:
+            raise ValueError("max_size must be at least 1")
+        if not 0 <= min_size <= max_size:
+            raise ValueError("min_size must be between 0 and max_size")
+        if max_per_host is not None and max_per_host < 1:
+            raise ValueError("max_per_host must be at least 1")
+        self._factory = factory
+        self.max_size = max_size
+        self.min_size = min_size
+        self.idle_timeout = idle_timeout
+        self.max_per_host = max_per_host
+        self.limiter = limiter
+        # (handle, released at), the most recently released handle last
+        self._idle: deque[tuple[Curl, float]] = deque()
+        self._in_use: dict[Curl, Optional[str]] = {}
+        self._host_counts: dict[str, int] = {}
+        self._waiters: list[_Waiter] = []
+        self._seq = 0
+        self._evict_handle: Optional[asyncio.TimerHandle] = None
+        self._wake_handle: Optional[asyncio.TimerHandle] = None
+        self._closed = False
+        self._stats = PoolStats(0, 0, 0, 0, max_size)
+
+    @property
+    def size(self) -> int:
+        return len(self._idle) + len(self._in_use)
+
+    def stats(self) -> PoolStats:
+        """Returns the current utilization and the counters since creation."""
+        s = self._stats
+        return PoolStats(
+            size=self.size,
+            idle=len(self._idle),
+            in_use=len(self._in_use),
+            waiting=len(self._waiters),
+            max_size=self.max_size,
+            in_use_per_host=dict(self._host_counts),
+            acquired=s.acquired,
+            waited=s.waited,
+            wait_time=s.wait_time,
+            max_wait_time=s.max_wait_time,
+            created=s.created,
+            evicted=s.evicted,
+        )
+
+    def fill(self) -> None:
+        """Create idle handles up to ``min_size``."""
+        now = time.monotonic()
+        while not self._closed and self.size < self.min_size:
+            self._idle.appendleft((self._create(), now))
+
+    async def acquire(self, host: Optional[str] = None, priority: int = 0) -> Curl:
+        """Take a handle, waiting while ``max_size`` handles, or the max handles for
+        ``host``, are in use, or while the rate limit of ``host`` is exceeded."""
+        if self._closed:
+            raise SessionClosed("Session is closed.")
+        self._stats.acquired += 1
+        if not self._waiters and self._available(host):
+            if host is None or self._rate_delay(host) == 0:
+                return self._take(host)
+
+        waiter: asyncio.Future[Curl] = asyncio.get_running_loop().create_future()
+        self._seq += 1
+        entry = _Waiter(waiter, host, priority, self._seq)
+        self._waiters.append(entry)
+        start = time.monotonic()
+        self._wake()
+        try:
+            curl = await waiter
+        except BaseException:
+            if waiter.done() and not waiter.cancelled() and not waiter.exception():
+                # cancelled right after being handed a handle
+                self.release(waiter.result())
+            elif entry in self._waiters:
+                self._waiters.remove(entry)
+            raise
+        finally:
+            elapsed = time.monotonic() - start
+            self._stats.waited += 1
+            self._stats.wait_time += elapsed
+            self._stats.max_wait_time = max(self._stats.max_wait_time, elapsed)
+        return curl
+
+    def release(self, curl: Curl) -> None:
+        """Give back a handle taken with ``acquire``, to be reused."""
+        self._untrack(curl)
+        if self._closed:
+            curl.close()
+            return
+        self._idle.append((curl, time.monotonic()))
+        self._wake()
+        self._schedule_evict()
+
+    def discard(self, curl: Optional[Curl] = None) -> None:
+        """Give back the slot of a handle that can not be reused, e.g. a websocket,
+        or with None, the slot of a handle in use that was closed already.
+
+        The caller closes the handle.
+        """
+        if curl is None:
+            curl = next((c for c in self._in_use if c._curl is None), None)
+        if curl is not None:
+            self._untrack(curl)
+        self._wake()
+
+    def take_idle(self) -> list[Curl]:
+        """Take all the idle handles, to be given back with ``release``."""
+        curls = []
+        while self._idle:
+            curl = self._idle.pop()[0]
+            self._in_use[curl] = None
+            curls.append(curl)
+        return curls
+
+    def close(self) -> None:
+        """Close the idle handles, the ones in use are closed when released."""
+        self._closed = True
+        for handle in (self._evict_handle, self._wake_handle):
+            if handle is not None:
+                handle.cancel()
+        self._evict_handle = self._wake_handle = None
+        while self._idle:
+            curl, _ = self._idle.pop()
+            curl.close()
+        waiters, self._waiters = self._waiters, []
+        for waiter in waiters:
+            if not waiter.future.done():
+                waiter.future.set_exception(SessionClosed("Session is closed."))
+
+    def _create(self) -> Curl:
+        self._stats.created += 1
+        return self._factory()
+
+    def _available(self, host: Optional[str]) -> bool:
+        if len(self._in_use) >= self.max_size:
+            return False
+        if host is None:
+            return True
+        limit = self.max_per_host
+        if self.limiter is not None:
+            host_limit = self.limiter.max_in_flight(host)
+            if host_limit is not None:
+                limit = host_limit if limit is None else min(limit, host_limit)
+        return limit is None or self._host_counts.get(host, 0) < limit
+
+    def _rate_delay(self, host: str) -> float:
+        return self.limiter.delay(host) if self.limiter is not None else 0.0
+
+    def _take(self, host: Optional[str]) -> Curl:
+        if host is not None and self.limiter is not None:
+            self.limiter.consume(host)
+        curl = self._idle.pop()[0] if self._idle else self._create()
+        self._in_use[curl] = host
+        if host is not None:
+            self._host_counts[host] = self._host_counts.get(host, 0) + 1
+        return curl
+
+    def _untrack(self, curl: Curl) -> None:
+        if curl not in self._in_use:
+            return
+        host = self._in_use.pop(curl)
+        if host is not None:
+            count = self._host_counts[host] - 1
+            if count:
+                self._host_counts[host] = count
+            else:
+                del self._host_counts[host]
+
+    def _wake(self) -> None:
+        if not self._waiters or len(self._in_use) >= self.max_size:
+            return
+        counts = self._host_counts
+        order = sorted(
+            self._waiters,
+            key=lambda w: (-w.priority, counts.get(w.host, 0) if w.host else 0, w.seq),
+        )
+        retry_in: Optional[float] = None
+        for waiter in order:
+            if len(self._in_use) >= self.max_size:
+                break
+            if waiter.future.done() or not self._available(waiter.host):
+                continue
+            if waiter.host is not None:
+                delay = self._rate_delay(waiter.host)
+                if delay:
+                    retry_in = delay if retry_in is None else min(retry_in, delay)
+                    continue
+            waiter.future.set_result(self._take(waiter.host))
+        self._waiters = [w for w in self._waiters if not w.future.done()]
+        if retry_in is not None and self._waiters:
+            self._schedule_wake(retry_in)
+
+    def _schedule_wake(self, delay: float) -> None:
+        # wake up when the first rate limited host gets a token again
+        loop = asyncio.get_running_loop()
+        when = loop.time() + delay
+        if self._wake_handle is not None:
+            if self._wake_handle.when() <= when:
+                return
+            self._wake_handle.cancel()
+        self._wake_handle = loop.call_at(when, self._on_wake_timer)
+
+    def _on_wake_timer(self) -> None:
+        self._wake_handle = None
+        self._wake()
+
+    def _schedule_evict(self) -> None:
+        if self.idle_timeout is None or self._evict_handle is not None:
+            return
+        if not self._idle:
+            return
+        loop = asyncio.get_running_loop()
+        due = self._idle[0][1] + self.idle_timeout
+        self._evict_handle = loop.call_at(
+            loop.time() + max(0.0, due - time.monotonic()), self._evict
+        )
+
+    def _evict(self) -> None:
+        self._evict_handle = None
+        assert self.idle_timeout is not None
+        deadline = time.monotonic() - self.idle_timeout
+        # the least recently released handles are on the left
+        while self._idle and self.size > self.min_size:
+            curl, released = self._idle[0]
+            if released > deadline:
+                break
+            self._idle.popleft()
+            curl.close()
+            self._stats.evicted += 1
+        if self.size > self.min_size:
+            self._schedule_evict()
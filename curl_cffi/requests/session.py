@@ -1,7 +1,6 @@
 from __future__ import annotations
 
 import asyncio
-import http.cookies
 import os
 import queue
 import random
@@ -12,15 +11,19 @@ import warnings
 from collections.abc import (
     AsyncGenerator,
     AsyncIterable,
+    Awaitable,
     Callable,
     Generator,
+    Iterable,
 )
 from concurrent.futures import ThreadPoolExecutor
-from contextlib import asynccontextmanager, contextmanager, suppress
+from contextlib import asynccontextmanager, contextmanager
 from dataclasses import dataclass
 from datetime import timedelta
-from io import BytesIO
+from email.utils import parsedate_to_datetime
+from functools import partial
 from typing import (
+    IO,
     TYPE_CHECKING,
     Any,
     Generic,
@@ -31,7 +34,7 @@ from typing import (
     Union,
     cast,
 )
-from urllib.parse import urlparse
+from urllib.parse import urljoin, urlparse
 
 # Unpack introduced in 3.11
 try:
@@ -39,26 +42,51 @@ try:
 except ImportError:
     from typing_extensions import Unpack
 
-from ..aio import AsyncCurl
-from ..const import CurlFollow, CurlHttpVersion, CurlInfo, CurlOpt
-from ..curl import Curl, CurlError, CurlMime
+from ..aio import CURLPIPE_NOTHING, AsyncCurl
+from ..const import (
+    CurlECode,
+    CurlFollow,
+    CurlHttpVersion,
+    CurlInfo,
+    CurlMOpt,
+    CurlOpt,
+)
+from ..curl import (
+    Curl,
+    CurlBuffer,
+    CurlError,
+    CurlHeaderBuffer,
+    CurlMime,
+    CurlMulti,
+    CurlShare,
+)
 from ..utils import CurlCffiWarning
-from .cache import CacheSpec, normalize_cache_backend
-from .cookies import Cookies, CookieTypes
+from .cache import CacheBackend, CacheLookup, CacheSpec, normalize_cache_backend
+from .connections import ConnectionStats, ConnectionTracker
+from .cookies import Cookies, CookieTypes, CurlCookies
 from .exceptions import (
+    HTTPError,
     RequestException,
     SessionClosed,
+    Timeout,
     code2error,
 )
 from .headers import Headers, HeaderTypes
 from .impersonate import BrowserTypeLiteral, ExtraFingerprints, ExtraFpDict
-from .models import Response
+from .latency import AdaptiveTimeout, HedgeStrategy, LatencyTracker
+from .metrics import METRIC_INFOS, SessionMetrics, origin_of
+from .limits import RateLimiter, RateLimitSpec
+from .models import RawResponse, Response
+from .pool import CurlPool, PoolStats
+from .store import PersistentStore, StoreProfile, profile_name
 from .streams import (
     STREAM_END,
     RequestContent,
     RequestData,
     SyncRequestContent,
     _AsyncIterableReader,
+    _AsyncRingQueue,
+    _RingQueue,
     _capture_body_position,
     _peek_aio_queue,
     _peek_queue,
@@ -124,6 +152,11 @@ if TYPE_CHECKING:
         discard_cookies: bool
         raise_for_status: bool
         cache: Optional[CacheSpec]
+        share: Union[bool, CurlShare]
+        rate_limit: Optional[RateLimitSpec]
+        metrics: Optional[SessionMetrics]
+        cookie_engine: bool
+        store: Optional[Union[str, os.PathLike[str], PersistentStore]]
 
     class StreamRequestParams(TypedDict, total=False):
         params: Optional[Union[dict, list, tuple]]
@@ -157,11 +190,16 @@ if TYPE_CHECKING:
         doh_url: Optional[str]
         cert: Optional[Union[str, tuple[str, str]]]
         max_recv_speed: int
+        stream_buffer_size: Optional[int]
         multipart: Optional[CurlMime]
         discard_cookies: bool
 
     class RequestParams(StreamRequestParams, total=False):
         stream: Optional[bool]
+        stream_to: Optional[Union[int, IO[bytes]]]
+
+    class AsyncRequestParams(RequestParams, total=False):
+        priority: int
 
 else:
 
@@ -175,11 +213,14 @@ else:
     ProxySpec = dict[str, str]
     BaseSessionParams = TypedDict
     StreamRequestParams, RequestParams = TypedDict, TypedDict
+    AsyncRequestParams = TypedDict
 
 ThreadType = Literal["eventlet", "gevent"]
 HttpMethod = Literal[
     "GET", "POST", "PUT", "DELETE", "OPTIONS", "HEAD", "TRACE", "PATCH", "QUERY"
 ]
+# a url to GET, or (method, url), or (method, url, request parameters)
+BatchItem = Union[str, tuple[HttpMethod, str], tuple[HttpMethod, str, dict[str, Any]]]
 
 
 def _is_absolute_url(url: str) -> bool:
@@ -219,6 +260,85 @@ def _normalize_retry(retry: Optional[Union[int, RetryStrategy]]) -> RetryStrateg
     return strategy
 
 
+def _retry_after(error: RequestException) -> Optional[float]:
+    """Seconds asked by the ``Retry-After`` header of a 429 or 503 response."""
+    rsp = error.response
+    if rsp is None or rsp.status_code not in (429, 503):
+        return None
+    value = rsp.headers.get("Retry-After")
+    if not value:
+        return None
+    try:
+        return max(0.0, float(value))
+    except ValueError:
+        pass
+    try:
+        date = parsedate_to_datetime(value)
+    except (TypeError, ValueError):
+        return None
+    return max(0.0, date.timestamp() - time.time())
+
+
+def _hedgeable(
+    hedge: Optional[HedgeStrategy],
+    method: str,
+    data: Any,
+    content: Any,
+    files: Any,
+    multipart: Any,
+    stream_to: Any,
+    content_callback: Any,
+) -> bool:
+    """Whether the request can be sent twice at once, i.e. it is idempotent and its
+    body and outputs are not consumed by the transfer."""
+    if hedge is None or method.upper() not in hedge.methods:
+        return False
+    if files is not None or multipart is not None or stream_to is not None:
+        return False
+    if content_callback is not None:
+        return False
+    body = content if content is not None else data
+    return body is None or isinstance(body, (bytes, str, dict, list, tuple))
+
+
+def _range_ignored(error: RequestException) -> bool:
+    """Whether a resumed download failed because the whole body was sent instead."""
+    return (
+        error.code == CurlECode.RANGE_ERROR
+        and error.response is not None
+        and error.response.status_code == 200
+    )
+
+
+def _range_stale(response: Response, offset: int) -> bool:
+    """Whether the range started past the end of a remote file that has changed,
+    libcurl accepts a ``416`` for a resumed download without writing it."""
+    if response.status_code != 416:
+        return False
+    return response.headers.get("Content-Range") != f"bytes */{offset}"
+
+
+# Fetched with a single getinfo_many call for every response, keep it a tuple so
+# the C arrays are cached on the handle.
+_RESPONSE_INFOS = (
+    CurlInfo.EFFECTIVE_URL,
+    CurlInfo.HTTP_VERSION,
+    CurlInfo.RESPONSE_CODE,
+    CurlInfo.PRIMARY_IP,
+    CurlInfo.PRIMARY_PORT,
+    CurlInfo.LOCAL_IP,
+    CurlInfo.LOCAL_PORT,
+    CurlInfo.TOTAL_TIME,
+    CurlInfo.REDIRECT_COUNT,
+    CurlInfo.REDIRECT_URL,
+    CurlInfo.SIZE_DOWNLOAD_T,
+    CurlInfo.SIZE_UPLOAD_T,
+    CurlInfo.HEADER_SIZE,
+    CurlInfo.REQUEST_SIZE,
+)
+_METERED_RESPONSE_INFOS = _RESPONSE_INFOS + METRIC_INFOS
+
+
 class BaseSession(Generic[R]):
     """Provide common methods for setting curl options and reading info in sessions."""
 
@@ -257,9 +377,17 @@ class BaseSession(Generic[R]):
         discard_cookies: bool = False,
         raise_for_status: bool = False,
         cache: Optional[CacheSpec] = None,
+        share: Union[bool, CurlShare] = False,
+        rate_limit: Optional[RateLimitSpec] = None,
+        metrics: Optional[SessionMetrics] = None,
+        cookie_engine: bool = False,
+        store: Optional[Union[str, os.PathLike[str], PersistentStore]] = None,
     ):
         self.headers = Headers(headers)
-        self._cookies = Cookies(cookies)  # guarded by @property
+        self.cookie_engine = cookie_engine
+        # the cookies of a share given by the user are not ours to clear
+        self._owns_cookie_engine = not isinstance(share, CurlShare)
+        self.cookies = cookies  # type: ignore  # converted by @property
         self.auth = auth
         self.base_url = base_url
         self.params = params
@@ -284,6 +412,36 @@ class BaseSession(Generic[R]):
         self.doh_url = doh_url
         self.cert = cert
         self._cache = normalize_cache_backend(cache)
+        if store is not None and not isinstance(store, PersistentStore):
+            store = PersistentStore(store)
+        # TLS sessions are saved from and loaded into the cache of the share
+        store_tls = store is not None and store.tls_sessions
+        if cookie_engine or store_tls:
+            if not isinstance(share, CurlShare):
+                share = CurlShare(
+                    dns=share, ssl_session=share or store_tls, cookies=cookie_engine
+                )
+            elif cookie_engine and not share.cookies:
+                raise ValueError("`cookie_engine` needs a CurlShare sharing cookies")
+            elif store_tls and not share.ssl_session:
+                raise ValueError("`store` needs a CurlShare sharing TLS sessions")
+        elif share is True:
+            share = CurlShare()
+        self.share: Optional[CurlShare] = share or None
+        self.store: Optional[StoreProfile] = None
+        self._store = store
+        # the profiles used so far, each with the share holding its TLS sessions
+        self._store_profiles: dict[str, tuple[StoreProfile, Optional[CurlShare]]] = {}
+        self._store_lock = threading.Lock()
+        if store is not None:
+            self.store = store.profile(impersonate, ja3, akamai, perk, extra_fp)
+            self._store_profiles[self.store.name] = (self.store, self.share)
+            if self.share is not None:
+                self.store.load_tls_sessions(self.share)
+        self.rate_limiter: Optional[RateLimiter] = (
+            RateLimiter(rate_limit) if rate_limit is not None else None
+        )
+        self.metrics = metrics
 
         if response_class is not None and issubclass(response_class, Response) is False:
             raise TypeError(
@@ -318,129 +476,135 @@ class BaseSession(Generic[R]):
     def _parse_response(
         self,
         curl: Curl,
-        buffer: BytesIO,
-        header_buffer: BytesIO,
+        buffer: Optional[CurlBuffer],
+        header_buffer: CurlHeaderBuffer,
         default_encoding: Union[str, Callable[[bytes], str]],
         discard_cookies: bool,
+        request_url: Optional[str] = None,
     ) -> R:
         c = curl
         rsp = cast(R, self.response_class(c))
-        rsp.url = cast(bytes, c.getinfo(CurlInfo.EFFECTIVE_URL)).decode()
-        if buffer:
+        (
+            effective_url,
+            http_version,
+            status_code,
+            primary_ip,
+            primary_port,
+            local_ip,
+            local_port,
+            total_time,
+            redirect_count,
+            redirect_url_bytes,
+            download_size,
+            upload_size,
+            header_size,
+            request_size,
+            *metric_infos,
+        ) = cast(
+            list[Any],
+            c.getinfo_many(
+                _RESPONSE_INFOS if self.metrics is None else _METERED_RESPONSE_INFOS
+            ),
+        )
+        rsp.url = effective_url.decode()
+        if buffer is not None:
             rsp.content = buffer.getvalue()
-        rsp.http_version = cast(int, c.getinfo(CurlInfo.HTTP_VERSION))
-        rsp.status_code = cast(int, c.getinfo(CurlInfo.RESPONSE_CODE))
+        rsp.http_version = http_version
+        rsp.status_code = status_code
         rsp.ok = 200 <= rsp.status_code < 400
-        header_lines = header_buffer.getvalue().splitlines()
-
-        header_list: list[bytes] = []
-        header_blocks: list[tuple[int, str, list[bytes]]] = []
-        header_status = 0
-        header_reason = ""
-        for header_line in header_lines:
-            if not header_line.strip():
-                continue
-            if header_line.startswith(b"HTTP/"):
-                if header_status:
-                    header_blocks.append((header_status, header_reason, header_list))
-                try:
-                    header_status = int(header_line.split(maxsplit=2)[1])
-                except (IndexError, ValueError):
-                    header_status = 0
-                header_reason = c.get_reason_phrase(header_line).decode(
-                    errors="replace"
-                )
-                # empty header list for new redirected response
-                header_list = []
-                continue
-            if header_line.startswith(b" ") or header_line.startswith(b"\t"):
-                header_list[-1] += header_line
-                continue
-            header_list.append(header_line)
-        if header_status:
-            header_blocks.append((header_status, header_reason, header_list))
-        if header_blocks:
-            _, rsp.reason, header_list = header_blocks[-1]
-        rsp.headers = Headers(header_list)
-
-        redirect_history = cast(list[bytes], c.getinfo(CurlInfo.REDIRECT_HISTORY))
-        block_index = 0
-        for item in redirect_history:
-            try:
-                status_bytes, history_url_bytes = item.split(b"\t", 1)
-                history_status = int(status_bytes)
-            except (TypeError, ValueError):
-                continue
-
-            history_url = history_url_bytes.decode(errors="replace")
-            history_reason = ""
-            history_headers = Headers()
-            for index in range(block_index, len(header_blocks)):
-                status, reason, headers = header_blocks[index]
-                if status == history_status:
-                    history_reason = reason
-                    history_headers = Headers(headers)
-                    block_index = index + 1
-                    break
-
-            history_response = cast(R, self.response_class(None))
-            history_response.url = history_url
-            history_response.status_code = history_status
-            history_response.reason = history_reason
-            history_response.ok = 200 <= history_status < 400
-            history_response.headers = history_headers
-            history_response.default_encoding = default_encoding
-            rsp.history.append(history_response)
-
-        # Response cookies - only from Set-Cookie headers
-        rsp.cookies = Cookies()
-        set_cookie_headers = rsp.headers.get_list("set-cookie")
-        for set_cookie in set_cookie_headers:
-            try:
-                cookie = http.cookies.SimpleCookie()
-                cookie.load(set_cookie)  # type: ignore
-                for name, morsel in cookie.items():
-                    rsp.cookies.set(
-                        name,
-                        morsel.value,
-                        domain=morsel.get("domain", ""),
-                        path=morsel.get("path", "/"),
-                        secure=bool(morsel.get("secure")),
-                    )
-            except Exception:
-                continue
+        # Headers, cookies and history are only built when accessed, most callers
+        # only read the status and the content.
+        redirect_history: list[bytes] = []
+        if redirect_count:
+            redirect_history = cast(list[bytes], c.getinfo(CurlInfo.REDIRECT_HISTORY))
+        rsp._raw = RawResponse(
+            header_buffer.blocks(),
+            redirect_history,
+            self.response_class,
+            default_encoding,
+        )
+        final_block = rsp._raw.final_block()
+        if final_block is not None and final_block[0]:
+            rsp.reason = final_block[1].decode(errors="replace")
 
         # Session cookies - accepted changes from all responses in the transfer
         discard_cookies = discard_cookies or self.discard_cookies
         if not discard_cookies:
             changes = cast(list[bytes], c.getinfo(CurlInfo.COOKIECHANGES))
             self._cookies.update_cookies_from_curl_changes(changes)
+        elif isinstance(self._cookies, CurlCookies):
+            changes = cast(list[bytes], c.getinfo(CurlInfo.COOKIECHANGES))
+            self._cookies.revert_curl_changes(c, changes)
 
-        rsp.primary_ip = cast(bytes, c.getinfo(CurlInfo.PRIMARY_IP)).decode()
-        rsp.primary_port = cast(int, c.getinfo(CurlInfo.PRIMARY_PORT))
-        rsp.local_ip = cast(bytes, c.getinfo(CurlInfo.LOCAL_IP)).decode()
-        rsp.local_port = cast(int, c.getinfo(CurlInfo.LOCAL_PORT))
+        rsp.primary_ip = primary_ip.decode()
+        rsp.primary_port = primary_port
+        rsp.local_ip = local_ip.decode()
+        rsp.local_port = local_port
         rsp.default_encoding = default_encoding
-        rsp.elapsed = timedelta(seconds=cast(float, c.getinfo(CurlInfo.TOTAL_TIME)))
-        rsp.redirect_count = cast(int, c.getinfo(CurlInfo.REDIRECT_COUNT))
-        redirect_url_bytes = cast(bytes, c.getinfo(CurlInfo.REDIRECT_URL))
+        rsp.elapsed = timedelta(seconds=total_time)
+        rsp.redirect_count = redirect_count
         try:
             rsp.redirect_url = redirect_url_bytes.decode()
         except UnicodeDecodeError:
             rsp.redirect_url = redirect_url_bytes.decode("latin-1")
 
-        rsp.download_size = cast(int, c.getinfo(CurlInfo.SIZE_DOWNLOAD_T))
-        rsp.upload_size = cast(int, c.getinfo(CurlInfo.SIZE_UPLOAD_T))
-        rsp.header_size = cast(int, c.getinfo(CurlInfo.HEADER_SIZE))
-        rsp.request_size = cast(int, c.getinfo(CurlInfo.REQUEST_SIZE))
+        rsp.download_size = download_size
+        rsp.upload_size = upload_size
+        rsp.header_size = header_size
+        rsp.request_size = request_size
         rsp.response_size = rsp.download_size + rsp.header_size
 
         # custom info options
-        for info in self.curl_infos:
-            rsp.infos[info] = c.getinfo(info)
+        if self.curl_infos:
+            values = c.getinfo_many(self.curl_infos)
+            rsp.infos.update(zip(self.curl_infos, values))
+
+        if metric_infos:
+            # under the requested origin, like errors and pool waits
+            cast(SessionMetrics, self.metrics).record_response(
+                rsp, metric_infos, origin_of(request_url) if request_url else None
+            )
 
         return rsp
 
+    def _store_for(
+        self,
+        impersonate: Optional[Union[str, Fingerprint]],
+        ja3: Optional[str],
+        akamai: Optional[str],
+        perk: Optional[str],
+        extra_fp: Optional[Union[ExtraFingerprints, ExtraFpDict]],
+    ) -> tuple[Optional[StoreProfile], Optional[CurlShare]]:
+        """The store profile of a request and the share of its TLS sessions, those
+        of the session unless the request has a fingerprint of its own."""
+        if self._store is None:
+            return None, self.share
+        name = profile_name(impersonate, ja3, akamai, perk, extra_fp)
+        with self._store_lock:
+            if name in self._store_profiles:
+                return self._store_profiles[name]
+            profile = self._store.profile(impersonate, ja3, akamai, perk, extra_fp)
+            share = self.share
+            if self._store.tls_sessions:
+                if share is not None and share.cookies:
+                    # a handle has a single share, the cookies can't follow
+                    raise ValueError(
+                        "A request can't override the fingerprint of a session "
+                        "with `store` and `cookie_engine`"
+                    )
+                # never resume the TLS sessions of another fingerprint
+                share = CurlShare(ssl_session=True)
+                profile.load_tls_sessions(share)
+            self._store_profiles[name] = (profile, share)
+        return profile, share
+
+    def _save_store(self) -> None:
+        # after the handles are closed, libcurl writes their Alt-Svc and HSTS files
+        for profile, share in list(self._store_profiles.values()):
+            if share is not None:
+                profile.save_tls_sessions(share)
+            profile.save_files()
+
     def _check_session_closed(self):
         if self._closed:
             raise SessionClosed("Session is closed, cannot send request.")
@@ -461,6 +625,111 @@ class BaseSession(Generic[R]):
             )
         )
 
+    def _store_cached(self, request, response: R, lookup: CacheLookup) -> R:
+        cache = cast(CacheBackend, self._cache)
+        if response.status_code == 304 and lookup.validators:
+            # the stale entry is still valid, serve it instead of the empty 304
+            cached = cache.revalidated(request, response, self.response_class)
+            return cast(R, cached) if cached is not None else response
+        cache.set(request, response)
+        return response
+
+    def _curl_options(
+        self,
+        *,
+        params: Optional[
+            Union[dict[str, object], list[object], tuple[object, ...]]
+        ] = None,
+        headers: Optional[HeaderTypes] = None,
+        cookies: Optional[CookieTypes] = None,
+        auth: Optional[tuple[str, str]] = None,
+        timeout: Optional[Union[float, tuple[float, float], object]] = NOT_SET,
+        allow_redirects: Optional[Union[bool, CurlFollow, str]] = None,
+        max_redirects: Optional[int] = None,
+        proxies: Optional[ProxySpec] = None,
+        proxy_auth: Optional[tuple[str, str]] = None,
+        verify: Optional[bool] = None,
+        impersonate: Optional[Union[BrowserTypeLiteral, str, Fingerprint]] = None,
+        ja3: Optional[str] = None,
+        akamai: Optional[str] = None,
+        perk: Optional[str] = None,
+        extra_fp: Optional[Union[ExtraFingerprints, ExtraFpDict]] = None,
+        default_headers: Optional[bool] = None,
+        http_version: Optional[Union[CurlHttpVersion, HttpVersionLiteral]] = None,
+        interface: Optional[str] = None,
+        doh_url: Optional[str] = None,
+        cert: Optional[Union[str, tuple[str, str]]] = None,
+        **options: Any,
+    ) -> dict[str, Any]:
+        """Arguments of ``set_curl_options`` for the options of a request, the
+        session settings standing in for those it leaves unset."""
+        impersonate = impersonate or self.impersonate
+        ja3 = ja3 or self.ja3
+        akamai = akamai or self.akamai
+        perk = perk or self.perk
+        extra_fp = extra_fp or self.extra_fp
+        store, share = self._store_for(impersonate, ja3, akamai, perk, extra_fp)
+        return dict(
+            params_list=[self.params, params],
+            base_url=self.base_url,
+            headers_list=[self.headers, headers],
+            cookies_list=[self._cookies, cookies],
+            auth=auth or self.auth,
+            timeout=self.timeout if timeout is NOT_SET else timeout,
+            allow_redirects=(
+                self.allow_redirects if allow_redirects is None else allow_redirects
+            ),
+            max_redirects=(
+                self.max_redirects if max_redirects is None else max_redirects
+            ),
+            proxies_list=[self.proxies, proxies],
+            proxy_auth=proxy_auth or self.proxy_auth,
+            verify_list=[self.verify, verify],
+            impersonate=impersonate,
+            ja3=ja3,
+            akamai=akamai,
+            perk=perk,
+            extra_fp=extra_fp,
+            default_headers=(
+                self.default_headers if default_headers is None else default_headers
+            ),
+            http_version=http_version or self.http_version,
+            interface=interface or self.interface,
+            doh_url=doh_url or self.doh_url,
+            cert=cert or self.cert,
+            curl_options=self.curl_options,
+            share=share,
+            store=store,
+            **options,
+        )
+
+    def _host_of(self, url: str) -> str:
+        if self.base_url:
+            url = urljoin(self.base_url, url)
+        return urlparse(url).netloc
+
+    def _origin_of(self, url: str) -> str:
+        if self.base_url:
+            url = urljoin(self.base_url, url)
+        return origin_of(url)
+
+    def _pause_host(self, url: str, error: RequestException) -> bool:
+        """Hold the rate limited host of ``url`` as asked by ``Retry-After``.
+
+        Returns whether the retry is to be delayed by the rate limiter, instead of
+        sleeping on its own.
+        """
+        if self.rate_limiter is None:
+            return False
+        seconds = _retry_after(error)
+        if seconds is None:
+            return False
+        host = self._host_of(url)
+        if self.rate_limiter.limit_for(host) is None:
+            return False
+        self.rate_limiter.pause(host, seconds)
+        return True
+
     def _retry_delay(self, attempt: int) -> float:
         strategy = self.retry
         if strategy.backoff == "exponential":
@@ -478,7 +747,10 @@ class BaseSession(Generic[R]):
     @cookies.setter
     def cookies(self, cookies: CookieTypes) -> None:
         # This ensures that the cookies property is always converted to Cookies.
-        self._cookies = Cookies(cookies)
+        if self.cookie_engine:
+            self._cookies = CurlCookies(cookies, self._owns_cookie_engine)
+        else:
+            self._cookies = Cookies(cookies)
 
 
 class Session(BaseSession[R]):
@@ -537,6 +809,22 @@ class Session(BaseSession[R]):
             response_class: A customized subtype of ``Response`` to use.
             raise_for_status: automatically raise an HTTPError for 4xx and 5xx
                 status codes.
+            share: share the DNS cache and TLS sessions among the curl handles of
+                the session. Pass a ``CurlShare`` to pick what is shared, or to share
+                the caches with other sessions too.
+            rate_limit: a ``RateLimit`` for every host, or a dict of host to
+                ``RateLimit``. Retries of 429 and 503 responses wait for their
+                ``Retry-After`` without holding back the other hosts.
+            metrics: a ``SessionMetrics`` to record the latencies, connection reuse
+                and retries of the requests, for each origin.
+            cookie_engine: keep the cookies in the cookie engine of libcurl, shared
+                by the curl handles of the session, instead of loading the whole jar
+                into curl for every request. ``cookies`` becomes a view updated
+                lazily, see ``CurlCookies``. The cookies already in a ``CurlShare``
+                given as ``share`` are kept.
+            store: a ``PersistentStore``, or its directory, keeping the TLS
+                sessions, Alt-Svc and HSTS entries of the impersonation profile of
+                the session on disk, so that new processes start warm.
 
         Notes:
             This class can be used as a context manager.
@@ -553,6 +841,11 @@ class Session(BaseSession[R]):
         self._use_thread_local_curl = use_thread_local_curl
         self._queue = None
         self._executor = None
+        # idle handles for ``batch``, and the multi handle keeping the connections
+        # between batches, used by one batch at a time
+        self._batch_curls: list[Curl] = []
+        self._batch_multi: Optional[CurlMulti] = None
+        self._batch_lock = threading.Lock()
         if use_thread_local_curl:
             self._local = threading.local()
             if curl:
@@ -595,6 +888,12 @@ class Session(BaseSession[R]):
         """Close the session."""
         self._closed = True
         self.curl.close()
+        while self._batch_curls:
+            self._batch_curls.pop().close()
+        if self._batch_multi is not None:
+            self._batch_multi.close()
+            self._batch_multi = None
+        self._save_store()
 
     @contextmanager
     def stream(
@@ -610,6 +909,177 @@ class Session(BaseSession[R]):
         finally:
             rsp.close()
 
+    def download(
+        self,
+        url: str,
+        path: Union[str, os.PathLike],
+        resume: bool = True,
+        **kwargs: Unpack[StreamRequestParams],
+    ) -> R:
+        """Download ``url`` into the file at ``path``, see ``stream_to``.
+
+        Like ``curl -o``, the body is written whatever the status code is, check it
+        on the returned response.
+
+        Parameters:
+            url: url for the request.
+            path: the file to write, created if needed.
+            resume: continue a partial file with a range request, the file is
+                downloaded again from the start if the server ignores the range.
+        """
+        with open(path, "ab" if resume else "wb") as file:
+            offset = file.tell()
+            try:
+                rsp = self.request("GET", url, stream_to=file, **kwargs)
+            except RequestException as e:
+                if not _range_ignored(e):
+                    raise
+            else:
+                if not _range_stale(rsp, offset):
+                    return rsp
+            file.seek(0)
+            file.truncate()
+            return self.request("GET", url, stream_to=file, **kwargs)
+
+    def batch(
+        self,
+        requests: Iterable[BatchItem],
+        concurrency: int = 10,
+        return_exceptions: bool = False,
+        **kwargs: Unpack[StreamRequestParams],
+    ) -> Generator[Union[R, RequestException], None, None]:
+        """Perform many requests at once from the calling thread.
+
+        The transfers are driven by a ``curl_multi`` handle of the session, no
+        threads or event loop involved, which keeps the connections for the next
+        batch. Responses are yielded as they complete, not in the order of
+        ``requests``, use ``response.request`` to tell them apart. Retries and the
+        response cache are not used here.
+
+        Parameters:
+            requests: urls to GET, or ``(method, url)`` and
+                ``(method, url, params)`` tuples, where ``params`` are the keyword
+                arguments of ``request``, except ``stream``. Consumed lazily.
+            concurrency: max number of transfers running at the same time.
+            return_exceptions: yield the exception of a failed request instead of
+                raising it, which stops the batch.
+            **kwargs: parameters shared by all the requests.
+
+        .. code-block:: python
+
+            with Session() as s:
+                for r in s.batch(urls, concurrency=50):
+                    print(r.request.url, r.status_code)
+        """
+        self._check_session_closed()
+        if concurrency < 1:
+            raise ValueError("concurrency must be at least 1")
+        pending = iter(requests)
+        exhausted = False
+        active: dict[Curl, tuple] = {}
+        shared = self._batch_lock.acquire(blocking=False)
+        if shared:
+            if self._batch_multi is None:
+                self._batch_multi = CurlMulti()
+            multi = self._batch_multi
+        else:
+            # another batch is running, their completions must not mix
+            multi = CurlMulti()
+        try:
+            while True:
+                while not exhausted and len(active) < concurrency:
+                    item = next(pending, None)
+                    if item is None:
+                        exhausted = True
+                        break
+                    if self._batch_curls:
+                        c = self._batch_curls.pop()
+                    else:
+                        c = Curl(debug=self.debug)
+                    try:
+                        active[c] = self._prepare_batch(c, item, kwargs)
+                        multi.add_handle(c)
+                    except BaseException:
+                        active.pop(c, None)
+                        self._release_batch_curl(c)
+                        raise
+                if not active:
+                    break
+                multi.perform()
+                done = multi.info_read()
+                for c, error in done:
+                    req, buffer, header_buffer, default_encoding, discard_cookies = (
+                        active.pop(c)
+                    )
+                    rsp = self._parse_response(
+                        c,
+                        buffer,
+                        header_buffer,
+                        default_encoding,
+                        discard_cookies,
+                        request_url=req.url,
+                    )
+                    rsp.request = req
+                    self._release_batch_curl(c)
+                    result: Union[R, RequestException] = rsp
+                    if isinstance(error, CurlError):
+                        result = code2error(error.code, str(error))(
+                            str(error), error.code, rsp
+                        )
+                    elif error is not None:
+                        raise error
+                    elif self.raise_for_status:
+                        try:
+                            rsp.raise_for_status()
+                        except HTTPError as e:
+                            result = e
+                    if isinstance(result, RequestException) and not return_exceptions:
+                        raise result
+                    yield result
+                if active and not done:
+                    multi.poll()
+        finally:
+            for c in active:
+                multi.remove_handle(c)
+                c.clean_handles_and_buffers()
+                self._release_batch_curl(c)
+            if shared:
+                self._batch_lock.release()
+            else:
+                multi.close()
+
+    def _prepare_batch(
+        self, c: Curl, item: BatchItem, shared: dict[str, Any]
+    ) -> tuple:
+        if isinstance(item, str):
+            method, url, params = "GET", item, {}
+        elif len(item) == 2:
+            (method, url), params = item, {}
+        else:
+            method, url, params = item  # type: ignore[misc]
+        kw = {**shared, **params}
+        if kw.pop("stream", None):
+            raise TypeError("Streaming responses are not supported in batch")
+        kw.setdefault("accept_encoding", "gzip, deflate, br")
+        default_encoding = kw.pop("default_encoding", "utf-8")
+        discard_cookies = kw.pop("discard_cookies", False)
+        req, buffer, header_buffer, _, _, _ = set_curl_options(
+            c,
+            method=method,
+            url=url,
+            **self._curl_options(**kw),
+            queue_class=queue.Queue,
+            event_class=threading.Event,
+        )
+        return req, buffer, header_buffer, default_encoding, discard_cookies
+
+    def _release_batch_curl(self, c: Curl) -> None:
+        if self._closed:
+            c.close()
+        else:
+            c.soft_reset()
+            self._batch_curls.append(c)
+
     def ws_connect(
         self,
         url: str,
@@ -638,7 +1108,7 @@ class Session(BaseSession[R]):
         self._check_session_closed()
 
         curl = self.curl.duphandle()
-        self.curl.reset()
+        self.curl.soft_reset()
 
         ws: WebSocket = WebSocket(
             curl=curl,
@@ -664,6 +1134,31 @@ class Session(BaseSession[R]):
     def upkeep(self) -> int:
         return self.curl.upkeep()
 
+    def _refresh_cache(
+        self,
+        request,
+        lookup: CacheLookup,
+        resend: Optional[Callable[..., R]],
+    ) -> None:
+        """Revalidate a stale response in the background, it is served meanwhile."""
+        cache = cast(CacheBackend, self._cache)
+        if resend is None:
+            cache.finish(request)
+            return
+
+        # finished here only, a second finish could drop the entry of a newer leader
+        revalidate = lookup._replace(response=None, refresh=False, leader=False)
+
+        def refresh():
+            try:
+                resend(cache_lookup=revalidate)
+            except RequestException:
+                pass  # the stale response stays until the next try
+            finally:
+                cache.finish(request)
+
+        self.executor.submit(refresh)
+
     def _request_once(
         self,
         method: HttpMethod,
@@ -702,13 +1197,19 @@ class Session(BaseSession[R]):
         cert: Optional[Union[str, tuple[str, str]]] = None,
         stream: Optional[bool] = None,
         max_recv_speed: int = 0,
+        stream_buffer_size: Optional[int] = None,
+        stream_to: Optional[Union[int, IO[bytes]]] = None,
         multipart: Optional[CurlMime] = None,
         discard_cookies: bool = False,
+        resend: Optional[Callable[..., R]] = None,
+        cache_lookup: Optional[CacheLookup] = None,
     ) -> R:
+        if multipart is not None and multipart._async_readers:
+            raise TypeError("async iterable mime parts need an AsyncSession")
         # clone a new curl instance for streaming response
         if stream:
             c = self.curl.duphandle()
-            _ = self.curl.reset()
+            self.curl.soft_reset()
         else:
             c = self.curl
 
@@ -716,139 +1217,175 @@ class Session(BaseSession[R]):
             c,
             method=method,
             url=url,
-            params_list=[self.params, params],
-            base_url=self.base_url,
-            data=data,
-            content=content,
-            json=json,
-            headers_list=[self.headers, headers],
-            cookies_list=[self._cookies, cookies],
-            files=files,
-            auth=auth or self.auth,
-            timeout=self.timeout if timeout is NOT_SET else timeout,
-            allow_redirects=(
-                self.allow_redirects if allow_redirects is None else allow_redirects
-            ),
-            max_redirects=(
-                self.max_redirects if max_redirects is None else max_redirects
-            ),
-            proxies_list=[self.proxies, proxies],
-            proxy=proxy,
-            proxy_auth=proxy_auth or self.proxy_auth,
-            verify_list=[self.verify, verify],
-            referer=referer,
-            accept_encoding=accept_encoding,
-            content_callback=content_callback,
-            impersonate=impersonate or self.impersonate,
-            ja3=ja3 or self.ja3,
-            akamai=akamai or self.akamai,
-            perk=perk or self.perk,
-            extra_fp=extra_fp or self.extra_fp,
-            default_headers=(
-                self.default_headers if default_headers is None else default_headers
+            **self._curl_options(
+                params=params,
+                data=data,
+                content=content,
+                json=json,
+                headers=headers,
+                cookies=cookies,
+                files=files,
+                auth=auth,
+                timeout=timeout,
+                allow_redirects=allow_redirects,
+                max_redirects=max_redirects,
+                proxies=proxies,
+                proxy=proxy,
+                proxy_auth=proxy_auth,
+                verify=verify,
+                referer=referer,
+                accept_encoding=accept_encoding,
+                content_callback=content_callback,
+                impersonate=impersonate,
+                ja3=ja3,
+                akamai=akamai,
+                perk=perk,
+                extra_fp=extra_fp,
+                default_headers=default_headers,
+                quote=quote,
+                http_version=http_version,
+                interface=interface,
+                doh_url=doh_url,
+                stream=stream,
+                max_recv_speed=max_recv_speed,
+                stream_buffer_size=stream_buffer_size,
+                stream_to=stream_to,
+                multipart=multipart,
+                cert=cert,
             ),
-            quote=quote,
-            http_version=http_version or self.http_version,
-            interface=interface or self.interface,
-            doh_url=doh_url or self.doh_url,
-            stream=stream,
-            max_recv_speed=max_recv_speed,
-            multipart=multipart,
-            cert=cert or self.cert,
-            curl_options=self.curl_options,
             queue_class=queue.Queue,
             event_class=threading.Event,
+            ring_queue_class=_RingQueue,
         )
 
-        if self._cache_enabled(req, stream=stream, content_callback=content_callback):
-            cached_response = self._cache.get(
+        # a body written to a file is never cached, just like a streamed one
+        streamed = stream or stream_to is not None
+        if cache_lookup is None and self._cache_enabled(
+            req, stream=streamed, content_callback=content_callback
+        ):
+            cache_lookup = self._cache.lookup(  # type: ignore[union-attr]
                 req,
                 response_class=self.response_class,
-            )  # type: ignore[union-attr]
+            )
+            cached_response = cache_lookup.response
             if cached_response is not None:
+                if cache_lookup.refresh:
+                    self._refresh_cache(req, cache_lookup, resend)
                 if not (discard_cookies or self.discard_cookies):
                     self._cookies.update(cached_response.cookies)
                 if self.raise_for_status:
                     cached_response.raise_for_status()
-                c.reset()
+                c.soft_reset()
                 return cast(R, cached_response)
+        # the leader of a lookup finishes it, even when failing before the transfer
+        try:
+            if cache_lookup is not None and cache_lookup.validators:
+                validators = cache_lookup.validators.items()
+                c.setopt(
+                    CurlOpt.HTTPHEADER, [f"{k}: {v}".encode() for k, v in validators]
+                )
 
-        if stream:
+            if stream:
+
+                def perform():
+                    try:
+                        if isinstance(q, _RingQueue):
+                            c.perform_ring(q.ring, q.wakeup)
+                        else:
+                            c.perform()
+                    except CurlError as e:
+                        rsp = self._parse_response(
+                            c,
+                            buffer,
+                            header_buffer,
+                            default_encoding,
+                            discard_cookies,
+                            request_url=req.url,
+                        )
+                        rsp.request = req
+                        error = code2error(e.code, str(e))
+                        q.put_nowait(error(str(e), e.code, rsp))  # type: ignore
+                    finally:
+                        if not cast(threading.Event, header_recved).is_set():
+                            cast(threading.Event, header_recved).set()
+                        q.put(STREAM_END)  # type: ignore
+
+                stream_task = self.executor.submit(perform)
+
+                # Wait for the first chunk
+                header_recved.wait()  # type: ignore
+                rsp = self._parse_response(
+                    c,
+                    buffer,
+                    header_buffer,
+                    default_encoding,
+                    discard_cookies,
+                    request_url=req.url,
+                )
+
+                # Raise the exception if something went wrong receiving the header.
+                first_element = _peek_queue(q)  # type: ignore
+                if isinstance(first_element, RequestException):
+                    if quit_now:
+                        quit_now.set()
+                    stream_task.result()
+                    c.close()
+                    raise first_element
 
-            def perform():
+                rsp.request = req
+                rsp.stream_task = stream_task
+                rsp.quit_now = quit_now
+                rsp.queue = q
+                if self.raise_for_status:
+                    rsp.raise_for_status()
+                return rsp
+            else:
                 try:
-                    c.perform()
+                    if self._thread == "eventlet":
+                        # see: https://eventlet.net/doc/threading.html
+                        import eventlet.tpool
+
+                        eventlet.tpool.execute(c.perform)  # type: ignore
+                    elif self._thread == "gevent":
+                        # see: https://www.gevent.org/api/gevent.threadpool.html
+                        import gevent
+
+                        hub = gevent.get_hub()
+                        hub.threadpool.spawn(c.perform).get()  # type: ignore
+                    else:
+                        c.perform()
                 except CurlError as e:
                     rsp = self._parse_response(
-                        c, buffer, header_buffer, default_encoding, discard_cookies
+                        c,
+                        buffer,
+                        header_buffer,
+                        default_encoding,
+                        discard_cookies,
+                        request_url=req.url,
                     )
                     rsp.request = req
                     error = code2error(e.code, str(e))
-                    q.put_nowait(error(str(e), e.code, rsp))  # type: ignore
-                finally:
-                    if not cast(threading.Event, header_recved).is_set():
-                        cast(threading.Event, header_recved).set()
-                    q.put(STREAM_END)  # type: ignore
-
-            stream_task = self.executor.submit(perform)
-
-            # Wait for the first chunk
-            header_recved.wait()  # type: ignore
-            rsp = self._parse_response(
-                c, buffer, header_buffer, default_encoding, discard_cookies
-            )
-
-            # Raise the exception if something wrong happens when receiving the header.
-            first_element = _peek_queue(q)  # type: ignore
-            if isinstance(first_element, RequestException):
-                if quit_now:
-                    quit_now.set()
-                stream_task.result()
-                c.close()
-                raise first_element
-
-            rsp.request = req
-            rsp.stream_task = stream_task
-            rsp.quit_now = quit_now
-            rsp.queue = q
-            if self.raise_for_status:
-                rsp.raise_for_status()
-            return rsp
-        else:
-            try:
-                if self._thread == "eventlet":
-                    # see: https://eventlet.net/doc/threading.html
-                    import eventlet.tpool
-
-                    eventlet.tpool.execute(c.perform)  # type: ignore
-                elif self._thread == "gevent":
-                    # see: https://www.gevent.org/api/gevent.threadpool.html
-                    import gevent
-
-                    gevent.get_hub().threadpool.spawn(c.perform).get()  # type: ignore
+                    raise error(str(e), e.code, rsp) from e
                 else:
-                    c.perform()
-            except CurlError as e:
-                rsp = self._parse_response(
-                    c, buffer, header_buffer, default_encoding, discard_cookies
-                )
-                rsp.request = req
-                error = code2error(e.code, str(e))
-                raise error(str(e), e.code, rsp) from e
-            else:
-                rsp = self._parse_response(
-                    c, buffer, header_buffer, default_encoding, discard_cookies
-                )
-                rsp.request = req
-                if self._cache_enabled(
-                    req, stream=stream, content_callback=content_callback
-                ):
-                    self._cache.set(req, rsp)  # type: ignore[union-attr]
-                if self.raise_for_status:
-                    rsp.raise_for_status()
-                return rsp
-            finally:
-                c.reset()
+                    rsp = self._parse_response(
+                        c,
+                        buffer,
+                        header_buffer,
+                        default_encoding,
+                        discard_cookies,
+                        request_url=req.url,
+                    )
+                    rsp.request = req
+                    if cache_lookup is not None:
+                        rsp = self._store_cached(req, rsp, cache_lookup)
+                    if self.raise_for_status:
+                        rsp.raise_for_status()
+                    return rsp
+                finally:
+                    c.soft_reset()
+        finally:
+            if cache_lookup is not None and cache_lookup.leader:
+                self._cache.finish(req)  # type: ignore[union-attr]
 
     def request(
         self,
@@ -886,6 +1423,8 @@ class Session(BaseSession[R]):
         cert: Optional[Union[str, tuple[str, str]]] = None,
         stream: Optional[bool] = None,
         max_recv_speed: int = 0,
+        stream_buffer_size: Optional[int] = None,
+        stream_to: Optional[Union[int, IO[bytes]]] = None,
         multipart: Optional[CurlMime] = None,
         discard_cookies: bool = False,
     ):
@@ -895,52 +1434,65 @@ class Session(BaseSession[R]):
 
         body = content if content is not None else data
         body_position = _capture_body_position(data, content)
+        send = partial(
+            self._request_once,
+            method=method,
+            url=url,
+            params=params,
+            data=data,
+            content=content,
+            json=json,
+            headers=headers,
+            cookies=cookies,
+            files=files,
+            auth=auth,
+            timeout=timeout,
+            allow_redirects=allow_redirects,
+            max_redirects=max_redirects,
+            proxies=proxies,
+            proxy=proxy,
+            proxy_auth=proxy_auth,
+            verify=verify,
+            referer=referer,
+            accept_encoding=accept_encoding,
+            content_callback=content_callback,
+            impersonate=impersonate,
+            ja3=ja3,
+            akamai=akamai,
+            perk=perk,
+            extra_fp=extra_fp,
+            default_headers=default_headers,
+            default_encoding=default_encoding,
+            quote=quote,
+            http_version=http_version,
+            interface=interface,
+            doh_url=doh_url,
+            cert=cert,
+            stream=stream,
+            max_recv_speed=max_recv_speed,
+            stream_buffer_size=stream_buffer_size,
+            stream_to=stream_to,
+            multipart=multipart,
+            discard_cookies=discard_cookies,
+        )
         strategy = self.retry
         for attempt in range(strategy.count + 1):
             if attempt > 0:
                 _rewind_body(body, body_position)
+            if self.rate_limiter is not None:
+                delay = self.rate_limiter.reserve(self._host_of(url))
+                if delay:
+                    time.sleep(delay)
             try:
-                return self._request_once(
-                    method=method,
-                    url=url,
-                    params=params,
-                    data=data,
-                    content=content,
-                    json=json,
-                    headers=headers,
-                    cookies=cookies,
-                    files=files,
-                    auth=auth,
-                    timeout=timeout,
-                    allow_redirects=allow_redirects,
-                    max_redirects=max_redirects,
-                    proxies=proxies,
-                    proxy=proxy,
-                    proxy_auth=proxy_auth,
-                    verify=verify,
-                    referer=referer,
-                    accept_encoding=accept_encoding,
-                    content_callback=content_callback,
-                    impersonate=impersonate,
-                    ja3=ja3,
-                    akamai=akamai,
-                    perk=perk,
-                    extra_fp=extra_fp,
-                    default_headers=default_headers,
-                    default_encoding=default_encoding,
-                    quote=quote,
-                    http_version=http_version,
-                    interface=interface,
-                    doh_url=doh_url,
-                    cert=cert,
-                    stream=stream,
-                    max_recv_speed=max_recv_speed,
-                    multipart=multipart,
-                    discard_cookies=discard_cookies,
-                )
-            except RequestException:
+                return send(resend=send)
+            except RequestException as e:
+                if self.metrics is not None:
+                    retried = attempt < strategy.count
+                    self.metrics.record_error(self._origin_of(url), retried)
                 if attempt == strategy.count:
                     raise
+                if self._pause_host(url, e):
+                    continue
                 delay = self._retry_delay(attempt + 1)
                 if delay:
                     time.sleep(delay)
@@ -982,6 +1534,16 @@ class AsyncSession(BaseSession[R]):
         loop: asyncio.AbstractEventLoop | None = None,
         async_curl: AsyncCurl | None = None,
         max_clients: int = 10,
+        min_clients: int = 0,
+        max_clients_per_host: Optional[int] = None,
+        idle_timeout: Optional[float] = None,
+        warmup_urls: Optional[Iterable[str]] = None,
+        hedge: Optional[HedgeStrategy] = None,
+        adaptive_timeout: Optional[AdaptiveTimeout] = None,
+        multiplex: bool = True,
+        max_connections: Optional[int] = None,
+        max_host_connections: Optional[int] = None,
+        max_concurrent_streams: Optional[int] = None,
         **kwargs: Unpack[BaseSessionParams[R]],
     ) -> None:
         """
@@ -993,6 +1555,26 @@ class AsyncSession(BaseSession[R]):
             async_curl: [AsyncCurl](/api/curl_cffi#curl_cffi.AsyncCurl) object to use.
             max_clients: maxmium curl handle to use in the session,
                 this will affect the concurrency ratio.
+            min_clients: curl handles kept alive even when idle, they are created by
+                ``warmup``.
+            max_clients_per_host: maxmium curl handle to use for one host at once,
+                requests to a busy host wait without holding back other hosts.
+            idle_timeout: seconds after which an idle curl handle is closed, down to
+                ``min_clients`` handles. Idle handles are never closed if None.
+            warmup_urls: urls to open connections to when entering ``async with``,
+                see ``warmup``.
+            hedge: send a duplicate of the requests slower than most requests to
+                their host, see ``HedgeStrategy``.
+            adaptive_timeout: derive the timeouts from the observed latencies of
+                each host, see ``AdaptiveTimeout``.
+            multiplex: send concurrent requests to one origin as HTTP/2 or HTTP/3
+                streams of one connection. Requests to origins not known to be
+                HTTP/1.x wait for such a connection instead of opening their own,
+                see ``ConnectionTracker`` and ``connection_stats``.
+            max_connections: max connections open at once, for all origins.
+            max_host_connections: max connections open at once to one origin.
+            max_concurrent_streams: max streams multiplexed on one HTTP/2
+                connection, libcurl defaults to 100.
             headers: headers to use in the session.
             cookies: cookies to add in the session.
             auth: HTTP basic auth, a tuple of (username, password), only basic auth is
@@ -1026,6 +1608,22 @@ class AsyncSession(BaseSession[R]):
             response_class: A customized subtype of ``Response`` to use.
             raise_for_status: automatically raise an HTTPError for 4xx and 5xx
                 status codes.
+            share: share the DNS cache and TLS sessions among the curl handles of
+                the session. Pass a ``CurlShare`` to pick what is shared, or to share
+                the caches with other sessions too.
+            rate_limit: a ``RateLimit`` for every host, or a dict of host to
+                ``RateLimit``. Retries of 429 and 503 responses wait for their
+                ``Retry-After`` without holding back the other hosts.
+            metrics: a ``SessionMetrics`` to record the latencies, connection reuse
+                and retries of the requests, for each origin.
+            cookie_engine: keep the cookies in the cookie engine of libcurl, shared
+                by the curl handles of the session, instead of loading the whole jar
+                into curl for every request. ``cookies`` becomes a view updated
+                lazily, see ``CurlCookies``. The cookies already in a ``CurlShare``
+                given as ``share`` are kept.
+            store: a ``PersistentStore``, or its directory, keeping the TLS
+                sessions, Alt-Svc and HSTS entries of the impersonation profile of
+                the session on disk, so that new processes start warm.
 
         Notes:
             This class can be used as a context manager, and it's recommended to use via
@@ -1042,17 +1640,34 @@ class AsyncSession(BaseSession[R]):
 
             s = AsyncSession()  # it also works.
         """
-        if kwargs.get("cache") is not None:
-            raise NotImplementedError(
-                "AsyncSession does not support cache yet because CacheBackend I/O "
-                "is blocking."
-            )
-
         super().__init__(**kwargs)
         self._loop: asyncio.AbstractEventLoop | None = loop
+        # background revalidations of stale cached responses
+        self._cache_tasks: set[asyncio.Task[None]] = set()
         self._acurl: AsyncCurl | None = async_curl
         self._owns_acurl: bool = async_curl is None
         self.max_clients: int = max_clients
+        self.min_clients: int = min_clients
+        self.max_clients_per_host: Optional[int] = max_clients_per_host
+        self.idle_timeout: Optional[float] = idle_timeout
+        self.warmup_urls: list[str] = list(warmup_urls or [])
+        self.hedge = hedge
+        self.adaptive_timeout = adaptive_timeout
+        # latencies are only tracked when something uses them
+        self.latencies: Optional[LatencyTracker] = (
+            LatencyTracker()
+            if hedge is not None or adaptive_timeout is not None
+            else None
+        )
+        self.multiplex = multiplex
+        self.max_connections = max_connections
+        self.max_host_connections = max_host_connections
+        self.max_concurrent_streams = max_concurrent_streams
+        self.connections: Optional[ConnectionTracker] = (
+            ConnectionTracker() if multiplex else None
+        )
+        if async_curl is not None:
+            self._configure_acurl(async_curl)
         self.init_pool()
 
     @property
@@ -1066,27 +1681,92 @@ class AsyncSession(BaseSession[R]):
     def acurl(self) -> AsyncCurl:
         if self._acurl is None:
             self._acurl = AsyncCurl(loop=self.loop)
+            self._configure_acurl(self._acurl)
         return self._acurl
 
+    def _configure_acurl(self, acurl: AsyncCurl) -> None:
+        options = (
+            (CurlMOpt.PIPELINING, None if self.multiplex else CURLPIPE_NOTHING),
+            (CurlMOpt.MAX_TOTAL_CONNECTIONS, self.max_connections),
+            (CurlMOpt.MAX_HOST_CONNECTIONS, self.max_host_connections),
+            (CurlMOpt.MAX_CONCURRENT_STREAMS, self.max_concurrent_streams),
+        )
+        for option, value in options:
+            if value is not None:
+                acurl._check_error(acurl.setopt(option, value), "setopt", option)
+
+    def connection_stats(self) -> list[ConnectionStats]:
+        """The streams carried by each connection of the session, those with
+        streams running first. Empty without ``multiplex``."""
+        if self.connections is None:
+            return []
+        running = self._acurl.handles() if self._acurl is not None else []
+        return self.connections.snapshot(running)
+
+    def _record_connection(self, curl: Curl) -> None:
+        if self.connections is not None:
+            self.connections.record(curl)
+
     def init_pool(self):
-        self.pool: asyncio.LifoQueue[Curl | None] = asyncio.LifoQueue(self.max_clients)
-        while True:
-            try:
-                self.pool.put_nowait(None)
-            except asyncio.QueueFull:
-                break
+        self.pool: CurlPool = CurlPool(
+            lambda: Curl(cacert=self.acurl._cacert, debug=self.debug),
+            max_size=self.max_clients,
+            min_size=self.min_clients,
+            idle_timeout=self.idle_timeout,
+            max_per_host=self.max_clients_per_host,
+            limiter=self.rate_limiter,
+        )
 
-    async def pop_curl(self) -> Curl:
-        curl: Curl | None = await self.pool.get()
-        if curl is None:
-            curl = Curl(cacert=self.acurl._cacert, debug=self.debug)
-        return curl
+    def _pool_host(self, url: str) -> Optional[str]:
+        # only needed for the per host limits, skip the parsing otherwise
+        if self.max_clients_per_host is None and self.rate_limiter is None:
+            return None
+        return self._host_of(url)
+
+    async def pop_curl(self, host: Optional[str] = None, priority: int = 0) -> Curl:
+        return await self.pool.acquire(host, priority)
 
     def push_curl(self, curl: Curl | None) -> None:
-        with suppress(asyncio.QueueFull):
-            self.pool.put_nowait(curl)
+        """Give back a curl handle, or the slot of a closed one with None."""
+        if curl is None:
+            self.pool.discard()
+        else:
+            self.pool.release(curl)
+
+    def discard_curl(self, curl: Curl) -> None:
+        """Give back the slot of a curl handle that is not reusable."""
+        self.pool.discard(curl)
+
+    def pool_stats(self) -> PoolStats:
+        """Utilization of the curl handle pool and the time spent waiting for it."""
+        return self.pool.stats()
+
+    async def warmup(
+        self, urls: Optional[Iterable[str]] = None, connections: int = 1
+    ) -> list[Union[R, BaseException]]:
+        """Create the ``min_clients`` curl handles and open connections ahead of the
+        first requests.
+
+        A ``HEAD`` request is sent to each url, with the options of the session, so
+        that the DNS entries, TLS sessions and connections are cached for the
+        requests that follow.
+
+        Parameters:
+            urls: urls to connect to, defaults to ``warmup_urls``.
+            connections: connections to open to each url.
+
+        Returns:
+            The response or the error of each warm-up request, errors are not raised.
+        """
+        self._check_session_closed()
+        self.pool.fill()
+        urls = self.warmup_urls if urls is None else list(urls)
+        coros = [self.request("HEAD", url) for url in urls for _ in range(connections)]
+        return list(await asyncio.gather(*coros, return_exceptions=True))
 
     async def __aenter__(self):  # TODO: -> Self
+        if self.warmup_urls:
+            await self.warmup()
         return self
 
     async def __aexit__(self, *args) -> None:
@@ -1095,16 +1775,15 @@ class AsyncSession(BaseSession[R]):
 
     async def close(self) -> None:
         """Close the session."""
+        for task in self._cache_tasks:
+            task.cancel()
+        if self._cache is not None:
+            await self._cache.aflush()
         if self._owns_acurl:
             await self.acurl.close()
         self._closed = True
-        while True:
-            try:
-                curl = self.pool.get_nowait()
-                if curl:
-                    curl.close()
-            except asyncio.QueueEmpty:
-                break
+        self.pool.close()
+        self._save_store()
 
     async def upkeep(self) -> list[int]:
         """
@@ -1119,16 +1798,8 @@ class AsyncSession(BaseSession[R]):
         """
         self._check_session_closed()
 
-        pooled_curls = []
-        tasks = []
-        while True:
-            try:
-                curl = self.pool.get_nowait()
-            except asyncio.QueueEmpty:
-                break
-            pooled_curls.append(curl)
-            if curl:
-                tasks.append(self.loop.run_in_executor(None, curl.upkeep))
+        pooled_curls = self.pool.take_idle()
+        tasks = [self.loop.run_in_executor(None, curl.upkeep) for curl in pooled_curls]
 
         try:
             return list(await asyncio.gather(*tasks))
@@ -1140,7 +1811,7 @@ class AsyncSession(BaseSession[R]):
         curl.clean_handles_and_buffers()
         if not self._closed:
             self.acurl.remove_handle(curl)
-            curl.reset()
+            curl.soft_reset()
             self.push_curl(curl)
         else:
             curl.close()
@@ -1159,6 +1830,28 @@ class AsyncSession(BaseSession[R]):
         finally:
             await rsp.aclose()
 
+    async def download(
+        self,
+        url: str,
+        path: Union[str, os.PathLike],
+        resume: bool = True,
+        **kwargs: Unpack[StreamRequestParams],
+    ) -> R:
+        """Download ``url`` into the file at ``path``, see ``Session.download``."""
+        with open(path, "ab" if resume else "wb") as file:
+            offset = file.tell()
+            try:
+                rsp = await self.request("GET", url, stream_to=file, **kwargs)
+            except RequestException as e:
+                if not _range_ignored(e):
+                    raise
+            else:
+                if not _range_stale(rsp, offset):
+                    return rsp
+            file.seek(0)
+            file.truncate()
+            return await self.request("GET", url, stream_to=file, **kwargs)
+
     def ws_connect(
         self,
         url: str,
@@ -1198,6 +1891,8 @@ class AsyncSession(BaseSession[R]):
         max_message_size: int = 4 * 1024 * 1024,
         drain_on_error: bool = False,
         block_on_recv_queue_full: bool = True,
+        zero_copy: bool = False,
+        recv_buffer_size: int = 128 * 1024,
         curl_options: dict[CurlOpt, str] | None = None,
     ) -> AsyncWebSocketContext:
         """Connects to a WebSocket.
@@ -1269,13 +1964,26 @@ class AsyncSession(BaseSession[R]):
                 is failed immediately when the receive queue is full. The message that
                 caused the overflow is not delivered; any messages already buffered may
                 still be drained if ``drain_on_error=True``.
+            zero_copy: receive the messages straight into shared buffers and return
+                them as read-only memoryviews instead of bytes. A memoryview keeps
+                its whole buffer alive, copy the messages kept for long.
+            recv_buffer_size: size of the buffers the frames are received into,
+                larger ones take fewer calls into libcurl for large messages.
             curl_options: extra curl options to use.
         """
 
         async def _connect_coro() -> AsyncWebSocket:
             self._check_session_closed()
 
-            curl: Curl = await self.pop_curl()
+            curl: Curl = await self.pop_curl(self._pool_host(url))
+            fingerprint = (
+                impersonate or self.impersonate,
+                ja3 or self.ja3,
+                akamai or self.akamai,
+                perk,
+                extra_fp or self.extra_fp,
+            )
+            store, share = self._store_for(*fingerprint)
             _ = set_curl_options(
                 curl=curl,
                 method="GET",
@@ -1298,10 +2006,10 @@ class AsyncSession(BaseSession[R]):
                 verify_list=[self.verify, verify],
                 referer=referer,
                 accept_encoding=accept_encoding,
-                impersonate=impersonate or self.impersonate,
-                ja3=ja3 or self.ja3,
-                akamai=akamai or self.akamai,
-                extra_fp=extra_fp or self.extra_fp,
+                impersonate=fingerprint[0],
+                ja3=fingerprint[1],
+                akamai=fingerprint[2],
+                extra_fp=fingerprint[4],
                 default_headers=(
                     self.default_headers if default_headers is None else default_headers
                 ),
@@ -1314,6 +2022,8 @@ class AsyncSession(BaseSession[R]):
                 queue_class=asyncio.Queue,
                 event_class=asyncio.Event,
                 curl_options=curl_options,
+                share=share,
+                store=store,
                 perk=perk,
             )
             _ = curl.setopt(CurlOpt.TCP_NODELAY, 1)
@@ -1326,7 +2036,7 @@ class AsyncSession(BaseSession[R]):
                 _ = await self.loop.run_in_executor(None, curl.perform)
             except Exception:
                 curl.close()
-                self.push_curl(None)
+                self.discard_curl(curl)
                 raise
 
             ws: AsyncWebSocket = AsyncWebSocket(
@@ -1343,6 +2053,8 @@ class AsyncSession(BaseSession[R]):
                 max_message_size=max_message_size,
                 drain_on_error=drain_on_error,
                 block_on_recv_queue_full=block_on_recv_queue_full,
+                zero_copy=zero_copy,
+                recv_buffer_size=recv_buffer_size,
                 debug=self.debug,
             )
 
@@ -1392,146 +2104,224 @@ class AsyncSession(BaseSession[R]):
         cert: Optional[Union[str, tuple[str, str]]] = None,
         stream: Optional[bool] = None,
         max_recv_speed: int = 0,
+        stream_buffer_size: Optional[int] = None,
+        stream_to: Optional[Union[int, IO[bytes]]] = None,
         multipart: Optional[CurlMime] = None,
         discard_cookies: bool = False,
+        priority: int = 0,
+        resend: Optional[Callable[..., Awaitable[R]]] = None,
+        cache_lookup: Optional[CacheLookup] = None,
     ) -> R:
-        curl = await self.pop_curl()
-        async_reader: _AsyncIterableReader | None = None
+        start = time.monotonic() if self.metrics is not None else 0.0
+        curl = await self.pop_curl(self._pool_host(url), priority)
+        if self.metrics is not None:
+            wait = time.monotonic() - start
+            self.metrics.record_pool_wait(self._origin_of(url), wait)
+        async_readers: list[_AsyncIterableReader] = []
         request_content = content
         if isinstance(content, AsyncIterable):
             async_reader = _AsyncIterableReader(content, curl)
+            async_readers.append(async_reader)
             request_content = cast(SyncRequestContent, async_reader)
+        if multipart is not None:
+            # async parts resume the transfer of this handle
+            for async_reader in multipart._async_readers:
+                async_reader._curl = curl
+                async_readers.append(async_reader)
         try:
             req, buffer, header_buffer, q, header_recved, quit_now = set_curl_options(
                 curl=curl,
                 method=method,
                 url=url,
-                params_list=[self.params, params],
-                base_url=self.base_url,
-                data=data,
-                content=request_content,
-                json=json,
-                headers_list=[self.headers, headers],
-                cookies_list=[self.cookies, cookies],
-                files=files,
-                auth=auth or self.auth,
-                timeout=self.timeout if timeout is NOT_SET else timeout,
-                allow_redirects=(
-                    self.allow_redirects if allow_redirects is None else allow_redirects
-                ),
-                max_redirects=(
-                    self.max_redirects if max_redirects is None else max_redirects
-                ),
-                proxies_list=[self.proxies, proxies],
-                proxy=proxy,
-                proxy_auth=proxy_auth or self.proxy_auth,
-                verify_list=[self.verify, verify],
-                referer=referer,
-                accept_encoding=accept_encoding,
-                content_callback=content_callback,
-                impersonate=impersonate or self.impersonate,
-                ja3=ja3 or self.ja3,
-                akamai=akamai or self.akamai,
-                perk=perk or self.perk,
-                extra_fp=extra_fp or self.extra_fp,
-                default_headers=(
-                    self.default_headers if default_headers is None else default_headers
+                **self._curl_options(
+                    params=params,
+                    data=data,
+                    content=request_content,
+                    json=json,
+                    headers=headers,
+                    cookies=cookies,
+                    files=files,
+                    auth=auth,
+                    timeout=timeout,
+                    allow_redirects=allow_redirects,
+                    max_redirects=max_redirects,
+                    proxies=proxies,
+                    proxy=proxy,
+                    proxy_auth=proxy_auth,
+                    verify=verify,
+                    referer=referer,
+                    accept_encoding=accept_encoding,
+                    content_callback=content_callback,
+                    impersonate=impersonate,
+                    ja3=ja3,
+                    akamai=akamai,
+                    perk=perk,
+                    extra_fp=extra_fp,
+                    default_headers=default_headers,
+                    quote=quote,
+                    http_version=http_version,
+                    interface=interface,
+                    doh_url=doh_url,
+                    stream=stream,
+                    max_recv_speed=max_recv_speed,
+                    stream_buffer_size=stream_buffer_size,
+                    stream_to=stream_to,
+                    multipart=multipart,
+                    cert=cert,
                 ),
-                quote=quote,
-                http_version=http_version or self.http_version,
-                interface=interface or self.interface,
-                doh_url=doh_url or self.doh_url,
-                stream=stream,
-                max_recv_speed=max_recv_speed,
-                multipart=multipart,
-                cert=cert or self.cert,
-                curl_options=self.curl_options,
                 queue_class=asyncio.Queue,
                 event_class=asyncio.Event,
+                ring_queue_class=_AsyncRingQueue,
             )
+            if self.connections is not None and self.connections.pipewait(
+                req.url, http_version or self.http_version
+            ):
+                curl.setopt(CurlOpt.PIPEWAIT, 1)
+            # a body written to a file is never cached, just like a streamed one
+            streamed = stream or stream_to is not None
+            if cache_lookup is None and self._cache_enabled(
+                req, stream=streamed, content_callback=content_callback
+            ):
+                cache_lookup = await self._cache.alookup(  # type: ignore[union-attr]
+                    req,
+                    response_class=self.response_class,
+                )
         # Catch BaseException so asyncio.CancelledError also returns the handle.
         except BaseException:
             self.release_curl(curl)
             raise
-        if async_reader is not None:
-            async_reader.start()
-        if stream:
-            task = self.acurl.add_handle(curl)
-            curl_released = False
+        if cache_lookup is not None:
+            cached_response = cache_lookup.response
+            if cached_response is not None:
+                self.release_curl(curl)
+                if cache_lookup.refresh:
+                    self._refresh_cache(req, cache_lookup, resend)
+                if not (discard_cookies or self.discard_cookies):
+                    self._cookies.update(cached_response.cookies)
+                if self.raise_for_status:
+                    cached_response.raise_for_status()
+                return cast(R, cached_response)
+        # the leader of a lookup finishes it, even when failing before the transfer
+        try:
+            try:
+                if cache_lookup is not None and cache_lookup.validators:
+                    validators = cache_lookup.validators.items()
+                    curl.setopt(
+                        CurlOpt.HTTPHEADER,
+                        [f"{k}: {v}".encode() for k, v in validators],
+                    )
+                for async_reader in async_readers:
+                    async_reader.start()
+            except BaseException:
+                self.release_curl(curl)
+                raise
+            if stream:
+                wakeup = q.wakeup if isinstance(q, _AsyncRingQueue) else None
+                task = self.acurl.add_handle(curl, wakeup=wakeup)
+                curl_released = False
+
+                async def perform() -> None:
+                    try:
+                        await task
+                        self._record_connection(curl)
+                    except CurlError as e:
+                        self._record_connection(curl)
+                        rsp = self._parse_response(
+                            curl,
+                            buffer,
+                            header_buffer,
+                            default_encoding,
+                            discard_cookies,
+                            request_url=req.url,
+                        )
+                        rsp.request = req
+                        error = code2error(e.code, str(e))
+                        q.put_nowait(error(str(e), e.code, rsp))  # type: ignore
+                    finally:
+                        for async_reader in async_readers:
+                            await async_reader.close()
+                        if not cast(asyncio.Event, header_recved).is_set():
+                            cast(asyncio.Event, header_recved).set()
+                        await q.put(STREAM_END)  # type: ignore
+
+                def cleanup(fut):
+                    nonlocal curl_released
+                    if not curl_released:
+                        self.release_curl(curl)
+                    curl_released = True
+
+                stream_task = asyncio.create_task(perform())
+                stream_task.add_done_callback(cleanup)
+
+                await cast(asyncio.Event, header_recved).wait()
+
+                # Unlike threads, coroutines does not use preemptive scheduling.
+                # For asyncio, there is no need for a header_parsed event, the
+                # _parse_response will execute in the foreground, no background tasks
+                # running.
+                rsp = self._parse_response(
+                    curl,
+                    buffer,
+                    header_buffer,
+                    default_encoding,
+                    discard_cookies,
+                    request_url=req.url,
+                )
 
-            async def perform() -> None:
+                first_element = _peek_aio_queue(q)  # type: ignore
+                if isinstance(first_element, RequestException):
+                    if not curl_released:
+                        self.release_curl(curl)
+                    curl_released = True
+                    raise first_element
+
+                rsp.request = req
+                rsp.astream_task = stream_task
+                rsp.quit_now = quit_now
+                rsp.queue = q
+                if self.raise_for_status:
+                    rsp.raise_for_status()
+                return rsp
+            else:
                 try:
+                    task = self.acurl.add_handle(curl)
                     await task
+                    self._record_connection(curl)
                 except CurlError as e:
+                    self._record_connection(curl)
                     rsp = self._parse_response(
-                        curl, buffer, header_buffer, default_encoding, discard_cookies
+                        curl,
+                        buffer,
+                        header_buffer,
+                        default_encoding,
+                        discard_cookies,
+                        request_url=req.url,
                     )
                     rsp.request = req
                     error = code2error(e.code, str(e))
-                    q.put_nowait(error(str(e), e.code, rsp))  # type: ignore
+                    raise error(str(e), e.code, rsp) from e
+                else:
+                    rsp = self._parse_response(
+                        curl,
+                        buffer,
+                        header_buffer,
+                        default_encoding,
+                        discard_cookies,
+                        request_url=req.url,
+                    )
+                    rsp.request = req
+                    if cache_lookup is not None:
+                        rsp = await self._astore_cached(req, rsp, cache_lookup)
+                    if self.raise_for_status:
+                        rsp.raise_for_status()
+                    return rsp
                 finally:
-                    if async_reader is not None:
+                    for async_reader in async_readers:
                         await async_reader.close()
-                    if not cast(asyncio.Event, header_recved).is_set():
-                        cast(asyncio.Event, header_recved).set()
-                    await q.put(STREAM_END)  # type: ignore
-
-            def cleanup(fut):
-                nonlocal curl_released
-                if not curl_released:
                     self.release_curl(curl)
-                curl_released = True
-
-            stream_task = asyncio.create_task(perform())
-            stream_task.add_done_callback(cleanup)
-
-            await cast(asyncio.Event, header_recved).wait()
-
-            # Unlike threads, coroutines does not use preemptive scheduling.
-            # For asyncio, there is no need for a header_parsed event, the
-            # _parse_response will execute in the foreground, no background tasks
-            # running.
-            rsp = self._parse_response(
-                curl, buffer, header_buffer, default_encoding, discard_cookies
-            )
-
-            first_element = _peek_aio_queue(q)  # type: ignore
-            if isinstance(first_element, RequestException):
-                if not curl_released:
-                    self.release_curl(curl)
-                curl_released = True
-                raise first_element
-
-            rsp.request = req
-            rsp.astream_task = stream_task
-            rsp.quit_now = quit_now
-            rsp.queue = q
-            if self.raise_for_status:
-                rsp.raise_for_status()
-            return rsp
-        else:
-            try:
-                task = self.acurl.add_handle(curl)
-                await task
-            except CurlError as e:
-                rsp = self._parse_response(
-                    curl, buffer, header_buffer, default_encoding, discard_cookies
-                )
-                rsp.request = req
-                error = code2error(e.code, str(e))
-                raise error(str(e), e.code, rsp) from e
-            else:
-                rsp = self._parse_response(
-                    curl, buffer, header_buffer, default_encoding, discard_cookies
-                )
-                rsp.request = req
-                if self.raise_for_status:
-                    rsp.raise_for_status()
-                return rsp
-            finally:
-                if async_reader is not None:
-                    await async_reader.close()
-                self.release_curl(curl)
+        finally:
+            if cache_lookup is not None and cache_lookup.leader:
+                self._cache.finish(req)  # type: ignore[union-attr]
 
     async def request(
         self,
@@ -1571,88 +2361,211 @@ class AsyncSession(BaseSession[R]):
         cert: Optional[Union[str, tuple[str, str]]] = None,
         stream: Optional[bool] = None,
         max_recv_speed: int = 0,
+        stream_buffer_size: Optional[int] = None,
+        stream_to: Optional[Union[int, IO[bytes]]] = None,
         multipart: Optional[CurlMime] = None,
         discard_cookies: bool = False,
+        priority: int = 0,
     ) -> R:
-        """Send the request, see ``curl_cffi.requests.request`` for details on args."""
+        """Send the request, see ``curl_cffi.requests.request`` for details on args.
+
+        Requests waiting for a curl handle are served by ``priority``, higher first.
+        """
 
         self._check_session_closed()
 
         body = content if content is not None else data
         body_position = _capture_body_position(data, content)
+        # the latency of streams is the time to the headers, not comparable
+        host = None if self.latencies is None or stream else self._host_of(url)
+        if host is not None and timeout is NOT_SET:
+            timeout = self._adapt_timeout(host)
+        hedge = self.hedge
+        if host is None or not _hedgeable(
+            hedge, method, data, content, files, multipart, stream_to, content_callback
+        ):
+            hedge = None
+        send = partial(
+            self._request_once,
+            method=method,
+            url=url,
+            params=params,
+            data=data,
+            content=content,
+            json=json,
+            headers=headers,
+            cookies=cookies,
+            files=files,
+            auth=auth,
+            timeout=timeout,
+            allow_redirects=allow_redirects,
+            max_redirects=max_redirects,
+            proxies=proxies,
+            proxy=proxy,
+            proxy_auth=proxy_auth,
+            verify=verify,
+            referer=referer,
+            accept_encoding=accept_encoding,
+            content_callback=content_callback,
+            impersonate=impersonate,
+            ja3=ja3,
+            akamai=akamai,
+            perk=perk,
+            extra_fp=extra_fp,
+            default_headers=default_headers,
+            default_encoding=default_encoding,
+            quote=quote,
+            http_version=http_version,
+            interface=interface,
+            doh_url=doh_url,
+            cert=cert,
+            stream=stream,
+            max_recv_speed=max_recv_speed,
+            stream_buffer_size=stream_buffer_size,
+            stream_to=stream_to,
+            multipart=multipart,
+            discard_cookies=discard_cookies,
+            priority=priority,
+        )
+        # a stale cached response is revalidated in the background by resending
+        send = partial(send, resend=send)
         strategy = self.retry
         for attempt in range(strategy.count + 1):
             if attempt:
                 _rewind_body(body, body_position)
             try:
-                return await self._request_once(
-                    method=method,
-                    url=url,
-                    params=params,
-                    data=data,
-                    content=content,
-                    json=json,
-                    headers=headers,
-                    cookies=cookies,
-                    files=files,
-                    auth=auth,
-                    timeout=timeout,
-                    allow_redirects=allow_redirects,
-                    max_redirects=max_redirects,
-                    proxies=proxies,
-                    proxy=proxy,
-                    proxy_auth=proxy_auth,
-                    verify=verify,
-                    referer=referer,
-                    accept_encoding=accept_encoding,
-                    content_callback=content_callback,
-                    impersonate=impersonate,
-                    ja3=ja3,
-                    akamai=akamai,
-                    perk=perk,
-                    extra_fp=extra_fp,
-                    default_headers=default_headers,
-                    default_encoding=default_encoding,
-                    quote=quote,
-                    http_version=http_version,
-                    interface=interface,
-                    doh_url=doh_url,
-                    cert=cert,
-                    stream=stream,
-                    max_recv_speed=max_recv_speed,
-                    multipart=multipart,
-                    discard_cookies=discard_cookies,
-                )
-            except RequestException:
+                if hedge is not None:
+                    return await self._send_hedged(send, cast(str, host), hedge)
+                return await self._send_observed(send, host)
+            except RequestException as e:
+                if self.metrics is not None:
+                    retried = attempt < strategy.count
+                    self.metrics.record_error(self._origin_of(url), retried)
                 if attempt == strategy.count:
                     raise
+                if self._pause_host(url, e):
+                    # the pool holds the retry until the host is resumed
+                    continue
                 delay = self._retry_delay(attempt + 1)
                 if delay:
                     await asyncio.sleep(delay)
 
-    async def head(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+    async def _astore_cached(self, request, response: R, lookup: CacheLookup) -> R:
+        cache = cast(CacheBackend, self._cache)
+        if response.status_code == 304 and lookup.validators:
+            # the stale entry is still valid, serve it instead of the empty 304
+            cached = await cache.arevalidated(request, response, self.response_class)
+            return cast(R, cached) if cached is not None else response
+        await cache.aset(request, response)
+        return response
+
+    def _refresh_cache(
+        self,
+        request,
+        lookup: CacheLookup,
+        resend: Optional[Callable[..., Awaitable[R]]],
+    ) -> None:
+        """Revalidate a stale response in the background, it is served meanwhile."""
+        cache = cast(CacheBackend, self._cache)
+        if resend is None:
+            cache.finish(request)
+            return
+
+        # finished here only, a second finish could drop the entry of a newer leader
+        revalidate = lookup._replace(response=None, refresh=False, leader=False)
+
+        async def refresh():
+            try:
+                await resend(cache_lookup=revalidate)
+            except RequestException:
+                pass  # the stale response stays until the next try
+            finally:
+                cache.finish(request)
+
+        task = asyncio.create_task(refresh())
+        self._cache_tasks.add(task)
+        task.add_done_callback(self._cache_tasks.discard)
+
+    def _adapt_timeout(self, host: str) -> Any:
+        if self.adaptive_timeout is None or isinstance(self.timeout, tuple):
+            return NOT_SET
+        timeout = self.adaptive_timeout.timeout_for(
+            cast(LatencyTracker, self.latencies), host
+        )
+        if timeout is None:
+            return NOT_SET
+        return timeout if self.timeout is None else min(self.timeout, timeout)
+
+    async def _send_observed(
+        self, send: Callable[[], Awaitable[R]], host: Optional[str]
+    ) -> R:
+        if host is None:
+            return await send()
+        latencies = cast(LatencyTracker, self.latencies)
+        start = time.monotonic()
+        try:
+            rsp = await send()
+        except (Timeout, asyncio.CancelledError):
+            # or the percentiles would never see the slow tail, which is cut by the
+            # timeouts and by the hedges cancelling the losers, at least this long
+            latencies.observe(host, time.monotonic() - start)
+            raise
+        latencies.observe(host, time.monotonic() - start)
+        return rsp
+
+    async def _send_hedged(
+        self, send: Callable[[], Awaitable[R]], host: str, hedge: HedgeStrategy
+    ) -> R:
+        delay = hedge.delay_for(cast(LatencyTracker, self.latencies), host)
+        attempt = partial(self._send_observed, send, host)
+        pending = {asyncio.ensure_future(attempt())}
+        hedges = 0
+        error: Optional[BaseException] = None
+        try:
+            while pending:
+                timeout = delay if hedges < hedge.max_hedges else None
+                done, pending = await asyncio.wait(
+                    pending, timeout=timeout, return_when=asyncio.FIRST_COMPLETED
+                )
+                if not done:
+                    hedges += 1
+                    pending.add(asyncio.ensure_future(attempt()))
+                    continue
+                for task in done:
+                    if task.exception() is None:
+                        return task.result()
+                    error = task.exception()
+            raise cast(BaseException, error)
+        finally:
+            # the losers give their handles back, via remove_handle, when cancelled
+            for task in pending:
+                task.cancel()
+            if pending:
+                await asyncio.gather(*pending, return_exceptions=True)
+
+    async def head(self, url: str, **kwargs: Unpack[AsyncRequestParams]) -> R:
         return await self.request(method="HEAD", url=url, **kwargs)
 
-    async def get(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+    async def get(self, url: str, **kwargs: Unpack[AsyncRequestParams]) -> R:
         return await self.request(method="GET", url=url, **kwargs)
 
-    async def post(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+    async def post(self, url: str, **kwargs: Unpack[AsyncRequestParams]) -> R:
         return await self.request(method="POST", url=url, **kwargs)
 
-    async def put(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+    async def put(self, url: str, **kwargs: Unpack[AsyncRequestParams]) -> R:
         return await self.request(method="PUT", url=url, **kwargs)
 
-    async def patch(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+    async def patch(self, url: str, **kwargs: Unpack[AsyncRequestParams]) -> R:
         return await self.request(method="PATCH", url=url, **kwargs)
 
-    async def delete(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+    async def delete(self, url: str, **kwargs: Unpack[AsyncRequestParams]) -> R:
         return await self.request(method="DELETE", url=url, **kwargs)
 
-    async def options(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+    async def options(self, url: str, **kwargs: Unpack[AsyncRequestParams]) -> R:
         return await self.request(method="OPTIONS", url=url, **kwargs)
 
-    async def trace(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+    async def trace(self, url: str, **kwargs: Unpack[AsyncRequestParams]) -> R:
         return await self.request(method="TRACE", url=url, **kwargs)
 
-    async def query(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+    async def query(self, url: str, **kwargs: Unpack[AsyncRequestParams]) -> R:
         return await self.request(method="QUERY", url=url, **kwargs)
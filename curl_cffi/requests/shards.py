@@ -0,0 +1,195 @@
+from __future__ import annotations
+
+import asyncio
+import os
+import threading
+import zlib
+from collections.abc import Coroutine
+from concurrent.futures import Future
+from contextlib import suppress
+from typing import TYPE_CHECKING, Any, Generic, Optional
+from urllib.parse import urljoin, urlparse
+
+from ..curl import CurlShare
+from .cookies import Cookies, CookieTypes
+from .session import AsyncSession, HttpMethod, R
+
+if TYPE_CHECKING:
+    from .session import BaseSessionParams, RequestParams, Unpack
+
+
+class _Shard(Generic[R]):
+    """An ``AsyncSession`` running on its own loop in a worker thread."""
+
+    def __init__(self, index: int, max_clients: int, kwargs: dict[str, Any]) -> None:
+        self.loop = asyncio.new_event_loop()
+        self.thread = threading.Thread(
+            target=self.loop.run_forever, name=f"curl_cffi-shard-{index}", daemon=True
+        )
+        self.thread.start()
+        try:
+            self.session: AsyncSession[R] = self.submit(
+                self._open(max_clients, kwargs)
+            ).result()
+        except BaseException:
+            self.stop()
+            raise
+
+    async def _open(
+        self, max_clients: int, kwargs: dict[str, Any]
+    ) -> AsyncSession[R]:
+        return AsyncSession(loop=self.loop, max_clients=max_clients, **kwargs)
+
+    def submit(self, coro: Coroutine[Any, Any, Any]) -> Future:
+        return asyncio.run_coroutine_threadsafe(coro, self.loop)
+
+    def stop(self) -> None:
+        self.loop.call_soon_threadsafe(self.loop.stop)
+        self.thread.join()
+        self.loop.close()
+
+
+class ShardedAsyncSession(Generic[R]):
+    """An async session spread over several ``AsyncSession`` shards, each with its own
+    event loop, ``curl_multi`` handle and worker thread.
+
+    Requests are routed to a shard by host, so all the requests to one host share
+    the connections of one shard. The response is handed back to the loop awaiting
+    it, libcurl does the network work on the shard threads without holding the GIL.
+
+    Cookies: all the shards share one ``Cookies`` jar, ``ShardedAsyncSession.cookies``.
+    Responses update it as they complete on the shards, later responses win. The
+    jar is thread-safe.
+
+    Fingerprints: every shard is created with the same session parameters, so they
+    all impersonate the same way, like one ``AsyncSession`` would. With
+    ``share=True``, the shards share one ``CurlShare``, i.e. one DNS cache and one
+    TLS session cache.
+
+    Streaming responses are not supported, since their body would be read on the
+    shard loop. Async iterable request bodies are iterated on the shard loop too.
+    """
+
+    def __init__(
+        self,
+        shards: Optional[int] = None,
+        *,
+        max_clients: int = 10,
+        cookies: Optional[CookieTypes] = None,
+        **kwargs: Unpack[BaseSessionParams[R]],
+    ) -> None:
+        """
+        Parameters:
+            shards: number of shards, defaults to the number of cpus.
+            max_clients: max curl handles used by each shard.
+            cookies: cookies to add in the shared jar.
+            **kwargs: parameters of ``AsyncSession``, applied to every shard.
+        """
+        if shards is not None and shards < 1:
+            raise ValueError("shards must be at least 1")
+        count = shards or os.cpu_count() or 1
+        self._cookies = Cookies(cookies)
+        if kwargs.get("share") is True:
+            kwargs["share"] = CurlShare()
+        self.base_url: Optional[str] = kwargs.get("base_url")
+        self._closed = False
+        self._shards: list[_Shard[R]] = []
+        try:
+            for index in range(count):
+                shard: _Shard[R] = _Shard(index, max_clients, dict(kwargs))
+                shard.session._cookies = self._cookies
+                self._shards.append(shard)
+        except BaseException:
+            for shard in self._shards:
+                with suppress(Exception):
+                    shard.submit(shard.session.close()).result()
+                shard.stop()
+            raise
+
+    @property
+    def cookies(self) -> Cookies:
+        return self._cookies
+
+    @cookies.setter
+    def cookies(self, cookies: CookieTypes) -> None:
+        # This ensures that the cookies property is always converted to Cookies.
+        self._cookies = Cookies(cookies)
+        for shard in self._shards:
+            shard.session._cookies = self._cookies
+
+    @property
+    def shards(self) -> list[AsyncSession[R]]:
+        """The sessions of the shards."""
+        return [shard.session for shard in self._shards]
+
+    def shard_for(self, url: str) -> AsyncSession[R]:
+        """The session of the shard requests to ``url`` are routed to."""
+        return self._shard(url).session
+
+    def _shard(self, url: str) -> _Shard[R]:
+        if self.base_url:
+            url = urljoin(self.base_url, url)
+        host = urlparse(url).netloc.lower()
+        # crc32 rather than hash(), so the routing is stable across processes
+        return self._shards[zlib.crc32(host.encode()) % len(self._shards)]
+
+    async def __aenter__(self) -> ShardedAsyncSession[R]:
+        return self
+
+    async def __aexit__(self, *args) -> None:
+        await self.close()
+
+    async def close(self) -> None:
+        """Close the shard sessions and stop their threads."""
+        if self._closed:
+            return
+        self._closed = True
+        await asyncio.gather(
+            *(
+                asyncio.wrap_future(shard.submit(shard.session.close()))
+                for shard in self._shards
+            ),
+            return_exceptions=True,
+        )
+        for shard in self._shards:
+            shard.stop()
+
+    async def request(
+        self, method: HttpMethod, url: str, **kwargs: Unpack[RequestParams]
+    ) -> R:
+        """Send the request on the shard of its host, see ``AsyncSession.request``
+        for details on parameters."""
+        if kwargs.get("stream"):
+            raise NotImplementedError(
+                "ShardedAsyncSession does not support streaming responses."
+            )
+        shard = self._shard(url)
+        future = shard.submit(shard.session.request(method, url, **kwargs))
+        return await asyncio.wrap_future(future)
+
+    async def head(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+        return await self.request(method="HEAD", url=url, **kwargs)
+
+    async def get(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+        return await self.request(method="GET", url=url, **kwargs)
+
+    async def post(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+        return await self.request(method="POST", url=url, **kwargs)
+
+    async def put(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+        return await self.request(method="PUT", url=url, **kwargs)
+
+    async def patch(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+        return await self.request(method="PATCH", url=url, **kwargs)
+
+    async def delete(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+        return await self.request(method="DELETE", url=url, **kwargs)
+
+    async def options(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+        return await self.request(method="OPTIONS", url=url, **kwargs)
+
+    async def trace(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+        return await self.request(method="TRACE", url=url, **kwargs)
+
+    async def query(self, url: str, **kwargs: Unpack[RequestParams]) -> R:
+        return await self.request(method="QUERY", url=url, **kwargs)
@@ -0,0 +1,401 @@
+from __future__ import annotations
+
+import hashlib
+import itertools
+import os
+import re
+import shutil
+import struct
+import sys
+import tempfile
+import threading
+import time
+import weakref
+from collections.abc import Iterable, Iterator
+from contextlib import contextmanager, suppress
+from pathlib import Path
+from typing import TYPE_CHECKING, Optional, Union
+
+from ..curl import Curl, CurlShare
+
+if TYPE_CHECKING:
+    from ..fingerprints import Fingerprint
+    from .impersonate import ExtraFingerprints, ExtraFpDict
+
+__all__ = ["PersistentStore", "StoreProfile"]
+
+# tls_sessions.bin: magic, then the records of Curl.export_ssl_sessions, which are
+# [size_t shmac_len][shmac][size_t sdata_len][sdata][curl_off_t valid_until]
+_TLS_MAGIC = b"CCTLS1\n"
+_SIZE = struct.Struct("N")
+_VALID_UNTIL = struct.Struct("q")
+_PROFILE_NAME_RE = re.compile(r"^[A-Za-z0-9_.-]{1,64}$")
+# libcurl keeps a handful of TLS 1.3 tickets per peer, older ones are of no use
+_MAX_TICKETS_PER_PEER = 4
+# an Alt-Svc or HSTS entry: the key, then the quoted expiry, then the flags
+_CACHE_LINE_RE = re.compile(r'^(.*?) "([^"]*)"')
+# the copy of an Alt-Svc or HSTS file given to a handle, tagged with the pid
+_COPY_RE = re.compile(r"^(?:altsvc|hsts)\.(\d+)-\d+\.txt$")
+# the copies given to the handles of this process, shared by all the stores, since
+# they may use the same directory
+_copies: dict[str, weakref.ref[Curl]] = {}
+_copies_lock = threading.Lock()
+_copies_counter = itertools.count()
+
+if sys.platform == "win32":
+    import ctypes
+    from ctypes import wintypes
+
+    _kernel32 = ctypes.WinDLL("kernel32", use_last_error=True)
+    _kernel32.OpenProcess.restype = wintypes.HANDLE
+    _kernel32.OpenProcess.argtypes = (wintypes.DWORD, wintypes.BOOL, wintypes.DWORD)
+    _kernel32.GetExitCodeProcess.argtypes = (wintypes.HANDLE, wintypes.LPDWORD)
+    _kernel32.CloseHandle.argtypes = (wintypes.HANDLE,)
+
+    def _pid_alive(pid: int) -> bool:
+        # PROCESS_QUERY_LIMITED_INFORMATION
+        handle = _kernel32.OpenProcess(0x1000, False, pid)
+        if not handle:
+            # ERROR_ACCESS_DENIED, it exists
+            return ctypes.get_last_error() == 5
+        try:
+            code = wintypes.DWORD()
+            if not _kernel32.GetExitCodeProcess(handle, ctypes.byref(code)):
+                return True
+            # STILL_ACTIVE
+            return code.value == 259
+        finally:
+            _kernel32.CloseHandle(handle)
+
+else:
+
+    def _pid_alive(pid: int) -> bool:
+        try:
+            os.kill(pid, 0)
+        except ProcessLookupError:
+            return False
+        except PermissionError:
+            return True
+        return True
+
+
+def _copy_user(path: str) -> Optional[Curl]:
+    """The open handle which will write the copy, forgotten once there is none."""
+    ref = _copies.get(path)
+    curl = ref() if ref is not None else None
+    # libcurl writes the copy when the handle is closed, or reset
+    if curl is None or curl._curl is None or path not in curl.persistent_files:
+        _copies.pop(path, None)
+        return None
+    return curl
+
+
+def parse_tls_records(data: bytes) -> list[tuple[bytes, bytes, int]]:
+    """Split exported TLS sessions into (shmac, record, valid_until) tuples, the
+    shmac being the hashed peer key. Raises ``ValueError`` if truncated."""
+    records = []
+    view = memoryview(data)
+    pos = 0
+    try:
+        while pos < len(view):
+            start = pos
+            (shmac_len,) = _SIZE.unpack_from(view, pos)
+            pos += _SIZE.size
+            shmac = bytes(view[pos : pos + shmac_len])
+            pos += shmac_len
+            (sdata_len,) = _SIZE.unpack_from(view, pos)
+            pos += _SIZE.size + sdata_len
+            (valid_until,) = _VALID_UNTIL.unpack_from(view, pos)
+            pos += _VALID_UNTIL.size
+            records.append((shmac, bytes(view[start:pos]), valid_until))
+    except struct.error as e:
+        raise ValueError("Truncated TLS session records") from e
+    return records
+
+
+def merge_tls_records(
+    old: bytes, new: bytes, limit: int, now: Optional[float] = None
+) -> bytes:
+    """Merge two exports. Expired sessions are dropped, and only the ``limit``
+    sessions valid the longest are kept, a few per peer."""
+    now = time.time() if now is None else now
+    merged: dict[tuple[bytes, bytes], tuple[bytes, int]] = {}
+    for data in (old, new):
+        for shmac, record, valid_until in parse_tls_records(data):
+            # a peer may have several tickets, they only differ by their data
+            merged[(shmac, record)] = (record, valid_until)
+    alive = [item for item in merged.items() if item[1][1] > now]
+    alive.sort(key=lambda item: item[1][1], reverse=True)
+    kept: list[bytes] = []
+    per_peer: dict[bytes, int] = {}
+    for (shmac, _), (record, _) in alive:
+        if len(kept) >= limit:
+            break
+        if per_peer.get(shmac, 0) < _MAX_TICKETS_PER_PEER:
+            per_peer[shmac] = per_peer.get(shmac, 0) + 1
+            kept.append(record)
+    return b"".join(kept)
+
+
+def merge_cache_lines(texts: Iterable[str]) -> str:
+    """Merge Alt-Svc or HSTS files, keeping the entry of each host expiring last."""
+    merged: dict[str, tuple[str, str]] = {}
+    for text in texts:
+        for line in text.splitlines():
+            m = _CACHE_LINE_RE.match(line)
+            if line.startswith("#") or m is None:
+                continue
+            # a leading dot marks an HSTS entry including the subdomains
+            key, expire = m.group(1).lstrip("."), m.group(2)
+            # "YYYYMMDD HH:MM:SS" sorts by date, and "unlimited" after any date
+            if key not in merged or expire >= merged[key][0]:
+                merged[key] = (expire, line)
+    return "".join(line + "\n" for _, line in merged.values())
+
+
+def _write_atomic(path: Path, data: bytes) -> None:
+    fd, tmp_path = tempfile.mkstemp(dir=path.parent, suffix=".tmp")
+    try:
+        with os.fdopen(fd, "wb") as f:
+            f.write(data)
+        os.replace(tmp_path, path)
+    except BaseException:
+        with suppress(FileNotFoundError):
+            os.unlink(tmp_path)
+        raise
+
+
+def profile_name(
+    impersonate: Optional[Union[str, Fingerprint]] = None,
+    ja3: Optional[str] = None,
+    akamai: Optional[str] = None,
+    perk: Optional[str] = None,
+    extra_fp: Optional[Union[ExtraFingerprints, ExtraFpDict]] = None,
+) -> str:
+    """Name of the directory of an impersonation profile, the target itself for a
+    plain target, e.g. ``chrome136``, a digest of the settings otherwise."""
+    if ja3 is None and akamai is None and perk is None and extra_fp is None:
+        if impersonate is None:
+            return "default"
+        if isinstance(impersonate, str) and _PROFILE_NAME_RE.match(impersonate):
+            return impersonate
+    settings = repr((impersonate, ja3, akamai, perk, extra_fp)).encode()
+    return "custom-" + hashlib.sha256(settings).hexdigest()[:32]
+
+
+class StoreProfile:
+    """The files of one impersonation profile in a ``PersistentStore``."""
+
+    def __init__(self, store: PersistentStore, name: str) -> None:
+        self.store = store
+        self.name = name
+        self.path = store.path / name
+        # TLS tickets are secrets
+        self.path.mkdir(mode=0o700, parents=True, exist_ok=True)
+        self.altsvc_file: Optional[str] = (
+            str(self.path / "altsvc.txt") if store.altsvc else None
+        )
+        self.hsts_file: Optional[str] = (
+            str(self.path / "hsts.txt") if store.hsts else None
+        )
+        self.tls_file = self.path / "tls_sessions.bin"
+        # the copies left by the processes which did not merge them, e.g. killed
+        self.save_files()
+
+    def attach(self, curl: Curl) -> None:
+        """Make the handle load and save the Alt-Svc and HSTS files.
+
+        Each handle gets its own copy of the files, or the last one to close would
+        overwrite what the others learned, :meth:`save_files` merges them back.
+        """
+        if self.altsvc_file is None and self.hsts_file is None:
+            return
+        with _copies_lock:
+            files = curl.persistent_files
+            if files != (None, None) and all(
+                _copy_user(file) is curl and Path(file).parent == self.path
+                for file in files
+                if file is not None
+            ):
+                return
+            tag = f"{os.getpid()}-{next(_copies_counter)}"
+            files = (self._copy(self.altsvc_file, tag), self._copy(self.hsts_file, tag))
+            for file in files:
+                if file is not None:
+                    _copies[file] = weakref.ref(curl)
+        curl.set_persistent_files(*files)
+
+    @staticmethod
+    def _copy(file: Optional[str], tag: str) -> Optional[str]:
+        if file is None:
+            return None
+        path = Path(file)
+        copy = path.with_name(f"{path.stem}.{tag}{path.suffix}")
+        with suppress(FileNotFoundError):
+            shutil.copyfile(path, copy)
+        return str(copy)
+
+    def save_files(self) -> None:
+        """Merge the copies of the Alt-Svc and HSTS files into the files of the
+        profile.
+
+        The copies of the closed handles, and those left by dead processes, are
+        removed. Those of the handles still open in this process are merged as they
+        are and kept, libcurl writes them again when the handles are closed.
+        """
+        pid = os.getpid()
+        with _copies_lock:
+            for file in (self.altsvc_file, self.hsts_file):
+                if file is None:
+                    continue
+                path = Path(file)
+                done, kept = [], []
+                for copy in path.parent.glob(f"{path.stem}.*-*{path.suffix}"):
+                    m = _COPY_RE.match(copy.name)
+                    if m is None:
+                        continue
+                    owner = int(m.group(1))
+                    if owner != pid:
+                        # merged by their own process while it runs
+                        if not _pid_alive(owner):
+                            done.append(copy)
+                    elif _copy_user(str(copy)) is not None:
+                        kept.append(copy)
+                    else:
+                        done.append(copy)
+                if not done and not kept:
+                    continue
+                texts = []
+                for copy in [path, *done, *kept]:
+                    with suppress(FileNotFoundError):
+                        texts.append(copy.read_text())
+                _write_atomic(path, merge_cache_lines(texts).encode())
+                for copy in done:
+                    with suppress(FileNotFoundError):
+                        copy.unlink()
+
+    def _read_tls_sessions(self) -> bytes:
+        try:
+            data = self.tls_file.read_bytes()
+        except FileNotFoundError:
+            return b""
+        if not data.startswith(_TLS_MAGIC):
+            return b""
+        data = data[len(_TLS_MAGIC) :]
+        try:
+            parse_tls_records(data)
+        except ValueError:
+            # written on another platform, or corrupted
+            return b""
+        return data
+
+    def load_tls_sessions(self, share: CurlShare) -> int:
+        """Import the saved TLS sessions into the cache of ``share``.
+
+        Returns:
+            the number of sessions libcurl accepted.
+        """
+        if not self.store.tls_sessions:
+            return 0
+        data = self._read_tls_sessions()
+        if not data:
+            return 0
+        with _share_handle(share) as curl:
+            return curl.import_ssl_sessions(data)
+
+    def save_tls_sessions(self, share: CurlShare) -> int:
+        """Merge the TLS sessions cached by ``share`` into the file, which other
+        processes may update concurrently, the last writer wins.
+
+        Returns:
+            the number of sessions in the file.
+        """
+        if not self.store.tls_sessions:
+            return 0
+        with _share_handle(share) as curl:
+            exported = curl.export_ssl_sessions()
+        with self.store._lock:
+            data = merge_tls_records(
+                self._read_tls_sessions(), exported, self.store.max_tls_sessions
+            )
+            _write_atomic(self.tls_file, _TLS_MAGIC + data)
+        return len(parse_tls_records(data))
+
+
+@contextmanager
+def _share_handle(share: CurlShare) -> Iterator[Curl]:
+    # a short-lived handle reaching the caches of the share
+    curl = Curl()
+    try:
+        curl.set_share(share)
+        yield curl
+    finally:
+        curl.close()
+
+
+class PersistentStore:
+    """TLS session tickets, Alt-Svc and HSTS entries kept on disk, so that a new
+    process resumes TLS sessions and upgrades to HTTP/3 or HTTPS right away instead
+    of starting cold.
+
+    Each impersonation profile has its own subdirectory, so the tickets and Alt-Svc
+    entries learned with one fingerprint are never replayed with another. The
+    directory may be shared by sessions and processes, files are replaced
+    atomically.
+
+    .. code-block:: python
+
+        store = PersistentStore("~/.cache/my_worker")
+        with Session(impersonate="chrome", store=store) as s:
+            s.get("https://example.com")
+
+    Sessions load the TLS sessions into their ``CurlShare`` when created and save
+    them back when closed. libcurl writes the Alt-Svc and HSTS files of each curl
+    handle when it is closed, sessions merge them into the files of the profile
+    when closed, and those left by dead processes are merged when the profile is
+    loaded again. Requests overriding the fingerprint of their session use the
+    files of their own profile.
+    """
+
+    def __init__(
+        self,
+        directory: Union[str, os.PathLike[str]],
+        *,
+        tls_sessions: bool = True,
+        altsvc: bool = True,
+        hsts: bool = True,
+        max_tls_sessions: int = 1000,
+    ) -> None:
+        """
+        Parameters:
+            directory: where to keep the files, created if missing.
+            tls_sessions: save TLS session tickets, sessions using the store then
+                share their TLS sessions through a ``CurlShare``.
+            altsvc: save the Alt-Svc cache, i.e. which hosts speak HTTP/3.
+            hsts: save the HSTS cache.
+            max_tls_sessions: sessions kept in the file of each profile, those
+                valid the longest win.
+        """
+        self.path = Path(directory).expanduser()
+        self.tls_sessions = tls_sessions
+        self.altsvc = altsvc
+        self.hsts = hsts
+        self.max_tls_sessions = max_tls_sessions
+        self._lock = threading.Lock()
+        self._profiles: dict[str, StoreProfile] = {}
+
+    def profile(
+        self,
+        impersonate: Optional[Union[str, Fingerprint]] = None,
+        ja3: Optional[str] = None,
+        akamai: Optional[str] = None,
+        perk: Optional[str] = None,
+        extra_fp: Optional[Union[ExtraFingerprints, ExtraFpDict]] = None,
+    ) -> StoreProfile:
+        """The files of an impersonation profile, given like to a session."""
+        name = profile_name(impersonate, ja3, akamai, perk, extra_fp)
+        with self._lock:
+            profile = self._profiles.get(name)
+            if profile is None:
+                profile = self._profiles[name] = StoreProfile(self, name)
+        return profile
@@ -1,13 +1,25 @@
 from __future__ import annotations
 
 import asyncio
+import mmap
+import os
 import queue
-from collections.abc import AsyncIterable, Iterable, Iterator
+import stat
+from collections import deque
+from collections.abc import AsyncIterable, Callable, Iterable, Iterator, Sequence
 from contextlib import suppress
-from io import SEEK_END, SEEK_SET, BytesIO
+from io import SEEK_END, SEEK_SET, BytesIO, TextIOBase, UnsupportedOperation
 from typing import IO, Any, Union, cast, final
 
-from ..curl import CURL_READFUNC_PAUSE, CURLPAUSE_SEND_CONT, Curl
+from ..curl import (
+    CURL_READFUNC_PAUSE,
+    CURLPAUSE_CONT,
+    CURLPAUSE_SEND_CONT,
+    Curl,
+    CurlError,
+    CurlFileSource,
+    CurlRingBuffer,
+)
 from .exceptions import UnrewindableBodyError
 
 
@@ -18,7 +30,9 @@ RequestData = Union[
     BytesIO,
     bytes,
 ]
-SyncRequestContent = Union[str, bytes, bytearray, IO[bytes], Iterable[bytes]]
+SyncRequestContent = Union[
+    str, bytes, bytearray, memoryview, mmap.mmap, IO[bytes], Iterable[bytes]
+]
 RequestContent = Union[SyncRequestContent, AsyncIterable[bytes]]
 
 STREAM_END = object()
@@ -131,6 +145,18 @@ class _FileReader:
     def rewindable(self) -> bool:
         return self._start is not None and hasattr(self._file, "seek")
 
+    def native(self) -> CurlFileSource | None:
+        """Read a regular binary file in C instead of through ``read()`` calls."""
+        if self._length is None or isinstance(self._file, TextIOBase):
+            return None
+        try:
+            fd = self._file.fileno()
+            if not stat.S_ISREG(os.fstat(fd).st_mode):
+                return None
+            return CurlFileSource(fd, cast(int, self._start), self._length)
+        except (AttributeError, OSError, UnsupportedOperation):
+            return None
+
     def read(self, size: int) -> bytes:
         return self._file.read(size)
 
@@ -220,3 +246,129 @@ class _AsyncIterableReader:
         chunk = bytes(buffer[:size])
         del buffer[:size]
         return chunk
+
+
+def _consume_view(ring: CurlRingBuffer, view: memoryview) -> None:
+    # the ring reuses the memory, a chunk kept past this raises instead of changing
+    size = len(view)
+    with suppress(BufferError):
+        view.release()
+    ring.consume(size)
+
+
+@final
+class _RingQueue:
+    """Stands in for the queue and the ``quit_now`` event of a stream written into a
+    ``CurlRingBuffer`` by ``Curl.perform_ring`` in another thread.
+
+    ``get`` returns views into the ring, each one is released by the next call,
+    errors and ``STREAM_END`` are queued after the body.
+    """
+
+    __slots__ = ("ring", "_on_data", "_tail", "_view")
+
+    def __init__(
+        self, ring: CurlRingBuffer, curl: Curl, on_data: Callable[[], None]
+    ) -> None:
+        self.ring = ring
+        self._on_data = on_data
+        self._tail: deque[Any] = deque()
+        self._view: memoryview | None = None
+
+    @property
+    def queue(self) -> Sequence[Any]:
+        # the body comes first, seen by _peek_queue
+        return () if len(self.ring) else self._tail
+
+    def wakeup(self) -> None:
+        self._on_data()
+
+    def put_nowait(self, item: Any) -> None:
+        with self.ring.cond:
+            self._tail.append(item)
+            self.ring.cond.notify_all()
+
+    put = put_nowait
+
+    def get(self) -> Any:
+        ring = self.ring
+        with ring.cond:
+            if self._view is not None:
+                _consume_view(ring, self._view)
+                self._view = None
+            while not len(ring) and not self._tail:
+                ring.cond.wait()
+            if not len(ring):
+                return self._tail.popleft()
+            self._view = ring.peek()
+            return self._view
+
+    def is_set(self) -> bool:
+        return self.ring.closed
+
+    def set(self) -> None:
+        self.ring.close()
+
+
+@final
+class _AsyncRingQueue:
+    """Asyncio flavor of ``_RingQueue``, the transfer runs in the loop thread, so it
+    is resumed right from ``get``, ``AsyncCurl`` calls ``wakeup`` after each round of
+    socket actions."""
+
+    __slots__ = ("ring", "_curl", "_on_data", "_event", "_tail", "_view")
+
+    def __init__(
+        self, ring: CurlRingBuffer, curl: Curl, on_data: Callable[[], None]
+    ) -> None:
+        self.ring = ring
+        self._curl = curl
+        self._on_data = on_data
+        self._event = asyncio.Event()
+        self._tail: deque[Any] = deque()
+        self._view: memoryview | None = None
+
+    @property
+    def _queue(self) -> Sequence[Any]:
+        # the body comes first, seen by _peek_aio_queue
+        return () if len(self.ring) else self._tail
+
+    def wakeup(self) -> None:
+        if len(self.ring):
+            self._on_data()
+            self._event.set()
+
+    def put_nowait(self, item: Any) -> None:
+        self._tail.append(item)
+        self._event.set()
+
+    async def put(self, item: Any) -> None:
+        self.put_nowait(item)
+
+    async def get(self) -> Any:
+        ring = self.ring
+        if self._view is not None:
+            _consume_view(ring, self._view)
+            self._view = None
+            if ring.resumable:
+                self._resume()
+        while not len(ring) and not self._tail:
+            self._event.clear()
+            await self._event.wait()
+        if not len(ring):
+            return self._tail.popleft()
+        self._view = ring.peek()
+        return self._view
+
+    def _resume(self) -> None:
+        # the transfer may fail right away when closed, the error comes via perform
+        with suppress(CurlError):
+            self._curl.pause(CURLPAUSE_CONT)
+
+    def is_set(self) -> bool:
+        return self.ring.closed
+
+    def set(self) -> None:
+        self.ring.close()
+        if self.ring.paused:
+            self._resume()
@@ -6,20 +6,42 @@ __all__ = ["HttpVersionLiteral", "set_curl_options", "NOT_SET"]
 import asyncio
 import ipaddress
 import math
+import mmap
+import os
 import queue
 import warnings
 from collections import Counter
 from collections.abc import Callable, Iterable
+from dataclasses import fields, is_dataclass
 from io import BytesIO
 from json import dumps
-from typing import TYPE_CHECKING, Any, Final, Literal, Optional, Union, cast, final
+from typing import (
+    IO,
+    TYPE_CHECKING,
+    Any,
+    Final,
+    Literal,
+    Optional,
+    Union,
+    cast,
+    final,
+)
 from urllib.parse import ParseResult, parse_qsl, quote, urlencode, urljoin, urlparse
 
 from ..const import CurlFollow, CurlHttpVersion, CurlOpt, CurlSslVersion
-from ..curl import CURL_WRITEFUNC_ERROR, CurlMime
+from ..curl import (
+    CURL_WRITEFUNC_ERROR,
+    Curl,
+    CurlBuffer,
+    CurlFileSink,
+    CurlHeaderBuffer,
+    CurlMime,
+    CurlRingBuffer,
+    CurlShare,
+)
 from ..utils import CurlCffiWarning, HttpVersionLiteral
 from ..fingerprints import Fingerprint, FingerprintManager, NATIVE_IMPERSONATE_TARGETS
-from .cookies import Cookies
+from .cookies import Cookies, CurlCookies
 from .exceptions import ImpersonateError, InvalidURL
 from .headers import Headers
 from .impersonate import (
@@ -33,11 +55,11 @@ from .models import Request
 from .streams import RequestContent, RequestData, _FileReader, _IterableReader
 
 if TYPE_CHECKING:
-    from ..curl import Curl
     from .cookies import CookieTypes
     from .headers import HeaderTypes
     from .impersonate import BrowserTypeLiteral, ExtraFpDict
     from .session import ProxySpec
+    from .store import StoreProfile
 
 
 HttpMethod = Literal[
@@ -239,6 +261,24 @@ def _header_line_key(header_line: str) -> str:
     return header_line[: min(indexes)].strip().lower()
 
 
+def _byte_view(content: Union[bytearray, memoryview, mmap.mmap]) -> Any:
+    view = memoryview(content)
+    if not view.c_contiguous:
+        return view.tobytes()
+    # a flat byte view, so that len() is the size in bytes
+    return view.cast("B") if view.format != "B" or view.ndim != 1 else view
+
+
+def _file_position(file: Union[int, IO[bytes]]) -> int:
+    try:
+        if isinstance(file, int):
+            return os.lseek(file, 0, os.SEEK_CUR)
+        return file.tell()
+    except OSError:
+        # pipes and sockets, nothing to resume
+        return 0
+
+
 def peek_queue(q: queue.Queue, default=None):
     try:
         return q.queue[0]
@@ -422,6 +462,13 @@ def _apply_fingerprint(
     existing_header_names: set[str],
     default_headers: bool,
 ) -> None:
+    _apply_fingerprint_options(curl, fingerprint)
+    _apply_fingerprint_headers(
+        curl, fingerprint, existing_header_names, default_headers
+    )
+
+
+def _apply_fingerprint_options(curl: Curl, fingerprint: Fingerprint) -> None:
     if fingerprint.tls_version:
         tls_version = _normalize_tls_version(fingerprint.tls_version)
         curl.setopt(CurlOpt.SSLVERSION, tls_version | CurlSslVersion.MAX_DEFAULT)
@@ -542,6 +589,13 @@ def _apply_fingerprint(
             ",".join(fingerprint.ws_tls_cert_compression),
         )
 
+
+def _apply_fingerprint_headers(
+    curl: Curl,
+    fingerprint: Fingerprint,
+    existing_header_names: set[str],
+    default_headers: bool,
+) -> None:
     # default headers will not override user-defined headers
     if default_headers and fingerprint.headers:
         header_lines = []
@@ -577,6 +631,219 @@ def _apply_fingerprint(
         )
 
 
+def _set_template_options(
+    c: Curl,
+    *,
+    accept_encoding: Optional[str],
+    cert: Optional[Union[str, tuple[str, str]]],
+    http_version: Optional[Union[CurlHttpVersion, HttpVersionLiteral]],
+    impersonate: Optional[Union[BrowserTypeLiteral, str, Fingerprint]],
+    fingerprint: Optional[Fingerprint],
+    ja3: Optional[str],
+    akamai: Optional[str],
+    perk: Optional[str],
+    extra_fp: Optional[ExtraFingerprints],
+    default_headers: bool,
+    interface: Optional[str],
+    doh_url: Optional[str],
+) -> None:
+    # accept_encoding
+    if accept_encoding is not None:
+        c.setopt(CurlOpt.ACCEPT_ENCODING, accept_encoding.encode())
+
+    # cert
+    if cert:
+        if isinstance(cert, str):
+            c.setopt(CurlOpt.SSLCERT, cert)
+        else:
+            cert, key = cert
+            c.setopt(CurlOpt.SSLCERT, cert)
+            c.setopt(CurlOpt.SSLKEY, key)
+
+    # http_version, before impersonation, which relies on checking if user wants http/3
+    if http_version:
+        http_version = normalize_http_version(http_version)
+        c.setopt(CurlOpt.HTTP_VERSION, http_version)
+
+    # impersonate
+    if fingerprint is not None:
+        _apply_fingerprint_options(c, fingerprint)
+    elif impersonate:
+        normalized = resolve_latest_browser_type(cast(str, impersonate))
+        ret = c.impersonate(normalized, default_headers=default_headers)  # type: ignore
+        if ret != 0:
+            raise ImpersonateError(f"Impersonating {normalized} is not supported")
+
+    # ja3 string
+    if ja3:
+        permute = bool(extra_fp and extra_fp.tls_permute_extensions)
+        set_ja3_options(c, ja3, permute=permute)
+
+    # extra_fp options
+    if extra_fp:
+        set_extra_fp(c, extra_fp)
+
+    # akamai string
+    if akamai:
+        set_akamai_options(c, akamai)
+
+    # perk string
+    if perk:
+        set_perk_options(c, perk)
+
+    # interface
+    if interface:
+        value = interface
+        if "!" not in interface:
+            try:
+                ipaddress.ip_address(interface)
+            except ValueError:
+                pass
+            else:
+                value = f"host!{interface}"
+        c.setopt(CurlOpt.INTERFACE, value.encode())
+
+    if doh_url:
+        c.setopt(CurlOpt.DOH_URL, doh_url.encode())
+
+
+def _resolve_fingerprint(
+    impersonate: Optional[Union[BrowserTypeLiteral, str, Fingerprint]],
+) -> Optional[Fingerprint]:
+    """Return the fingerprint to apply in python, None for native targets."""
+    if isinstance(impersonate, Fingerprint):
+        return impersonate
+    if impersonate and not _is_native_impersonate_target(impersonate):
+        fingerprint = _load_named_fingerprint(impersonate)
+        if fingerprint is None:
+            raise ImpersonateError(f"Impersonating {impersonate} is not supported")
+        return fingerprint
+    return None
+
+
+def _fingerprint_file_token() -> Optional[int]:
+    try:
+        return os.stat(FingerprintManager.get_fingerprint_path()).st_mtime_ns
+    except OSError:
+        return None
+
+
+def _freeze(value: Any) -> Any:
+    """Turn fingerprint settings into a hashable value, compared by content."""
+    if value is None or isinstance(value, (str, bytes, int, float)):
+        return value
+    if is_dataclass(value):
+        return (type(value),) + tuple(
+            _freeze(getattr(value, f.name)) for f in fields(value)
+        )
+    if isinstance(value, dict):
+        return tuple((k, _freeze(v)) for k, v in value.items())
+    if isinstance(value, (list, tuple)):
+        return tuple(_freeze(v) for v in value)
+    return value
+
+
+class _ProfileRecorder:
+    """Stands in for a curl handle to record the options of a profile."""
+
+    def __init__(self) -> None:
+        self.options: list[tuple[Optional[CurlOpt], Any]] = []
+
+    def setopt(self, option: CurlOpt, value: Any) -> int:
+        self.options.append((option, value))
+        return 0
+
+    def impersonate(self, target: str, default_headers: bool = True) -> int:
+        self.options.append((None, (target, default_headers)))
+        return 0
+
+
+@final
+class CompiledProfile:
+    """Session level options, parsed once into the exact ``setopt`` calls.
+
+    Profiles are immutable and memoized by :func:`compile_profile`, so a handle that
+    already carries a profile can tell by identity and skip applying it again.
+    """
+
+    __slots__ = ("options", "fingerprint")
+
+    def __init__(
+        self,
+        options: tuple[tuple[Optional[CurlOpt], Any], ...],
+        fingerprint: Optional[Fingerprint] = None,
+    ) -> None:
+        self.options = options
+        # kept for the default headers, which depend on the request headers
+        self.fingerprint = fingerprint
+
+    def apply(self, curl: Curl) -> None:
+        """Set all the options of this profile on a curl handle."""
+        for option, value in self.options:
+            if option is None:
+                target, default_headers = value
+                ret = curl.impersonate(target, default_headers=default_headers)
+                if ret != 0:
+                    raise ImpersonateError(f"Impersonating {target} is not supported")
+            else:
+                curl.setopt(option, value)
+
+
+_MAX_PROFILES = 128
+_profiles: dict[Any, CompiledProfile] = {}
+
+
+def compile_profile(
+    *,
+    accept_encoding: Optional[str] = "gzip, deflate, br, zstd",
+    cert: Optional[Union[str, tuple[str, str]]] = None,
+    http_version: Optional[Union[CurlHttpVersion, HttpVersionLiteral]] = None,
+    impersonate: Optional[Union[BrowserTypeLiteral, str, Fingerprint]] = None,
+    ja3: Optional[str] = None,
+    akamai: Optional[str] = None,
+    perk: Optional[str] = None,
+    extra_fp: Optional[ExtraFingerprints] = None,
+    default_headers: bool = True,
+    interface: Optional[str] = None,
+    doh_url: Optional[str] = None,
+) -> CompiledProfile:
+    """Compile the session level options into a memoized :class:`CompiledProfile`.
+
+    JA3, Akamai and perk strings are parsed, and fingerprints are normalized only the
+    first time a combination is seen. Named fingerprints are reloaded when the
+    fingerprints file changes.
+    """
+    options = {
+        "accept_encoding": accept_encoding,
+        "cert": cert,
+        "http_version": http_version,
+        "impersonate": impersonate,
+        "ja3": ja3,
+        "akamai": akamai,
+        "perk": perk,
+        "extra_fp": extra_fp,
+        "default_headers": default_headers,
+        "interface": interface,
+        "doh_url": doh_url,
+    }
+    key = tuple(_freeze(value) for value in options.values())
+    if isinstance(impersonate, str) and not _is_native_impersonate_target(impersonate):
+        key += (_fingerprint_file_token(),)
+
+    profile = _profiles.get(key)
+    if profile is None:
+        fingerprint = _resolve_fingerprint(impersonate)
+        recorder = _ProfileRecorder()
+        _set_template_options(
+            cast(Curl, recorder), fingerprint=fingerprint, **options
+        )
+        profile = CompiledProfile(tuple(recorder.options), fingerprint)
+        if len(_profiles) >= _MAX_PROFILES:
+            _profiles.pop(next(iter(_profiles)), None)
+        _profiles[key] = profile
+    return profile
+
+
 def set_curl_options(
     curl: Curl,
     method: HttpMethod,
@@ -616,23 +883,60 @@ def set_curl_options(
     cert: Optional[Union[str, tuple[str, str]]] = None,
     stream: Optional[bool] = None,
     max_recv_speed: int = 0,
+    stream_buffer_size: Optional[int] = None,
+    stream_to: Optional[Union[int, IO[bytes]]] = None,
     multipart: Optional[CurlMime] = None,
     queue_class: Any = None,
     event_class: Any = None,
+    ring_queue_class: Any = None,
     curl_options: Optional[dict[CurlOpt, str]] = None,
+    share: Optional[CurlShare] = None,
+    store: Optional[StoreProfile] = None,
 ):
     c = curl
 
     method = method.upper()  # type: ignore
 
+    if isinstance(extra_fp, dict):
+        extra_fp = ExtraFingerprints(**extra_fp)
+
+    # Options that only depend on the session settings are applied once per handle,
+    # they must come first, since a changed template resets the handle.
+    template_options = {
+        "accept_encoding": accept_encoding,
+        "cert": cert,
+        "http_version": http_version,
+        "impersonate": impersonate,
+        "ja3": ja3,
+        "akamai": akamai,
+        "perk": perk,
+        "extra_fp": extra_fp,
+        "default_headers": default_headers,
+        "interface": interface,
+        "doh_url": doh_url,
+    }
+    if isinstance(c, Curl):
+        profile = compile_profile(**template_options)
+        c.apply_template(profile, profile.apply)
+        c.set_share(share)
+        if store is not None:
+            store.attach(c)
+        fingerprint = profile.fingerprint
+    else:
+        fingerprint = _resolve_fingerprint(impersonate)
+        _set_template_options(c, fingerprint=fingerprint, **template_options)
+
     # content/data/body/json
     body_data = content if content is not None else data
     stream_reader: object | None = None
     if content is not None:
         if isinstance(content, str):
             body = content.encode()
-        elif isinstance(content, (bytes, bytearray)):
-            body = bytes(content)
+        elif isinstance(content, bytes):
+            body = content
+        elif isinstance(content, (bytearray, memoryview, mmap.mmap)):
+            # handed to libcurl in place, without a copy
+            body = _byte_view(content)
         elif hasattr(content, "read"):
             stream_reader = _FileReader(content)
             body = b""
@@ -660,7 +964,7 @@ def set_curl_options(
         and multipart is None
         and stream_reader is None
     ):
-        request_body = body
+        request_body = content if isinstance(body, memoryview) else body
     else:
         request_body = None
 
@@ -692,14 +996,20 @@ def set_curl_options(
     #   e.g. Elasticsearch, use this.
     if stream_reader is not None:
         c.setopt(CurlOpt.UPLOAD, 1)
-        c.setopt(CurlOpt.READDATA, stream_reader)
-        if isinstance(stream_reader, _FileReader) and stream_reader.rewindable:
-            c.setopt(CurlOpt.SEEKDATA, stream_reader)
+        source = (
+            stream_reader.native() if isinstance(stream_reader, _FileReader) else None
+        )
+        if source is not None:
+            c.setopt(CurlOpt.READDATA, source)
+        else:
+            c.setopt(CurlOpt.READDATA, stream_reader)
+            if isinstance(stream_reader, _FileReader) and stream_reader.rewindable:
+                c.setopt(CurlOpt.SEEKDATA, stream_reader)
         c.setopt(CurlOpt.CUSTOMREQUEST, method.encode())
     elif body or method in ("POST", "PUT", "PATCH"):
         c.setopt(CurlOpt.POSTFIELDS, body)
         # necessary if body contains '\0'
-        c.setopt(CurlOpt.POSTFIELDSIZE, len(body))
+        c.setopt(CurlOpt.POSTFIELDSIZE_LARGE, len(body))
         if method == "GET":
             c.setopt(CurlOpt.CUSTOMREQUEST, method)
 
@@ -742,7 +1052,10 @@ def set_curl_options(
         update_header_line(
             header_lines, "Content-Type", "application/x-www-form-urlencoded"
         )
-    if isinstance(body_data, (str, bytes, bytearray)) and body_data:
+    if (
+        isinstance(body_data, (str, bytes, bytearray, memoryview, mmap.mmap))
+        and body_data
+    ):
         update_header_line(header_lines, "Content-Type", "application/octet-stream")
 
     # Never send `Expect` header.
@@ -760,10 +1073,15 @@ def set_curl_options(
 
     # cookies
     c.setopt(CurlOpt.COOKIEFILE, b"")  # always enable the curl cookie engine first
-    c.setopt(CurlOpt.COOKIELIST, "ALL")  # remove all the old cookies first.
-
     base_cookies, cookies = cookies_list
 
+    if isinstance(base_cookies, CurlCookies) and share is not None:
+        # the engine shared by the handles of the session keeps the cookies already
+        base_cookies.sync_to_curl(c, urlparse(url).hostname or "", cookies)
+        cookies = base_cookies = None
+    else:
+        c.setopt(CurlOpt.COOKIELIST, "ALL")  # remove all the old cookies first.
+
     if base_cookies:
         for morsel in base_cookies.get_cookies_for_curl(req):  # type: ignore
             curl.setopt(CurlOpt.COOKIELIST, morsel.to_curl_format())
@@ -784,7 +1102,7 @@ def set_curl_options(
         # multipart will overrides postfields
         for k, v in cast(dict, data or {}).items():
             multipart.addpart(name=k, data=v.encode() if isinstance(v, str) else v)
-        c.setopt(CurlOpt.MIMEPOST, multipart._form)
+        c.setopt(CurlOpt.MIMEPOST, multipart)
 
     # auth
     if auth:
@@ -897,104 +1215,69 @@ def set_curl_options(
     if referer:
         c.setopt(CurlOpt.REFERER, referer.encode())
 
-    # accept_encoding
-    if accept_encoding is not None:
-        c.setopt(CurlOpt.ACCEPT_ENCODING, accept_encoding.encode())
-
-    # cert
-    if cert:
-        if isinstance(cert, str):
-            c.setopt(CurlOpt.SSLCERT, cert)
-        else:
-            cert, key = cert
-            c.setopt(CurlOpt.SSLCERT, cert)
-            c.setopt(CurlOpt.SSLKEY, key)
-
-    # http_version, before impersonation, which relies on checking if user wants http/3
-    if http_version:
-        http_version = normalize_http_version(http_version)
-        c.setopt(CurlOpt.HTTP_VERSION, http_version)
-
-    # impersonate
-    if impersonate:
-        if isinstance(impersonate, Fingerprint):
-            _apply_fingerprint(c, impersonate, existing_header_names, default_headers)
-        else:
-            if _is_native_impersonate_target(impersonate):
-                normalized = resolve_latest_browser_type(impersonate)
-                ret = c.impersonate(normalized, default_headers=default_headers)  # type: ignore
-                if ret != 0:
-                    raise ImpersonateError(
-                        f"Impersonating {normalized} is not supported"
-                    )
-            else:
-                fingerprint = _load_named_fingerprint(impersonate)
-                if fingerprint is None:
-                    raise ImpersonateError(
-                        f"Impersonating {impersonate} is not supported"
-                    )
-                _apply_fingerprint(
-                    c, fingerprint, existing_header_names, default_headers
-                )
+    # impersonate, the fingerprint itself is part of the template
+    if fingerprint is not None:
+        _apply_fingerprint_headers(
+            c, fingerprint, existing_header_names, default_headers
+        )
 
-    # ja3 string
-    if ja3:
-        if impersonate is not None:
+    if impersonate is not None:
+        if ja3:
             warnings.warn(
                 "JA3 fingerprint was altered after impersonated version was set.",
                 CurlCffiWarning,
                 stacklevel=1,
             )
-        permute = False
-        if isinstance(extra_fp, ExtraFingerprints) and extra_fp.tls_permute_extensions:
-            permute = True
-        if isinstance(extra_fp, dict) and extra_fp.get("tls_permute_extensions"):
-            permute = True
-        set_ja3_options(c, ja3, permute=permute)
-
-    # extra_fp options
-    if extra_fp:
-        if isinstance(extra_fp, dict):
-            extra_fp = ExtraFingerprints(**extra_fp)
-        if impersonate is not None:
+        if extra_fp:
             warnings.warn(
                 "Extra fingerprints were altered after impersonated version was set.",
                 CurlCffiWarning,
                 stacklevel=1,
             )
-        set_extra_fp(c, extra_fp)
-
-    # akamai string
-    if akamai:
-        if impersonate is not None:
+        if akamai:
             warnings.warn(
                 "Akamai fingerprint was altered after impersonated version was set.",
                 CurlCffiWarning,
                 stacklevel=1,
             )
-        set_akamai_options(c, akamai)
-
-    # perk string
-    if perk:
-        if impersonate is not None:
+        if perk:
             warnings.warn(
                 "Perk fingerprint was altered after impersonated version was set.",
                 CurlCffiWarning,
                 stacklevel=1,
             )
-        set_perk_options(c, perk)
+
+    if stream and stream_to is not None:
+        raise TypeError("Cannot specify both 'stream' and 'stream_to'")
 
     buffer = None
     q = None
     header_recved = None
     quit_now = None
-    if stream:
+    header_buffer = CurlHeaderBuffer()
+    if stream and stream_buffer_size:
+        header_recved = event_class()
+
+        def on_data():
+            if not header_recved.is_set():
+                header_buffer.blocks()
+                header_recved.set()
+
+        # libcurl writes into the ring in C and is paused while the ring is full,
+        # the queue stand-in hands out views of it and also serves as quit_now.
+        ring = CurlRingBuffer(stream_buffer_size)
+        q = quit_now = ring_queue_class(ring, c, on_data)
+        c.setopt(CurlOpt.WRITEDATA, ring)
+    elif stream:
         q = queue_class()
         header_recved = event_class()
         quit_now = event_class()
 
         def qput(chunk):
             if not header_recved.is_set():
+                # Take the snapshot while libcurl is blocked in this callback, the
+                # perform thread keeps writing trailers into the C buffer later.
+                header_buffer.blocks()
                 header_recved.set()
             if quit_now.is_set():
                 return CURL_WRITEFUNC_ERROR
@@ -1002,29 +1285,21 @@ def set_curl_options(
             return len(chunk)
 
         c.setopt(CurlOpt.WRITEFUNCTION, qput)
+    elif stream_to is not None:
+        # libcurl writes the body to the file in C, from where the file stands, so
+        # a partial download is resumed with a range request.
+        c.setopt(CurlOpt.WRITEDATA, CurlFileSink(stream_to))
+        offset = _file_position(stream_to)
+        if offset:
+            c.setopt(CurlOpt.RESUME_FROM_LARGE, offset)
     elif content_callback is not None:
         c.setopt(CurlOpt.WRITEFUNCTION, content_callback)
     else:
-        buffer = BytesIO()
+        # libcurl writes the body straight into C memory, no python callbacks
+        buffer = CurlBuffer()
         c.setopt(CurlOpt.WRITEDATA, buffer)
-    header_buffer = BytesIO()
     c.setopt(CurlOpt.HEADERDATA, header_buffer)
 
-    # interface
-    if interface:
-        value = interface
-        if "!" not in interface:
-            try:
-                ipaddress.ip_address(interface)
-            except ValueError:
-                pass
-            else:
-                value = f"host!{interface}"
-        c.setopt(CurlOpt.INTERFACE, value.encode())
-
-    if doh_url:
-        c.setopt(CurlOpt.DOH_URL, doh_url.encode())
-
     # max_recv_speed
     # do not check, since 0 is a valid value to disable it
     c.setopt(CurlOpt.MAX_RECV_SPEED_LARGE, max_recv_speed)
@@ -45,7 +45,7 @@ if TYPE_CHECKING:
     ON_ERROR_T = Callable[["WebSocket", CurlError], None]
     ON_OPEN_T = Callable[["WebSocket"], None]
     ON_CLOSE_T = Callable[["WebSocket", int, str], None]
-    RECV_QUEUE_ITEM = tuple[bytes, int]
+    RECV_QUEUE_ITEM = tuple[bytes | memoryview, int]
     SEND_QUEUE_ITEM = tuple[bytes | bytearray | memoryview, CurlWsFlag | int]
 
 
@@ -132,6 +132,54 @@ def _safe_set_result(fut: asyncio.Future[None]) -> None:
         pass
 
 
+# free space below which a message starts in a new arena, control frames must fit
+_ARENA_MIN_FREE = 256
+# max frames received by one call of the read loop into libcurl
+_RECV_BATCH_FRAMES = 64
+
+
+@final
+class _RecvArena:
+    """Received messages laid out back to back in a shared bytearray, for the zero
+    copy mode of ``AsyncWebSocket``.
+
+    Each message is a memoryview of its arena, which is freed with the last of them.
+    Fragments are appended in place, only a message overflowing its arena is copied,
+    once, to the start of a new one.
+    """
+
+    __slots__ = ("size", "view", "start", "pos")
+
+    def __init__(self, size: int) -> None:
+        self.size = size
+        self._renew(size)
+
+    def _renew(self, size: int) -> None:
+        self.view = memoryview(bytearray(size))
+        self.start = self.pos = 0
+
+    def free(self) -> memoryview:
+        """The space after the current message, to receive into."""
+        if len(self.view) - self.pos < _ARENA_MIN_FREE:
+            partial = self.view[self.start : self.pos]
+            self._renew(max(self.size, 2 * len(partial) + _ARENA_MIN_FREE))
+            self.view[: len(partial)] = partial
+            self.pos = len(partial)
+        return self.view[self.pos :]
+
+    def advance(self, n: int) -> None:
+        self.pos += n
+
+    def message(self) -> memoryview:
+        """Take the current message, the next one starts after it."""
+        message = self.view[self.start : self.pos]
+        self.start = self.pos
+        return message
+
+    def discard(self) -> None:
+        self.pos = self.start
+
+
 class BaseWebSocket:
     __slots__: tuple[str, ...] = (
         "_curl",
@@ -467,6 +515,64 @@ class WebSocket(BaseWebSocket):
 
         return b"".join(chunks), flags
 
+    def recv_into(self, buffer: bytearray | memoryview) -> tuple[int, int]:
+        """Receive a message into a writable ``buffer`` instead of new bytes.
+
+        Returns:
+            tuple[int, int]: the size of the message and its flags.
+
+        Raises:
+            WebSocketError: if the message does not fit in ``buffer``.
+        """
+        view = memoryview(buffer)
+        size: int = 0
+        flags: int = 0
+
+        sock_fd = self.curl.getinfo(CurlInfo.ACTIVESOCKET)
+        if sock_fd == CURL_SOCKET_BAD:
+            raise WebSocketError(
+                "Invalid active socket", CurlECode.NO_CONNECTION_AVAILABLE
+            )
+
+        while True:
+            if self.closed:
+                raise WebSocketClosed("WebSocket is already closed")
+            if size == len(view):
+                raise WebSocketError(
+                    f"Message larger than the buffer of {size} bytes",
+                    CurlECode.TOO_LARGE,
+                )
+            try:
+                n, frame = self.curl.ws_recv_into(view[size:])
+            except CurlError as e:
+                if e.code == CurlECode.AGAIN:
+                    _, _, _ = select([sock_fd], [], [], 0.5)
+                    continue
+                raise
+
+            if frame.flags & CurlWsFlag.CLOSE:
+                # handled, and the connection closed, like a received fragment
+                chunk = bytes(view[size : size + n])
+                try:
+                    self._close_code, self._close_reason = self._unpack_close_frame(
+                        chunk
+                    )
+                except WebSocketError as e:
+                    self._close_code = e.code
+                    self.close(e.code)
+                    raise
+                if self.autoclose:
+                    self.close()
+                view[:n] = chunk
+                return n, frame.flags
+            if frame.flags & (CurlWsFlag.PING | CurlWsFlag.PONG):
+                continue
+
+            flags = frame.flags
+            size += n
+            if frame.bytesleft == 0 and flags & CurlWsFlag.CONT == 0:
+                return size, flags
+
     def recv_str(self) -> str:
         """Receive a text frame."""
         data, flags = self.recv()
@@ -691,6 +797,8 @@ class AsyncWebSocket(BaseWebSocket):
         "_max_message_size",
         "drain_on_error",
         "_block_on_recv_queue_full",
+        "_zero_copy",
+        "_recv_buffer_size",
     )
 
     _MAX_CURL_FRAME_SIZE: Final[int] = 65536
@@ -712,6 +820,8 @@ class AsyncWebSocket(BaseWebSocket):
         max_message_size: int = 4 * 1024 * 1024,
         drain_on_error: bool = False,
         block_on_recv_queue_full: bool = True,
+        zero_copy: bool = False,
+        recv_buffer_size: int = 128 * 1024,
     ) -> None:
         """Initializes an Async WebSocket session.
 
@@ -744,6 +854,10 @@ class AsyncWebSocket(BaseWebSocket):
             block_on_recv_queue_full (bool): Behavior when the receive queue is full.
                 If True (default), the reader blocks (may cause timeouts).
                 If False, the connection fails immediately to prevent data loss.
+            zero_copy (bool): Receive straight into shared buffers of
+                ``recv_buffer_size`` bytes, and return the messages as read-only
+                memoryviews of them instead of bytes.
+            recv_buffer_size (int): Size of the buffer frames are received into.
 
         Note:
             Architecture: This uses a background I/O model. Network operations run in
@@ -782,6 +896,8 @@ class AsyncWebSocket(BaseWebSocket):
         self._max_message_size: int = max_message_size
         self.drain_on_error: bool = drain_on_error
         self._block_on_recv_queue_full: bool = block_on_recv_queue_full
+        self._zero_copy: bool = zero_copy
+        self._recv_buffer_size: int = recv_buffer_size
 
     @property
     def loop(self) -> asyncio.AbstractEventLoop:
@@ -924,7 +1040,8 @@ class AsyncWebSocket(BaseWebSocket):
             a timeout error.
 
         Returns:
-            tuple[bytes, int]: A tuple with the received payload and flags.
+            tuple[bytes, int]: A tuple with the received payload and flags. The
+            payload is a read-only memoryview with ``zero_copy``.
 
         Raises:
             WebSocketTimeout: If the timeout expires.
@@ -1036,7 +1153,7 @@ class AsyncWebSocket(BaseWebSocket):
         if not (flags & CurlWsFlag.TEXT):
             raise WebSocketError("Not a valid text frame", WsCloseCode.INVALID_DATA)
         try:
-            return data.decode("utf-8")
+            return str(data, "utf-8")
         except UnicodeDecodeError as e:
             raise WebSocketError(
                 "Invalid UTF-8 in text frame", WsCloseCode.INVALID_DATA
@@ -1332,9 +1449,11 @@ class AsyncWebSocket(BaseWebSocket):
         Attempts to read immediately and only registers an event loop reader if
         the socket returns EAGAIN (empty). It waits for the underlying socket to
         become readable, and upon being woken by the event loop, it drains all
-        buffered data from libcurl until it receives an EAGAIN error. This error
-        signals that the buffer is empty, and the loop returns to an idle state,
-        waiting for the next readability event. This is "optimistic reading".
+        buffered data from libcurl until it gets EAGAIN. This signals that the
+        buffer is empty, and the loop returns to an idle state, waiting for the
+        next readability event. This is "optimistic reading". Frames are received
+        in batches, each with a single call into C which returns a status code
+        rather than raising on EAGAIN.
 
         To ensure cooperative multitasking during high-volume message streams,
         the loop yields control to the asyncio event loop periodically which
@@ -1348,7 +1467,15 @@ class AsyncWebSocket(BaseWebSocket):
         """
 
         # Cache locals to avoid repeated attribute lookups
-        curl_ws_recv: Callable[[], tuple[bytes, CurlWsFrame]] = self.curl.ws_recv
+        curl_ws_recv_many: Callable[
+            [memoryview, int], tuple[int, list[tuple[int, int, int, int]]]
+        ] = self.curl.ws_recv_many
+        arena: _RecvArena | None = (
+            _RecvArena(self._recv_buffer_size) if self._zero_copy else None
+        )
+        recv_view: memoryview = memoryview(
+            bytearray(self._recv_buffer_size if arena is None else 0)
+        )
         queue_put_nowait: Callable[[RECV_QUEUE_ITEM], None] = (
             self._receive_queue.put_nowait
         )
@@ -1367,7 +1494,6 @@ class AsyncWebSocket(BaseWebSocket):
         max_retries: int = self.ws_retry.count
         retry_base: float = float(self.ws_retry.delay)
         e_again: int = int(CurlECode.AGAIN)
-        e_recv_err: int = int(CurlECode.RECV_ERROR)
         e_nothing: int = int(CurlECode.GOT_NOTHING)
         close_flag: int = int(CurlWsFlag.CLOSE)
         cont_flag: int = int(CurlWsFlag.CONT)
@@ -1388,120 +1514,81 @@ class AsyncWebSocket(BaseWebSocket):
 
         try:
             while not self.closed:
-                try:
-                    chunk, frame = curl_ws_recv()
-
-                except CurlError as e:
-                    should_retry: bool = False
-
-                    # Handle normal cURL EAGAINs
-                    if e.code == e_again:
-                        should_retry = True
-
-                    # EAGAIN ("errno 11") bubbling up as RECV_ERROR from BoringSSL
-                    elif e.code == e_recv_err:
-                        err_msg: str = str(e).lower()
-                        if (
-                            "errno 11" in err_msg
-                            or "resource temporarily unavailable" in err_msg
-                        ):
-                            should_retry = True
-
-                    # Handle Server Disconnect (Empty Reply)
-                    elif e.code == e_nothing:
-                        final_exc: WebSocketClosed = WebSocketClosed(
-                            "Connection closed unexpectedly by server (EOF)",
-                            WsCloseCode.ABNORMAL_CLOSURE,
-                        )
-                        final_exc.__cause__ = e
-                        final_exc.__suppress_context__ = True
-                        self._finalize_connection(final_exc)
-                        return
-
-                    if should_retry:
-                        read_future: asyncio.Future[None] = create_future()
-                        try:
-                            add_reader(self._sock_fd, set_fut_result, read_future)
-                            await read_future
-
-                        # pylint: disable-next=broad-exception-caught
-                        except Exception as exc:
+                # Drain as many frames as fit in the buffer with one call into C
+                buffer: memoryview = recv_view if arena is None else arena.free()
+                code, received = curl_ws_recv_many(buffer, _RECV_BATCH_FRAMES)
+                # End of the data collected in the arena, within the buffer
+                in_place: int = 0
+
+                for offset, length, flags, bytesleft in received:
+                    if recv_error_retries > 0:
+                        recv_error_retries = 0
+
+                    # Data Frames (Text / Binary / Cont)
+                    if flags & data_mask:
+                        # Perform message size checks
+                        msg_size += length
+                        if msg_size > max_msg_size:
+                            chunks_clear()
+                            if arena is not None:
+                                arena.discard()
                             self._finalize_connection(
                                 WebSocketError(
-                                    f"Socket closed unexpectedly: {exc}",
-                                    CurlECode.NO_CONNECTION_AVAILABLE,
+                                    (
+                                        f"Message too large: {msg_size} bytes "
+                                        f"(limit {max_msg_size} bytes). "
+                                        "Consider increasing max_message_size or "
+                                        "chunking the message."
+                                    ),
+                                    CurlECode.TOO_LARGE,
                                 )
                             )
                             return
 
-                        finally:
-                            if self._sock_fd != -1:
-                                try:  # noqa: SIM105
-                                    _ = remove_reader(self._sock_fd)
-                                # pylint: disable-next=broad-exception-caught
-                                except Exception:
-                                    pass
+                        # Collect the chunk, in place in zero copy mode, where it
+                        # only moves to close the gap left by a control frame
+                        if arena is None:
+                            chunks_append(bytes(buffer[offset : offset + length]))
+                        else:
+                            if offset != in_place:
+                                buffer[in_place : in_place + length] = buffer[
+                                    offset : offset + length
+                                ]
+                            in_place += length
+                            arena.advance(length)
+
+                        # If the message is complete, process and dispatch it
+                        if not (flags & cont_flag or bytesleft):
+                            message: bytes | memoryview
+                            if arena is None:
+                                message = (
+                                    chunks[0] if len(chunks) == 1 else b"".join(chunks)
+                                )
+                                chunks_clear()
+                            else:
+                                message = arena.message().toreadonly()
+                            msg_size = 0
 
-                        # Loop back to the top to try reading again
-                        continue
+                            try:
+                                queue_put_nowait((message, flags))
+                            except asyncio.QueueFull:
+                                if not block_on_recv:
+                                    self._finalize_connection(
+                                        WebSocketError(
+                                            queue_full_err, CurlECode.OUT_OF_MEMORY
+                                        )
+                                    )
+                                    return
+                                await queue_put((message, flags))
 
-                    # Apply the user-configured retry logic
-                    if (
-                        retry_on_error
-                        and e.code in retry_codes
-                        and recv_error_retries < max_retries
-                    ):
-                        recv_error_retries += 1
-                        # Formula: base * (2 ^ (attempt - 1))
-                        retry_delay: float = (  # pyright: ignore[reportAny]
-                            retry_base * (2 ** (recv_error_retries - 1))
-                        )
-                        # Add Jitter: +/- 10%
-                        jitter: float = retry_delay * 0.1
-                        retry_delay += uniform(-jitter, jitter)
-                        await asyncio.sleep(max(0.0, retry_delay))
                         continue
 
-                    # Fatal error - can't retry
-                    self._finalize_connection(e)
-                    return
-
-                flags: int = frame.flags
-                if recv_error_retries > 0:
-                    recv_error_retries = 0
-
-                # Data Frames (Text / Binary / Cont)
-                if flags & data_mask:
-                    # Perform message size checks
-                    msg_size += len(chunk)
-                    if msg_size > max_msg_size:
-                        chunks_clear()
-                        self._finalize_connection(
-                            WebSocketError(
-                                (
-                                    f"Message too large: {msg_size} bytes "
-                                    f"(limit {max_msg_size} bytes). "
-                                    "Consider increasing max_message_size or "
-                                    "chunking the message."
-                                ),
-                                CurlECode.TOO_LARGE,
-                            )
-                        )
-                        return
-
-                    # Collect the chunk
-                    chunks_append(chunk)
-
-                    # If the message is complete, process and dispatch it
-                    if not (flags & cont_flag or frame.bytesleft):
-                        message: bytes = (
-                            chunks[0] if len(chunks) == 1 else b"".join(chunks)
-                        )
+                    # If a CLOSE frame is received, the reader is done.
+                    if flags & close_flag:
                         chunks_clear()
-                        msg_size = 0
-
+                        chunk: bytes = bytes(buffer[offset : offset + length])
                         try:
-                            queue_put_nowait((message, flags))
+                            queue_put_nowait((chunk, flags))
                         except asyncio.QueueFull:
                             if not block_on_recv:
                                 self._finalize_connection(
@@ -1510,30 +1597,80 @@ class AsyncWebSocket(BaseWebSocket):
                                     )
                                 )
                                 return
-                            await queue_put((message, flags))
 
+                            await queue_put((chunk, flags))
+                        await self._handle_close_frame(chunk)
+                        return
+
+                # A limit of the batch was hit, there is more to read
+                if code == 0:
                     if loop_time() >= next_yield:
                         await asyncio.sleep(0)
                         next_yield = loop_time() + time_slice
-
                     continue
 
-                # If a CLOSE frame is received, the reader is done.
-                if flags & close_flag:
-                    chunks_clear()
+                # Nothing left to read, EAGAIN from the TLS layer included
+                if code == e_again:
+                    read_future: asyncio.Future[None] = create_future()
                     try:
-                        queue_put_nowait((chunk, flags))
-                    except asyncio.QueueFull:
-                        if not block_on_recv:
-                            self._finalize_connection(
-                                WebSocketError(queue_full_err, CurlECode.OUT_OF_MEMORY)
+                        add_reader(self._sock_fd, set_fut_result, read_future)
+                        await read_future
+
+                    # pylint: disable-next=broad-exception-caught
+                    except Exception as exc:
+                        self._finalize_connection(
+                            WebSocketError(
+                                f"Socket closed unexpectedly: {exc}",
+                                CurlECode.NO_CONNECTION_AVAILABLE,
                             )
-                            return
+                        )
+                        return
 
-                        await queue_put((chunk, flags))
-                    await self._handle_close_frame(chunk)
+                    finally:
+                        if self._sock_fd != -1:
+                            try:  # noqa: SIM105
+                                _ = remove_reader(self._sock_fd)
+                            # pylint: disable-next=broad-exception-caught
+                            except Exception:
+                                pass
+
+                    next_yield = loop_time() + time_slice
+                    continue
+
+                e: CurlError = self.curl._get_error(code, "WS_RECV")
+
+                # Handle Server Disconnect (Empty Reply)
+                if code == e_nothing:
+                    final_exc: WebSocketClosed = WebSocketClosed(
+                        "Connection closed unexpectedly by server (EOF)",
+                        WsCloseCode.ABNORMAL_CLOSURE,
+                    )
+                    final_exc.__cause__ = e
+                    final_exc.__suppress_context__ = True
+                    self._finalize_connection(final_exc)
                     return
 
+                # Apply the user-configured retry logic
+                if (
+                    retry_on_error
+                    and code in retry_codes
+                    and recv_error_retries < max_retries
+                ):
+                    recv_error_retries += 1
+                    # Formula: base * (2 ^ (attempt - 1))
+                    retry_delay: float = (  # pyright: ignore[reportAny]
+                        retry_base * (2 ** (recv_error_retries - 1))
+                    )
+                    # Add Jitter: +/- 10%
+                    jitter: float = retry_delay * 0.1
+                    retry_delay += uniform(-jitter, jitter)
+                    await asyncio.sleep(max(0.0, retry_delay))
+                    continue
+
+                # Fatal error - can't retry
+                self._finalize_connection(e)
+                return
+
         except asyncio.CancelledError:
             pass
 
@@ -1550,10 +1687,11 @@ class AsyncWebSocket(BaseWebSocket):
         check and enters one of two distinct processing strategies:
 
         1. Standard Mode (No Coalescing):
-            The default, low-latency path. Messages are consumed one-by-one
-            from the queue and transmitted immediately. This guarantees that one
-            ``send()`` call results in exactly one WebSocket message, preserving
-            logical message boundaries.
+            The default, low-latency path. Messages are transmitted as soon as they
+            are queued. This guarantees that one ``send()`` call results in exactly
+            one WebSocket message, preserving logical message boundaries. Messages
+            already pending in the queue (up to ``max_send_batch_size``) are handed
+            to libcurl with a single call, each still in its own frame.
 
         2. Coalescing Mode:
             An optimized throughput path for chatty streams. The loop greedily gathers
@@ -1573,6 +1711,10 @@ class AsyncWebSocket(BaseWebSocket):
         control_frame_flags: int = CurlWsFlag.CLOSE | CurlWsFlag.PING | CurlWsFlag.PONG
         close_flag: int = int(CurlWsFlag.CLOSE)
         send_payload: Callable[..., Awaitable[bool]] = self._send_payload
+        send_batch: Callable[[list[SEND_QUEUE_ITEM]], Awaitable[bool]] = (
+            self._send_batch
+        )
+        max_batch_size: int = self._max_send_batch_size
         queue_get: Callable[[], Awaitable[SEND_QUEUE_ITEM]] = self._send_queue.get
         queue_get_nowait: Callable[[], SEND_QUEUE_ITEM] = self._send_queue.get_nowait
         queue_done: Callable[[], None] = self._send_queue.task_done
@@ -1584,15 +1726,31 @@ class AsyncWebSocket(BaseWebSocket):
         try:
             # Hoist the branch - decide loop strategy once at start
             if not self._coalesce_frames:
-                # Optimized fast path, no batching overhead
+                # Optimized fast path, the messages pending at once are sent with
+                # one call into libcurl, without merging them
                 while True:
                     payload, flags = await queue_get()
 
+                    pending: list[SEND_QUEUE_ITEM] = [(payload, flags)]
+                    if not (flags & close_flag):
+                        while len(pending) < max_batch_size:
+                            try:
+                                payload, frame = queue_get_nowait()
+                                pending.append((payload, frame))
+                                if frame & close_flag:
+                                    break
+
+                            except asyncio.QueueEmpty:
+                                break
+
                     try:
-                        if not await send_payload(payload, flags):
+                        if len(pending) == 1:
+                            if not await send_payload(payload, flags):
+                                return
+                        elif not await send_batch(pending):
                             return
 
-                        if flags & close_flag:
+                        if pending[-1][1] & close_flag:
                             break
 
                         # Perform yield checks
@@ -1601,7 +1759,8 @@ class AsyncWebSocket(BaseWebSocket):
                             next_yield = loop_time() + time_slice
 
                     finally:
-                        queue_done()
+                        for _ in range(len(pending)):
+                            queue_done()
 
             else:
                 # Coalescing path: Batch multiple frames to merge payloads
@@ -1677,11 +1836,7 @@ class AsyncWebSocket(BaseWebSocket):
         curl_ws_send: Callable[[memoryview, CurlWsFlag | int], int] = self.curl.ws_send
         loop: asyncio.AbstractEventLoop = self.loop
         loop_time: Callable[[], float] = loop.time
-        create_future: Callable[[], asyncio.Future[None]] = loop.create_future
-        add_writer: Callable[..., None] = loop.add_writer
-        remove_writer: Callable[..., bool] = loop.remove_writer
-        set_fut_result: Callable[[asyncio.Future[None]], None] = _safe_set_result
-        sock_fd: int = self._sock_fd
+        wait_writable: Callable[[], Awaitable[bool]] = self._wait_writable
         time_slice: float = self._send_time_slice
         next_yield: float = loop_time() + time_slice
         max_frame_size: int = self._MAX_CURL_FRAME_SIZE
@@ -1744,29 +1899,9 @@ class AsyncWebSocket(BaseWebSocket):
             except CurlError as e:
                 if e.code == e_again:
                     # Wait for socket to be writable
-                    write_future: asyncio.Future[None] = create_future()
-                    try:
-                        add_writer(sock_fd, set_fut_result, write_future)
-                        await write_future
-
-                    # pylint: disable-next=broad-exception-caught
-                    except Exception as exc:
-                        self._finalize_connection(
-                            WebSocketError(
-                                f"Socket closed unexpectedly during write: {exc}",
-                                CurlECode.NO_CONNECTION_AVAILABLE,
-                            )
-                        )
+                    if not await wait_writable():
                         return False
 
-                    finally:
-                        if sock_fd != -1:
-                            try:  # noqa: SIM105
-                                _ = remove_writer(sock_fd)
-                            # pylint: disable-next=broad-exception-caught
-                            except Exception:
-                                pass
-
                     # Retry the exact same chunk
                     continue
 
@@ -1776,6 +1911,101 @@ class AsyncWebSocket(BaseWebSocket):
 
         return True
 
+    async def _send_batch(self, batch: list[SEND_QUEUE_ITEM]) -> bool:
+        """
+        Sends several messages, each in its own frame, with as few calls into
+        libcurl as possible. Messages larger than a frame are sent on their own.
+        """
+        max_frame_size: int = self._MAX_CURL_FRAME_SIZE
+        frames: list[SEND_QUEUE_ITEM] = []
+
+        for payload, flags in batch:
+            if memoryview(payload).nbytes <= max_frame_size:
+                frames.append((payload, flags))
+                continue
+
+            # Flush the frames before it to keep the order
+            if frames and not await self._send_frames(frames):
+                return False
+            frames = []
+            if not await self._send_payload(payload, flags):
+                return False
+
+        return not frames or await self._send_frames(frames)
+
+    async def _send_frames(self, frames: list[SEND_QUEUE_ITEM]) -> bool:
+        """
+        Sends the ``(payload, flags)`` frames, resuming where libcurl stopped
+        whenever the socket is full.
+        """
+        curl_ws_send_many: Callable[..., tuple[int, int, int]] = (
+            self.curl.ws_send_many
+        )
+        wait_writable: Callable[[], Awaitable[bool]] = self._wait_writable
+        e_again: int = int(CurlECode.AGAIN)
+        max_zero_writes: int = 3
+        count: int = len(frames)
+        sent: int = 0
+        offset: int = 0
+        write_retries: int = 0
+
+        while True:
+            before: tuple[int, int] = (sent, offset)
+            code, sent, offset = curl_ws_send_many(frames, sent, offset)
+            if sent == count:
+                return True
+
+            if (sent, offset) != before:
+                write_retries = 0
+
+            if code == 0:
+                # libcurl took none of the bytes of a frame
+                write_retries += 1
+                if write_retries >= max_zero_writes:
+                    self._finalize_connection(
+                        WebSocketError(
+                            f"Writer stalled ({write_retries} attempts).",
+                            CurlECode.WRITE_ERROR,
+                        )
+                    )
+                    return False
+
+            elif code != e_again:
+                self._finalize_connection(self.curl._get_error(code, "WS_SEND"))
+                return False
+
+            if not await wait_writable():
+                return False
+
+    async def _wait_writable(self) -> bool:
+        """Waits for the socket to be writable, False if the connection failed."""
+        sock_fd: int = self._sock_fd
+        loop: asyncio.AbstractEventLoop = self.loop
+        write_future: asyncio.Future[None] = loop.create_future()
+        try:
+            loop.add_writer(sock_fd, _safe_set_result, write_future)
+            await write_future
+
+        # pylint: disable-next=broad-exception-caught
+        except Exception as exc:
+            self._finalize_connection(
+                WebSocketError(
+                    f"Socket closed unexpectedly during write: {exc}",
+                    CurlECode.NO_CONNECTION_AVAILABLE,
+                )
+            )
+            return False
+
+        finally:
+            if sock_fd != -1:
+                try:  # noqa: SIM105
+                    _ = loop.remove_writer(sock_fd)
+                # pylint: disable-next=broad-exception-caught
+                except Exception:
+                    pass
+
+        return True
+
     async def flush(self, timeout: float | None = None) -> None:
         """Waits until all items in the send queue have been processed.
 
@@ -1879,7 +2109,7 @@ class AsyncWebSocket(BaseWebSocket):
             super().terminate()
             if self.session and not self.session._closed:
                 # WebSocket curls CANNOT be reused
-                self.session.push_curl(None)
+                self.session.discard_curl(self.curl)
 
         finally:
             self._terminated_event.set()
@@ -28,6 +28,86 @@ extern "Python" size_t read_callback(void *ptr, size_t size, size_t nmemb, void
 extern "Python" int seek_buffer_callback(void *userdata, int64_t offset, int origin);
 extern "Python" int debug_function(void *curl, int type, char *data, size_t size, void *clientp);
 
+// native write sink, see shim.c
+struct curl_cffi_buffer {
+    char *data;
+    size_t size;
+    size_t capacity;
+};
+struct curl_cffi_buffer *_curl_buffer_new(size_t capacity);
+void _curl_buffer_free(struct curl_cffi_buffer *buffer);
+void _curl_buffer_clear(struct curl_cffi_buffer *buffer);
+size_t _curl_buffer_write(char *ptr, size_t size, size_t nmemb, void *userdata);
+
+// native header collector, see shim.c
+struct curl_cffi_headers {
+    struct curl_cffi_buffer data;
+    size_t *fields;
+    size_t nfields;
+    size_t *blocks;
+    size_t nblocks;
+    ...;
+};
+struct curl_cffi_headers *_curl_headers_new(void);
+void _curl_headers_free(struct curl_cffi_headers *headers);
+void _curl_headers_clear(struct curl_cffi_headers *headers);
+size_t _curl_headers_write(char *ptr, size_t size, size_t nmemb, void *userdata);
+
+// batch getinfo, see shim.c
+union curl_cffi_info {
+    char *string;
+    long number;
+    double real;
+    int64_t offset;
+    struct curl_slist *list;
+};
+int _curl_easy_getinfo_many(void *curl, const int *options, union curl_cffi_info *values, size_t count);
+
+// neutral callbacks used by soft reset
+size_t _curl_discard_write(char *ptr, size_t size, size_t nmemb, void *userdata);
+size_t _curl_empty_read(char *ptr, size_t size, size_t nmemb, void *userdata);
+
+struct curl_cffi_ring {
+    char *data;
+    size_t capacity;
+    size_t start;
+    size_t size;
+    size_t pending;
+    int closed;
+    int deferred;
+    char *spill;
+    ...;
+};
+
+struct curl_cffi_ring *_curl_ring_new(char *data, size_t capacity);
+void _curl_ring_free(struct curl_cffi_ring *ring);
+void _curl_ring_consume(struct curl_cffi_ring *ring, size_t len);
+size_t _curl_ring_publish(struct curl_cffi_ring *ring);
+size_t _curl_ring_write(char *ptr, size_t size, size_t nmemb, void *userdata);
+
+struct curl_cffi_file {
+    int fd;
+    int error;
+    int64_t written;
+};
+
+struct curl_cffi_file *_curl_file_new(int fd);
+void _curl_file_free(struct curl_cffi_file *file);
+size_t _curl_file_write(char *ptr, size_t size, size_t nmemb, void *userdata);
+
+struct curl_cffi_fd_reader {
+    int fd;
+    int error;
+    int64_t start;
+    int64_t length;
+    int64_t offset;
+};
+
+struct curl_cffi_fd_reader *_curl_fd_reader_new(int fd, int64_t start, int64_t length);
+void _curl_fd_reader_free(struct curl_cffi_fd_reader *reader);
+size_t _curl_fd_read(char *buffer, size_t size, size_t nitems, void *userdata);
+int _curl_fd_seek(void *userdata, int64_t offset, int origin);
+
 // multi interfaces
 struct CURLMsg {
    int msg;       /* what this message means */
@@ -53,8 +133,57 @@ const char *curl_multi_strerror(int code);
 struct CURLMsg *curl_multi_info_read(void* curlm, int *msg_in_queue);
 
 // multi callbacks
-extern "Python" int socket_function(void *curl, int sockfd, int what, void *clientp, void *socketp);
-extern "Python" int timer_function(void *curlm, int timeout_ms, void *clientp);
+extern "Python" void multi_events_callback(void *clientp);
+
+// multi events collected in C
+struct curl_cffi_sock_event {
+    int64_t fd;
+    int what;
+    int removed;
+};
+
+struct curl_cffi_done {
+    void *easy;
+    int result;
+};
+
+struct curl_cffi_multi_events {
+    struct curl_cffi_sock_event *socks;
+    size_t nsocks;
+    size_t socks_capacity;
+    struct curl_cffi_done *done;
+    size_t ndone;
+    size_t done_capacity;
+    long timeout_ms;
+    int timer_set;
+    int running;
+    int busy;
+    int notified;
+    void (*notify)(void *clientp);
+    void *clientp;
+};
+
+struct curl_cffi_multi_events *_curl_multi_events_new(void *curlm, void (*notify)(void *clientp), void *clientp);
+void _curl_multi_events_free(struct curl_cffi_multi_events *events);
+int _curl_multi_action(void *curlm, struct curl_cffi_multi_events *events, int64_t sockfd, int ev_bitmask);
+int _curl_multi_perform(void *curlm, struct curl_cffi_multi_events *events);
+
+// share interfaces
+const char *curl_share_strerror(int code);
+
+// share with locking done in C
+struct curl_cffi_share {
+    void *share;
+    ...;
+};
+
+struct curl_cffi_share *_curl_share_new(void);
+int _curl_share_add(struct curl_cffi_share *share, int data);
+int _curl_share_free(struct curl_cffi_share *share);
+
+// TLS session export and import, see shim.c
+int _curl_ssls_export(void *curl, struct curl_cffi_buffer *out);
+int _curl_ssls_import(void *curl, const char *data, size_t len, size_t *imported);
 
 // websocket
 struct curl_ws_frame {
@@ -69,6 +198,23 @@ struct curl_ws_frame {
 int curl_ws_recv(void *curl, void *buffer, size_t buflen, size_t *recv, const struct curl_ws_frame **meta);
 int curl_ws_send(void *curl, const void *buffer, size_t buflen, size_t *sent, int fragsize, unsigned int sendflags);
 
+// batched websocket receive and send, see shim.c
+struct curl_cffi_ws_chunk {
+    size_t offset;
+    size_t len;
+    int flags;
+    int64_t bytesleft;
+};
+
+struct curl_cffi_ws_send_frame {
+    const char *buffer;
+    size_t len;
+    int flags;
+};
+
+int _curl_ws_recv_many(void *curl, char *buffer, size_t buflen, struct curl_cffi_ws_chunk *chunks, size_t max_chunks, size_t *nchunks);
+int _curl_ws_send_many(void *curl, const struct curl_cffi_ws_send_frame *frames, size_t count, size_t *nsent, size_t *offset);
+
 // mime
 void *curl_mime_init(void* curl);  // -> form
 void *curl_mime_addpart(void *form);  // -> part/field
@@ -77,4 +223,5 @@ int curl_mime_data(void *field, char *name, int datasize);
 int curl_mime_type(void *field, char *type);
 int curl_mime_filename(void *field, char *filename);
 int curl_mime_filedata(void *field, char *filename);
+int curl_mime_data_cb(void *field, int64_t datasize, void *readfunc, void *seekfunc, void *freefunc, void *arg);
 void curl_mime_free(void *form);
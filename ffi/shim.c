@@ -1,6 +1,28 @@
 
 #include "shim.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#define write _write
+#define read _read
+#else
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+#define _curl_cffi_mutex_init(m) InitializeCriticalSection(m)
+#define _curl_cffi_mutex_destroy(m) DeleteCriticalSection(m)
+#define _curl_cffi_mutex_lock(m) EnterCriticalSection(m)
+#define _curl_cffi_mutex_unlock(m) LeaveCriticalSection(m)
+#else
+#define _curl_cffi_mutex_init(m) pthread_mutex_init(m, NULL)
+#define _curl_cffi_mutex_destroy(m) pthread_mutex_destroy(m)
+#define _curl_cffi_mutex_lock(m) pthread_mutex_lock(m)
+#define _curl_cffi_mutex_unlock(m) pthread_mutex_unlock(m)
+#endif
+
 int _curl_easy_setopt(void* curl, int option, void* parameter) {
     // printf("****** hijack test begins: \n");
     // int val = curl_easy_setopt(instance->curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_0);
@@ -16,3 +38,926 @@ int _curl_easy_setopt(void* curl, int option, void* parameter) {
     }
     return (int)curl_easy_setopt(curl, (CURLoption)option, parameter);
 }
+
+static int _curl_buffer_reserve(struct curl_cffi_buffer *buffer, size_t needed) {
+    size_t capacity;
+    char *data;
+    if (needed <= buffer->capacity) {
+        return 0;
+    }
+    capacity = buffer->capacity ? buffer->capacity : 16 * 1024;
+    while (capacity < needed) {
+        if (capacity > ((size_t)-1) / 2) {
+            capacity = needed;
+            break;
+        }
+        capacity *= 2;
+    }
+    data = (char *)realloc(buffer->data, capacity);
+    if (data == NULL) {
+        return -1;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return 0;
+}
+
+struct curl_cffi_buffer *_curl_buffer_new(size_t capacity) {
+    struct curl_cffi_buffer *buffer;
+    buffer = (struct curl_cffi_buffer *)calloc(1, sizeof(struct curl_cffi_buffer));
+    if (buffer == NULL) {
+        return NULL;
+    }
+    if (capacity && _curl_buffer_reserve(buffer, capacity) != 0) {
+        free(buffer);
+        return NULL;
+    }
+    return buffer;
+}
+
+void _curl_buffer_free(struct curl_cffi_buffer *buffer) {
+    if (buffer == NULL) {
+        return;
+    }
+    free(buffer->data);
+    free(buffer);
+}
+
+void _curl_buffer_clear(struct curl_cffi_buffer *buffer) {
+    buffer->size = 0;
+}
+
+// CURLOPT_WRITEFUNCTION compatible, returning less than requested aborts the
+// transfer with CURLE_WRITE_ERROR, which is what we want when out of memory.
+size_t _curl_buffer_write(char *ptr, size_t size, size_t nmemb, void *userdata) {
+    struct curl_cffi_buffer *buffer = (struct curl_cffi_buffer *)userdata;
+    size_t len = size * nmemb;
+    if (len == 0) {
+        return 0;
+    }
+    if (len > ((size_t)-1) - buffer->size) {
+        return 0;
+    }
+    if (_curl_buffer_reserve(buffer, buffer->size + len) != 0) {
+        return 0;
+    }
+    memcpy(buffer->data + buffer->size, ptr, len);
+    buffer->size += len;
+    return len;
+}
+
+static int _curl_array_reserve(size_t **array, size_t *capacity, size_t needed) {
+    size_t new_capacity;
+    size_t *data;
+    if (needed <= *capacity) {
+        return 0;
+    }
+    new_capacity = *capacity ? *capacity * 2 : 64;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    data = (size_t *)realloc(*array, new_capacity * sizeof(size_t));
+    if (data == NULL) {
+        return -1;
+    }
+    *array = data;
+    *capacity = new_capacity;
+    return 0;
+}
+
+static int _curl_buffer_append(struct curl_cffi_buffer *buffer, const char *ptr, size_t len) {
+    if (len == 0) {
+        return 0;
+    }
+    return _curl_buffer_write((char *)ptr, 1, len, buffer) == len ? 0 : -1;
+}
+
+static int _curl_is_space(char c) {
+    // same as python's bytes.strip()
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static int _curl_is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// trim [start, end) of the data buffer into the last field's value
+static void _curl_headers_set_value(struct curl_cffi_headers *headers, size_t start) {
+    const char *data = headers->data.data;
+    size_t end = headers->data.size;
+    size_t *field = headers->fields + (headers->nfields - 1) * CURL_CFFI_FIELD_WIDTH;
+    while (start < end && _curl_is_space(data[start])) {
+        start++;
+    }
+    while (end > start && _curl_is_space(data[end - 1])) {
+        end--;
+    }
+    field[2] = start;
+    field[3] = end - start;
+}
+
+static int _curl_headers_add_block(struct curl_cffi_headers *headers, size_t status,
+                                   const char *reason, size_t reason_len) {
+    size_t *block;
+    size_t needed = (headers->nblocks + 1) * CURL_CFFI_BLOCK_WIDTH;
+    if (_curl_array_reserve(&headers->blocks, &headers->blocks_capacity, needed) != 0) {
+        return -1;
+    }
+    block = headers->blocks + headers->nblocks * CURL_CFFI_BLOCK_WIDTH;
+    block[0] = status;
+    block[1] = headers->data.size;
+    block[2] = reason_len;
+    block[3] = headers->nfields;
+    block[4] = 0;
+    headers->nblocks++;
+    return _curl_buffer_append(&headers->data, reason, reason_len);
+}
+
+static int _curl_headers_status_line(struct curl_cffi_headers *headers,
+                                     const char *line, size_t len) {
+    size_t i = 0;
+    size_t status = 0;
+    const char *reason = NULL;
+    size_t reason_len = 0;
+
+    // status code is the second whitespace separated token
+    while (i < len && !_curl_is_space(line[i])) {
+        i++;
+    }
+    while (i < len && _curl_is_space(line[i])) {
+        i++;
+    }
+    if (i < len && _curl_is_digit(line[i])) {
+        size_t j = i;
+        while (j < len && _curl_is_digit(line[j])) {
+            status = status * 10 + (size_t)(line[j] - '0');
+            j++;
+        }
+        if (j < len && !_curl_is_space(line[j])) {
+            status = 0;
+        }
+    }
+
+    // reason phrase only for "HTTP/x.y nnn reason", e.g. HTTP/2 has none
+    if (len >= 13 && _curl_is_digit(line[5]) && line[6] == '.' &&
+        _curl_is_digit(line[7]) && line[8] == ' ' && _curl_is_digit(line[9]) &&
+        _curl_is_digit(line[10]) && _curl_is_digit(line[11]) && line[12] == ' ') {
+        reason = line + 13;
+        reason_len = len - 13;
+    }
+    return _curl_headers_add_block(headers, status, reason, reason_len);
+}
+
+static int _curl_headers_line(struct curl_cffi_headers *headers, const char *line, size_t len) {
+    size_t i;
+    size_t *field;
+    size_t *block;
+
+    for (i = 0; i < len && _curl_is_space(line[i]); i++) {
+    }
+    // blank line, e.g. the end of a header block
+    if (i == len) {
+        return 0;
+    }
+
+    if (len >= 5 && memcmp(line, "HTTP/", 5) == 0) {
+        return _curl_headers_status_line(headers, line, len);
+    }
+
+    block = headers->nblocks
+        ? headers->blocks + (headers->nblocks - 1) * CURL_CFFI_BLOCK_WIDTH
+        : NULL;
+
+    // obsolete line folding, append to the previous value
+    if (line[0] == ' ' || line[0] == '\t') {
+        if (block == NULL || block[4] == 0) {
+            return 0;
+        }
+        if (_curl_buffer_append(&headers->data, line, len) != 0) {
+            return -1;
+        }
+        _curl_headers_set_value(headers, headers->value_start);
+        return 0;
+    }
+
+    for (i = 0; i < len && line[i] != ':'; i++) {
+    }
+    if (i == len) {
+        return 0;
+    }
+
+    // headers before any status line, keep them in an anonymous block
+    if (block == NULL) {
+        if (_curl_headers_add_block(headers, 0, NULL, 0) != 0) {
+            return -1;
+        }
+        block = headers->blocks;
+    }
+
+    if (_curl_array_reserve(&headers->fields, &headers->fields_capacity,
+                            (headers->nfields + 1) * CURL_CFFI_FIELD_WIDTH) != 0) {
+        return -1;
+    }
+    field = headers->fields + headers->nfields * CURL_CFFI_FIELD_WIDTH;
+    field[0] = headers->data.size;
+    field[1] = i;
+    if (_curl_buffer_append(&headers->data, line, i) != 0) {
+        return -1;
+    }
+    headers->value_start = headers->data.size;
+    if (_curl_buffer_append(&headers->data, line + i + 1, len - i - 1) != 0) {
+        return -1;
+    }
+    headers->nfields++;
+    block[4]++;
+    _curl_headers_set_value(headers, headers->value_start);
+    return 0;
+}
+
+struct curl_cffi_headers *_curl_headers_new(void) {
+    return (struct curl_cffi_headers *)calloc(1, sizeof(struct curl_cffi_headers));
+}
+
+void _curl_headers_free(struct curl_cffi_headers *headers) {
+    if (headers == NULL) {
+        return;
+    }
+    free(headers->data.data);
+    free(headers->fields);
+    free(headers->blocks);
+    free(headers);
+}
+
+void _curl_headers_clear(struct curl_cffi_headers *headers) {
+    headers->data.size = 0;
+    headers->nfields = 0;
+    headers->nblocks = 0;
+    headers->value_start = 0;
+}
+
+// CURLOPT_HEADERFUNCTION compatible, libcurl passes one complete line per call,
+// but we split on LF anyway to be safe.
+size_t _curl_headers_write(char *ptr, size_t size, size_t nmemb, void *userdata) {
+    struct curl_cffi_headers *headers = (struct curl_cffi_headers *)userdata;
+    size_t len = size * nmemb;
+    size_t start = 0;
+    size_t i;
+
+    for (i = 0; i <= len; i++) {
+        size_t end;
+        if (i < len && ptr[i] != '\n') {
+            continue;
+        }
+        end = i;
+        if (end > start && ptr[end - 1] == '\r') {
+            end--;
+        }
+        if (end > start && _curl_headers_line(headers, ptr + start, end - start) != 0) {
+            return 0;
+        }
+        start = i + 1;
+    }
+    return len;
+}
+
+// Fills values[i] according to the type encoded in options[i], returns the first
+// error code, but keeps going so that one missing info does not hide the others.
+int _curl_easy_getinfo_many(void *curl, const int *options, union curl_cffi_info *values,
+                            size_t count) {
+    int ret = CURLE_OK;
+    size_t i;
+    for (i = 0; i < count; i++) {
+        CURLINFO option = (CURLINFO)options[i];
+        int code;
+        memset(&values[i], 0, sizeof(union curl_cffi_info));
+        switch (options[i] & CURLINFO_TYPEMASK) {
+        case CURLINFO_STRING:
+            code = (int)curl_easy_getinfo(curl, option, &values[i].string);
+            break;
+        case CURLINFO_LONG:
+            code = (int)curl_easy_getinfo(curl, option, &values[i].number);
+            break;
+        case CURLINFO_DOUBLE:
+            code = (int)curl_easy_getinfo(curl, option, &values[i].real);
+            break;
+        case CURLINFO_SLIST:
+            code = (int)curl_easy_getinfo(curl, option, &values[i].list);
+            break;
+        case CURLINFO_SOCKET: {
+            curl_socket_t sockfd = 0;
+            code = (int)curl_easy_getinfo(curl, option, &sockfd);
+            values[i].number = (long)sockfd;
+            break;
+        }
+        case CURLINFO_OFF_T:
+            code = (int)curl_easy_getinfo(curl, option, &values[i].offset);
+            break;
+        default:
+            code = CURLE_BAD_FUNCTION_ARGUMENT;
+        }
+        if (code != CURLE_OK && ret == CURLE_OK) {
+            ret = code;
+        }
+    }
+    return ret;
+}
+
+size_t _curl_discard_write(char *ptr, size_t size, size_t nmemb, void *userdata) {
+    (void)ptr;
+    (void)userdata;
+    return size * nmemb;
+}
+
+size_t _curl_empty_read(char *ptr, size_t size, size_t nmemb, void *userdata) {
+    (void)ptr;
+    (void)size;
+    (void)nmemb;
+    (void)userdata;
+    return 0;
+}
+
+struct curl_cffi_ring *_curl_ring_new(char *data, size_t capacity) {
+    struct curl_cffi_ring *ring;
+    if (data == NULL || capacity == 0) {
+        return NULL;
+    }
+    ring = (struct curl_cffi_ring *)calloc(1, sizeof(struct curl_cffi_ring));
+    if (ring == NULL) {
+        return NULL;
+    }
+    ring->data = data;
+    ring->capacity = capacity;
+    _curl_cffi_mutex_init(&ring->lock);
+    return ring;
+}
+
+void _curl_ring_free(struct curl_cffi_ring *ring) {
+    if (ring == NULL) {
+        return;
+    }
+    _curl_cffi_mutex_destroy(&ring->lock);
+    // `data` belongs to the caller, views of it may outlive the ring
+    free(ring->spill);
+    free(ring);
+}
+
+// Appends `len` bytes, which must fit, after the bytes already in the ring. They
+// are only counted as readable when `publish` is set and none are staged before
+// them, so that the readers always see them in order.
+static void _curl_ring_put(struct curl_cffi_ring *ring, const char *ptr, size_t len,
+                           int publish) {
+    size_t end = (ring->start + ring->size + ring->staged) % ring->capacity;
+    size_t first = ring->capacity - end;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(ring->data + end, ptr, first);
+    memcpy(ring->data, ptr + first, len - first);
+    if (publish && ring->staged == 0) {
+        ring->size += len;
+    } else {
+        ring->staged += len;
+    }
+}
+
+// Moves what fits of the spilled chunk into the ring.
+static void _curl_ring_unspill(struct curl_cffi_ring *ring) {
+    size_t n = ring->spill_len - ring->spill_off;
+    size_t room = ring->capacity - ring->size - ring->staged;
+    if (n > room) {
+        n = room;
+    }
+    _curl_ring_put(ring, ring->spill + ring->spill_off, n, 1);
+    ring->spill_off += n;
+    if (ring->spill_off == ring->spill_len) {
+        free(ring->spill);
+        ring->spill = NULL;
+        ring->spill_len = 0;
+        ring->spill_off = 0;
+    }
+}
+
+void _curl_ring_consume(struct curl_cffi_ring *ring, size_t len) {
+    _curl_cffi_mutex_lock(&ring->lock);
+    if (len > ring->size) {
+        len = ring->size;
+    }
+    ring->size -= len;
+    if (ring->size == 0 && ring->staged == 0) {
+        // restart at the beginning, so that readers get larger contiguous slices
+        ring->start = 0;
+    } else {
+        ring->start = (ring->start + len) % ring->capacity;
+    }
+    if (ring->spill != NULL) {
+        _curl_ring_unspill(ring);
+    }
+    _curl_cffi_mutex_unlock(&ring->lock);
+}
+
+// Makes the staged bytes visible to the readers, returns how many there were.
+size_t _curl_ring_publish(struct curl_cffi_ring *ring) {
+    size_t staged;
+    _curl_cffi_mutex_lock(&ring->lock);
+    staged = ring->staged;
+    ring->size += staged;
+    ring->staged = 0;
+    _curl_cffi_mutex_unlock(&ring->lock);
+    return staged;
+}
+
+// CURLOPT_WRITEFUNCTION compatible. A chunk is either stored entirely or refused
+// with CURL_WRITEFUNC_PAUSE, libcurl then delivers the same chunk again after the
+// transfer is unpaused. The size of the refused chunk is kept in `pending`, so
+// that the reader knows when to unpause. Once the reader closed the ring, the
+// transfer is aborted with a write error.
+//
+// The memory of the ring is never moved nor freed here, the readers may hold views
+// of it. A chunk larger than the whole ring is taken when the ring is empty, what
+// does not fit is spilled into a private buffer, moved into the ring as the
+// readers consume it.
+size_t _curl_ring_write(char *ptr, size_t size, size_t nmemb, void *userdata) {
+    struct curl_cffi_ring *ring = (struct curl_cffi_ring *)userdata;
+    size_t len = size * nmemb;
+    size_t used;
+    if (ring->closed) {
+        return 0;
+    }
+    // the readers only touch the published bytes, which this never overwrites
+    _curl_cffi_mutex_lock(&ring->lock);
+    used = ring->size + ring->staged;
+    if (ring->spill != NULL || (len > ring->capacity - used && used != 0)) {
+        ring->pending = len;
+        _curl_cffi_mutex_unlock(&ring->lock);
+        return CURL_WRITEFUNC_PAUSE;
+    }
+    if (len > ring->capacity) {
+        ring->spill = (char *)malloc(len - ring->capacity);
+        if (ring->spill == NULL) {
+            _curl_cffi_mutex_unlock(&ring->lock);
+            return 0;
+        }
+        memcpy(ring->spill, ptr + ring->capacity, len - ring->capacity);
+        ring->spill_len = len - ring->capacity;
+        ring->spill_off = 0;
+    }
+    ring->pending = 0;
+    _curl_ring_put(ring, ptr, len > ring->capacity ? ring->capacity : len,
+                   !ring->deferred);
+    _curl_cffi_mutex_unlock(&ring->lock);
+    return len;
+}
+
+struct curl_cffi_file *_curl_file_new(int fd) {
+    struct curl_cffi_file *file;
+    file = (struct curl_cffi_file *)calloc(1, sizeof(struct curl_cffi_file));
+    if (file == NULL) {
+        return NULL;
+    }
+    file->fd = fd;
+#ifdef POSIX_FADV_SEQUENTIAL
+    // a hint only, larger read ahead for whoever reads the file next
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    return file;
+}
+
+void _curl_file_free(struct curl_cffi_file *file) {
+    free(file);
+}
+
+// CURLOPT_WRITEFUNCTION compatible, short writes are retried, any other failure
+// aborts the transfer with CURLE_WRITE_ERROR and leaves errno in `error`.
+size_t _curl_file_write(char *ptr, size_t size, size_t nmemb, void *userdata) {
+    struct curl_cffi_file *file = (struct curl_cffi_file *)userdata;
+    size_t len = size * nmemb;
+    size_t done = 0;
+    while (done < len) {
+#ifdef _WIN32
+        int wrote = write(file->fd, ptr + done, (unsigned int)(len - done));
+#else
+        ssize_t wrote = write(file->fd, ptr + done, len - done);
+#endif
+        if (wrote < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            file->error = errno;
+            return 0;
+        }
+        done += (size_t)wrote;
+        file->written += (curl_off_t)wrote;
+    }
+    return len;
+}
+
+struct curl_cffi_fd_reader *_curl_fd_reader_new(int fd, curl_off_t start, curl_off_t length) {
+    struct curl_cffi_fd_reader *reader;
+    reader = (struct curl_cffi_fd_reader *)calloc(1, sizeof(struct curl_cffi_fd_reader));
+    if (reader == NULL) {
+        return NULL;
+    }
+    reader->fd = fd;
+    reader->start = start;
+    reader->length = length;
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, (off_t)start, (off_t)length, POSIX_FADV_SEQUENTIAL);
+#endif
+    return reader;
+}
+
+void _curl_fd_reader_free(struct curl_cffi_fd_reader *reader) {
+    free(reader);
+}
+
+// CURLOPT_READFUNCTION compatible, stops at `length` even if the file grows.
+size_t _curl_fd_read(char *buffer, size_t size, size_t nitems, void *userdata) {
+    struct curl_cffi_fd_reader *reader = (struct curl_cffi_fd_reader *)userdata;
+    size_t len = size * nitems;
+    curl_off_t left = reader->length - reader->offset;
+    if (left <= 0) {
+        return 0;
+    }
+    if ((curl_off_t)len > left) {
+        len = (size_t)left;
+    }
+    for (;;) {
+#ifdef _WIN32
+        int got;
+        if (_lseeki64(reader->fd, reader->start + reader->offset, SEEK_SET) < 0) {
+            reader->error = errno;
+            return CURL_READFUNC_ABORT;
+        }
+        got = read(reader->fd, buffer, (unsigned int)len);
+#else
+        ssize_t got = pread(reader->fd, buffer, len, (off_t)(reader->start + reader->offset));
+#endif
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            reader->error = errno;
+            return CURL_READFUNC_ABORT;
+        }
+        reader->offset += (curl_off_t)got;
+        return (size_t)got;
+    }
+}
+
+// CURLOPT_SEEKFUNCTION compatible, libcurl rewinds the body for redirects and
+// authentication, relative to where the upload started.
+int _curl_fd_seek(void *userdata, curl_off_t offset, int origin) {
+    struct curl_cffi_fd_reader *reader = (struct curl_cffi_fd_reader *)userdata;
+    if (origin != SEEK_SET || offset < 0 || offset > reader->length) {
+        return CURL_SEEKFUNC_CANTSEEK;
+    }
+    reader->offset = offset;
+    return CURL_SEEKFUNC_OK;
+}
+
+// out of socket_action, e.g. in add_handle or curl_easy_pause, python has to be
+// told that there are events, only once until it has looked at them
+static void _curl_multi_events_changed(struct curl_cffi_multi_events *events) {
+    if (!events->busy && !events->notified && events->notify != NULL) {
+        events->notified = 1;
+        events->notify(events->clientp);
+    }
+}
+
+// CURLMOPT_SOCKETFUNCTION compatible, keeps the last wanted state of each socket.
+static int _curl_multi_socket_cb(CURL *easy, curl_socket_t s, int what, void *userp, void *socketp) {
+    struct curl_cffi_multi_events *events = (struct curl_cffi_multi_events *)userp;
+    struct curl_cffi_sock_event *sock;
+    size_t i;
+    (void)easy;
+    (void)socketp;
+    for (i = 0; i < events->nsocks; i++) {
+        sock = &events->socks[i];
+        if (sock->fd == (int64_t)s) {
+            // a socket closed and reopened with the same fd must be watched again
+            if (sock->what == CURL_POLL_REMOVE) {
+                sock->removed = 1;
+            }
+            sock->what = what;
+            _curl_multi_events_changed(events);
+            return 0;
+        }
+    }
+    if (events->nsocks == events->socks_capacity) {
+        size_t capacity = events->socks_capacity ? events->socks_capacity * 2 : 16;
+        sock = (struct curl_cffi_sock_event *)realloc(
+            events->socks, capacity * sizeof(struct curl_cffi_sock_event));
+        if (sock == NULL) {
+            return -1;
+        }
+        events->socks = sock;
+        events->socks_capacity = capacity;
+    }
+    sock = &events->socks[events->nsocks++];
+    sock->fd = (int64_t)s;
+    sock->what = what;
+    sock->removed = 0;
+    _curl_multi_events_changed(events);
+    return 0;
+}
+
+// CURLMOPT_TIMERFUNCTION compatible, only the last timeout matters.
+static int _curl_multi_timer_cb(CURLM *multi, long timeout_ms, void *userp) {
+    struct curl_cffi_multi_events *events = (struct curl_cffi_multi_events *)userp;
+    (void)multi;
+    events->timeout_ms = timeout_ms;
+    events->timer_set = 1;
+    _curl_multi_events_changed(events);
+    return 0;
+}
+
+struct curl_cffi_multi_events *_curl_multi_events_new(void *curlm, void (*notify)(void *clientp), void *clientp) {
+    struct curl_cffi_multi_events *events;
+    events = (struct curl_cffi_multi_events *)calloc(1, sizeof(struct curl_cffi_multi_events));
+    if (events == NULL) {
+        return NULL;
+    }
+    events->notify = notify;
+    events->clientp = clientp;
+    // without notify, the multi handle is driven by _curl_multi_perform instead
+    if (notify == NULL) {
+        return events;
+    }
+    curl_multi_setopt(curlm, CURLMOPT_SOCKETFUNCTION, _curl_multi_socket_cb);
+    curl_multi_setopt(curlm, CURLMOPT_SOCKETDATA, events);
+    curl_multi_setopt(curlm, CURLMOPT_TIMERFUNCTION, _curl_multi_timer_cb);
+    curl_multi_setopt(curlm, CURLMOPT_TIMERDATA, events);
+    return events;
+}
+
+void _curl_multi_events_free(struct curl_cffi_multi_events *events) {
+    if (events == NULL) {
+        return;
+    }
+    free(events->socks);
+    free(events->done);
+    free(events);
+}
+
+// Moves the finished transfers into `done`. If growing `done` fails, the rest stays
+// queued in libcurl for the next call.
+static void _curl_multi_drain(void *curlm, struct curl_cffi_multi_events *events) {
+    CURLMsg *msg;
+    int left;
+    while ((msg = curl_multi_info_read(curlm, &left)) != NULL) {
+        if (msg->msg != CURLMSG_DONE) {
+            continue;
+        }
+        if (events->ndone == events->done_capacity) {
+            size_t capacity = events->done_capacity ? events->done_capacity * 2 : 16;
+            struct curl_cffi_done *done = (struct curl_cffi_done *)realloc(
+                events->done, capacity * sizeof(struct curl_cffi_done));
+            if (done == NULL) {
+                break;
+            }
+            events->done = done;
+            events->done_capacity = capacity;
+        }
+        events->done[events->ndone].easy = msg->easy_handle;
+        events->done[events->ndone].result = (int)msg->data.result;
+        events->ndone++;
+    }
+}
+
+// curl_multi_socket_action, then drains the finished transfers into `done`.
+int _curl_multi_action(void *curlm, struct curl_cffi_multi_events *events, int64_t sockfd, int ev_bitmask) {
+    CURLMcode code;
+    events->busy = 1;
+    events->ndone = 0;
+    code = curl_multi_socket_action(curlm, (curl_socket_t)sockfd, ev_bitmask, &events->running);
+    events->busy = 0;
+    if (code != CURLM_OK) {
+        return (int)code;
+    }
+    _curl_multi_drain(curlm, events);
+    return (int)code;
+}
+
+// curl_multi_perform, for multi handles waited on with curl_multi_poll, then drains
+// the finished transfers into `done`.
+int _curl_multi_perform(void *curlm, struct curl_cffi_multi_events *events) {
+    CURLMcode code;
+    events->ndone = 0;
+    code = curl_multi_perform(curlm, &events->running);
+    if (code != CURLM_OK) {
+        return (int)code;
+    }
+    _curl_multi_drain(curlm, events);
+    return (int)code;
+}
+
+static void _curl_share_lock(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr) {
+    struct curl_cffi_share *share = (struct curl_cffi_share *)userptr;
+    (void)handle;
+    (void)access;
+    if (data < CURL_LOCK_DATA_LAST) {
+        _curl_cffi_mutex_lock(&share->locks[data]);
+    }
+}
+
+static void _curl_share_unlock(CURL *handle, curl_lock_data data, void *userptr) {
+    struct curl_cffi_share *share = (struct curl_cffi_share *)userptr;
+    (void)handle;
+    if (data < CURL_LOCK_DATA_LAST) {
+        _curl_cffi_mutex_unlock(&share->locks[data]);
+    }
+}
+
+struct curl_cffi_share *_curl_share_new(void) {
+    struct curl_cffi_share *share;
+    int i;
+    share = (struct curl_cffi_share *)calloc(1, sizeof(struct curl_cffi_share));
+    if (share == NULL) {
+        return NULL;
+    }
+    share->share = curl_share_init();
+    if (share->share == NULL) {
+        free(share);
+        return NULL;
+    }
+    for (i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+        _curl_cffi_mutex_init(&share->locks[i]);
+    }
+    curl_share_setopt(share->share, CURLSHOPT_LOCKFUNC, _curl_share_lock);
+    curl_share_setopt(share->share, CURLSHOPT_UNLOCKFUNC, _curl_share_unlock);
+    curl_share_setopt(share->share, CURLSHOPT_USERDATA, share);
+    return share;
+}
+
+int _curl_share_add(struct curl_cffi_share *share, int data) {
+    return (int)curl_share_setopt(share->share, CURLSHOPT_SHARE, (curl_lock_data)data);
+}
+
+// fails with CURLSHE_IN_USE while handles still use the share, which is then leaked
+// rather than freed under their feet.
+int _curl_share_free(struct curl_cffi_share *share) {
+    CURLSHcode code;
+    int i;
+    if (share == NULL) {
+        return 0;
+    }
+    code = curl_share_cleanup(share->share);
+    if (code != CURLSHE_OK) {
+        return (int)code;
+    }
+    for (i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+        _curl_cffi_mutex_destroy(&share->locks[i]);
+    }
+    free(share);
+    return 0;
+}
+
+static CURLcode _curl_ssls_export_cb(CURL *curl, void *userptr, const char *session_key,
+                                    const unsigned char *shmac, size_t shmac_len,
+                                    const unsigned char *sdata, size_t sdata_len,
+                                    curl_off_t valid_until, int ietf_tls_id,
+                                    const char *alpn, size_t earlydata_max) {
+    struct curl_cffi_buffer *out = (struct curl_cffi_buffer *)userptr;
+    size_t before = out->size;
+    (void)curl;
+    (void)session_key;
+    (void)ietf_tls_id;
+    (void)alpn;
+    (void)earlydata_max;
+    // sessions without a hashed key can not be imported again
+    if (shmac == NULL || shmac_len == 0) {
+        return CURLE_OK;
+    }
+    if (_curl_buffer_write((char *)&shmac_len, sizeof(size_t), 1, out) == 0 ||
+        _curl_buffer_write((char *)shmac, shmac_len, 1, out) == 0 ||
+        _curl_buffer_write((char *)&sdata_len, sizeof(size_t), 1, out) == 0 ||
+        (sdata_len && _curl_buffer_write((char *)sdata, sdata_len, 1, out) == 0) ||
+        _curl_buffer_write((char *)&valid_until, sizeof(curl_off_t), 1, out) == 0) {
+        out->size = before;
+        return CURLE_OUT_OF_MEMORY;
+    }
+    return CURLE_OK;
+}
+
+// Appends the TLS sessions cached by the handle, or its share, to `out`.
+int _curl_ssls_export(void *curl, struct curl_cffi_buffer *out) {
+    return (int)curl_easy_ssls_export(curl, _curl_ssls_export_cb, out);
+}
+
+// Imports records written by _curl_ssls_export. A record libcurl refuses, e.g. one
+// of another TLS backend, is skipped, only a truncated buffer is an error.
+int _curl_ssls_import(void *curl, const char *data, size_t len, size_t *imported) {
+    size_t pos = 0;
+    size_t shmac_len;
+    size_t sdata_len;
+    const char *shmac;
+    *imported = 0;
+    while (pos < len) {
+        if (len - pos < sizeof(size_t)) {
+            return CURLE_BAD_FUNCTION_ARGUMENT;
+        }
+        memcpy(&shmac_len, data + pos, sizeof(size_t));
+        pos += sizeof(size_t);
+        if (len - pos < shmac_len || len - pos - shmac_len < sizeof(size_t)) {
+            return CURLE_BAD_FUNCTION_ARGUMENT;
+        }
+        shmac = data + pos;
+        pos += shmac_len;
+        memcpy(&sdata_len, data + pos, sizeof(size_t));
+        pos += sizeof(size_t);
+        if (len - pos < sdata_len || len - pos - sdata_len < sizeof(curl_off_t)) {
+            return CURLE_BAD_FUNCTION_ARGUMENT;
+        }
+        if (curl_easy_ssls_import(curl, NULL, (const unsigned char *)shmac, shmac_len,
+                                  (const unsigned char *)(data + pos),
+                                  sdata_len) == CURLE_OK) {
+            (*imported)++;
+        }
+        pos += sdata_len + sizeof(curl_off_t);
+    }
+    return CURLE_OK;
+}
+
+static int _curl_would_block(void) {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+// Calls curl_ws_recv until there is nothing left to read, the buffer or `chunks` is
+// full, or a close frame is received. Returns CURLE_AGAIN when drained, CURLE_OK when
+// a limit was hit, or the error. The chunks received before are kept in any case.
+//
+// With some TLS backends, an empty socket shows up as CURLE_RECV_ERROR with errno
+// set to EAGAIN, it is reported as CURLE_AGAIN as well.
+int _curl_ws_recv_many(void *curl, char *buffer, size_t buflen,
+                       struct curl_cffi_ws_chunk *chunks, size_t max_chunks,
+                       size_t *nchunks) {
+    const struct curl_ws_frame *meta;
+    struct curl_cffi_ws_chunk *chunk;
+    CURLcode code;
+    size_t used = 0;
+    size_t n;
+    *nchunks = 0;
+    while (*nchunks < max_chunks && used < buflen) {
+        n = 0;
+        meta = NULL;
+        errno = 0;
+#ifdef _WIN32
+        WSASetLastError(0);
+#endif
+        code = curl_ws_recv(curl, buffer + used, buflen - used, &n, &meta);
+        if (code == CURLE_RECV_ERROR && _curl_would_block()) {
+            code = CURLE_AGAIN;
+        }
+        if (code != CURLE_OK) {
+            return (int)code;
+        }
+        chunk = &chunks[(*nchunks)++];
+        chunk->offset = used;
+        chunk->len = n;
+        chunk->flags = meta->flags;
+        chunk->bytesleft = meta->bytesleft;
+        used += n;
+        if (meta->flags & CURLWS_CLOSE) {
+            break;
+        }
+    }
+    return CURLE_OK;
+}
+
+// Sends `frames` in order, each with its own flags, so that every message keeps its
+// framing. `*nsent` frames and `*offset` bytes of the next one were sent by earlier
+// calls, both are updated with how far it got.
+//
+// Returns CURLE_AGAIN when the socket is full, or CURLE_OK when all the frames are
+// sent or curl took none of the bytes of a frame, which the caller tells apart with
+// `*nsent`.
+int _curl_ws_send_many(void *curl, const struct curl_cffi_ws_send_frame *frames,
+                       size_t count, size_t *nsent, size_t *offset) {
+    const struct curl_cffi_ws_send_frame *frame;
+    CURLcode code;
+    size_t left;
+    size_t sent;
+    while (*nsent < count) {
+        frame = &frames[*nsent];
+        left = frame->len - *offset;
+        sent = 0;
+        code = curl_ws_send(curl, frame->buffer + *offset, left, &sent, 0,
+                            (unsigned int)frame->flags);
+        if (code != CURLE_OK) {
+            return (int)code;
+        }
+        if (sent == 0 && left != 0) {
+            return CURLE_OK;
+        }
+        *offset += sent;
+        if (*offset == frame->len) {
+            (*nsent)++;
+            *offset = 0;
+        }
+    }
+    return CURLE_OK;
+}
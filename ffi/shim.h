@@ -4,4 +4,185 @@
 #define CURL_STATICLIB
 #include "curl/curl.h"
 
+#ifdef _WIN32
+#include <windows.h>
+typedef CRITICAL_SECTION curl_cffi_mutex;
+#else
+#include <pthread.h>
+typedef pthread_mutex_t curl_cffi_mutex;
+#endif
+
 int _curl_easy_setopt(void* curl, int option, void* param);
+
+// growable buffer filled by libcurl without calling back into python
+struct curl_cffi_buffer {
+    char *data;
+    size_t size;
+    size_t capacity;
+};
+
+struct curl_cffi_buffer *_curl_buffer_new(size_t capacity);
+void _curl_buffer_free(struct curl_cffi_buffer *buffer);
+void _curl_buffer_clear(struct curl_cffi_buffer *buffer);
+size_t _curl_buffer_write(char *ptr, size_t size, size_t nmemb, void *userdata);
+
+// header collector, splits header lines into name/value offsets in C.
+// fields: name_off, name_len, value_off, value_len
+// blocks: status, reason_off, reason_len, first_field, nfields
+#define CURL_CFFI_FIELD_WIDTH 4
+#define CURL_CFFI_BLOCK_WIDTH 5
+
+struct curl_cffi_headers {
+    struct curl_cffi_buffer data;
+    size_t *fields;
+    size_t nfields;
+    size_t fields_capacity;
+    size_t *blocks;
+    size_t nblocks;
+    size_t blocks_capacity;
+    size_t value_start;
+};
+
+struct curl_cffi_headers *_curl_headers_new(void);
+void _curl_headers_free(struct curl_cffi_headers *headers);
+void _curl_headers_clear(struct curl_cffi_headers *headers);
+size_t _curl_headers_write(char *ptr, size_t size, size_t nmemb, void *userdata);
+
+// batch getinfo, fetch many infos in one call
+union curl_cffi_info {
+    char *string;
+    long number;
+    double real;
+    curl_off_t offset;
+    struct curl_slist *list;
+};
+
+int _curl_easy_getinfo_many(void *curl, const int *options, union curl_cffi_info *values,
+                            size_t count);
+
+// neutral callbacks installed by soft reset, so that a handle never points to
+// freed python objects between requests
+size_t _curl_discard_write(char *ptr, size_t size, size_t nmemb, void *userdata);
+size_t _curl_empty_read(char *ptr, size_t size, size_t nmemb, void *userdata);
+
+// fixed size ring buffer for streaming, pauses the transfer instead of growing.
+// With `deferred` set, the transfer runs in another thread than the readers, the
+// written bytes are `staged` until _curl_ring_publish counts them in `size`.
+// `data` is owned by the caller, the ring never reallocates nor frees it.
+struct curl_cffi_ring {
+    char *data;
+    size_t capacity;
+    size_t start;
+    size_t size;
+    size_t pending;
+    int closed;
+    int deferred;
+    size_t staged;
+    char *spill;
+    size_t spill_len;
+    size_t spill_off;
+    curl_cffi_mutex lock;
+};
+
+struct curl_cffi_ring *_curl_ring_new(char *data, size_t capacity);
+void _curl_ring_free(struct curl_cffi_ring *ring);
+void _curl_ring_consume(struct curl_cffi_ring *ring, size_t len);
+size_t _curl_ring_publish(struct curl_cffi_ring *ring);
+size_t _curl_ring_write(char *ptr, size_t size, size_t nmemb, void *userdata);
+
+// writes the body straight to a file descriptor, the error is kept in `error`
+struct curl_cffi_file {
+    int fd;
+    int error;
+    curl_off_t written;
+};
+
+struct curl_cffi_file *_curl_file_new(int fd);
+void _curl_file_free(struct curl_cffi_file *file);
+size_t _curl_file_write(char *ptr, size_t size, size_t nmemb, void *userdata);
+
+// reads an upload body from a file descriptor at its own offset, the position of
+// the file itself is left untouched
+struct curl_cffi_fd_reader {
+    int fd;
+    int error;
+    curl_off_t start;
+    curl_off_t length;
+    curl_off_t offset;
+};
+
+struct curl_cffi_fd_reader *_curl_fd_reader_new(int fd, curl_off_t start, curl_off_t length);
+void _curl_fd_reader_free(struct curl_cffi_fd_reader *reader);
+size_t _curl_fd_read(char *buffer, size_t size, size_t nitems, void *userdata);
+int _curl_fd_seek(void *userdata, curl_off_t offset, int origin);
+
+// collects the socket, timer and completion events of one socket_action call, so
+// they can be handled by python in one go instead of a callback each
+struct curl_cffi_sock_event {
+    int64_t fd;
+    int what;
+    int removed;
+};
+
+struct curl_cffi_done {
+    void *easy;
+    int result;
+};
+
+struct curl_cffi_multi_events {
+    struct curl_cffi_sock_event *socks;
+    size_t nsocks;
+    size_t socks_capacity;
+    struct curl_cffi_done *done;
+    size_t ndone;
+    size_t done_capacity;
+    long timeout_ms;
+    int timer_set;
+    int running;
+    int busy;
+    int notified;
+    void (*notify)(void *clientp);
+    void *clientp;
+};
+
+struct curl_cffi_multi_events *_curl_multi_events_new(void *curlm, void (*notify)(void *clientp), void *clientp);
+void _curl_multi_events_free(struct curl_cffi_multi_events *events);
+int _curl_multi_action(void *curlm, struct curl_cffi_multi_events *events, int64_t sockfd, int ev_bitmask);
+int _curl_multi_perform(void *curlm, struct curl_cffi_multi_events *events);
+
+// curl_share with a mutex for each kind of shared data, so that the handles using it
+// can run in different threads
+struct curl_cffi_share {
+    CURLSH *share;
+    curl_cffi_mutex locks[CURL_LOCK_DATA_LAST];
+};
+
+struct curl_cffi_share *_curl_share_new(void);
+int _curl_share_add(struct curl_cffi_share *share, int data);
+int _curl_share_free(struct curl_cffi_share *share);
+
+// TLS sessions of a handle, or of its share, as records of
+// [size_t shmac_len][shmac][size_t sdata_len][sdata][curl_off_t valid_until]
+int _curl_ssls_export(void *curl, struct curl_cffi_buffer *out);
+int _curl_ssls_import(void *curl, const char *data, size_t len, size_t *imported);
+
+// websocket frames laid out back to back in one buffer, received by a single call
+struct curl_cffi_ws_chunk {
+    size_t offset;
+    size_t len;
+    int flags;
+    curl_off_t bytesleft;
+};
+
+// a websocket frame to send, the payloads stay where they are
+struct curl_cffi_ws_send_frame {
+    const char *buffer;
+    size_t len;
+    int flags;
+};
+
+int _curl_ws_recv_many(void *curl, char *buffer, size_t buflen,
+                       struct curl_cffi_ws_chunk *chunks, size_t max_chunks,
+                       size_t *nchunks);
+int _curl_ws_send_many(void *curl, const struct curl_cffi_ws_send_frame *frames,
+                       size_t count, size_t *nsent, size_t *offset);
@@ -86,6 +86,10 @@ async def app(scope, receive, send):
     print("scope_path:", scope["path"])
     if scope["path"].startswith("/slow_response"):
         await slow_response(scope, receive, send)
+    elif scope["path"].startswith("/slow_once"):
+        await slow_once(scope, receive, send)
+    elif scope["path"].startswith("/etag"):
+        await etag(scope, receive, send)
     elif scope["path"].startswith("/status"):
         await status_code(scope, receive, send)
     elif scope["path"].startswith("/echo_path"):
@@ -98,6 +102,8 @@ async def app(scope, receive, send):
         await large(scope, receive, send)
     elif scope["path"].startswith("/empty_body"):
         await empty_body(scope, receive, send)
+    elif scope["path"].startswith("/range"):
+        await range_body(scope, receive, send)
     elif scope["path"].startswith("/echo_body"):
         await echo_body(scope, receive, send)
     elif scope["path"].startswith("/echo_binary"):
@@ -233,6 +239,56 @@ async def slow_response(scope, receive, send):
     await send({"type": "http.response.body", "body": b"Hello, world!"})
 
 
+_slow_once_counts: dict[str, int] = defaultdict(int)
+
+
+async def slow_once(scope, receive, send):
+    params = parse_qs(scope["query_string"].decode(), keep_blank_values=True)
+    key = params.get("key", ["default"])[0]
+    count = _slow_once_counts[key]
+    _slow_once_counts[key] = count + 1
+    if count == 0:
+        await sleep(2)
+    await send(
+        {
+            "type": "http.response.start",
+            "status": 200,
+            "headers": [[b"content-type", b"text/plain"]],
+        }
+    )
+    await send({"type": "http.response.body", "body": str(count).encode()})
+
+
+_etag_counts: dict[str, int] = defaultdict(int)
+
+
+async def etag(scope, receive, send):
+    """Counts the requests of ``key``, answers 304 to a matching If-None-Match."""
+    params = parse_qs(scope["query_string"].decode(), keep_blank_values=True)
+    key = params.get("key", ["default"])[0]
+    count = _etag_counts[key]
+    _etag_counts[key] = count + 1
+    if "delay" in params:
+        await sleep(float(params["delay"][0]))
+    headers = [
+        [b"etag", b'"v1"'],
+        [b"cache-control", params.get("cc", ["max-age=60"])[0].encode()],
+    ]
+    request_headers = dict(scope["headers"])
+    if request_headers.get(b"if-none-match") == b'"v1"':
+        await send({"type": "http.response.start", "status": 304, "headers": headers})
+        await send({"type": "http.response.body", "body": b""})
+        return
+    await send(
+        {
+            "type": "http.response.start",
+            "status": 200,
+            "headers": [[b"content-type", b"text/plain"], *headers],
+        }
+    )
+    await send({"type": "http.response.body", "body": str(count).encode()})
+
+
 async def status_code(scope, receive, send):
     status_code = int(scope["path"].replace("/status/", ""))
     await send(
@@ -333,6 +389,34 @@ async def large(scope, receive, send):
     )
 
 
+RANGE_BODY = bytes(range(256)) * 1024
+
+
+async def range_body(scope, receive, send):
+    headers = dict(scope["headers"])
+    range_header = headers.get(b"range", b"").decode()
+    if not range_header:
+        status, body, extra = 200, RANGE_BODY, []
+    else:
+        start = int(range_header.removeprefix("bytes=").split("-")[0])
+        total = len(RANGE_BODY)
+        if start >= total:
+            status, body = 416, b""
+            extra = [[b"content-range", f"bytes */{total}".encode()]]
+        else:
+            status, body = 206, RANGE_BODY[start:]
+            content_range = f"bytes {start}-{total - 1}/{total}"
+            extra = [[b"content-range", content_range.encode()]]
+    await send(
+        {
+            "type": "http.response.start",
+            "status": status,
+            "headers": [[b"content-length", str(len(body)).encode()], *extra],
+        }
+    )
+    await send({"type": "http.response.body", "body": body})
+
+
 async def empty_body(scope, receive, send):
     await send({"type": "http.response.start", "status": 200})
     await send({"type": "http.response.body", "body": b""})
@@ -488,9 +572,12 @@ async def retry_once(scope, receive, send):
     key = params.get("key", ["default"])[0]
     count = _retry_once_counts[key]
     _retry_once_counts[key] = count + 1
+    headers = [[b"content-type", b"text/plain"]]
     if count == 0:
-        status = 500
+        status = int(params.get("status", ["500"])[0])
         body = b"try again"
+        if "retry_after" in params:
+            headers.append([b"retry-after", params["retry_after"][0].encode()])
     else:
         status = 200
         body = b"ok"
@@ -498,7 +585,7 @@ async def retry_once(scope, receive, send):
         {
             "type": "http.response.start",
             "status": status,
-            "headers": [[b"content-type", b"text/plain"]],
+            "headers": headers,
         }
     )
     await send({"type": "http.response.body", "body": body})
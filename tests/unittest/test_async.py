@@ -1,6 +1,8 @@
+import asyncio
+
 import pytest
 
-from curl_cffi import AsyncCurl, Curl, CurlOpt
+from curl_cffi import AsyncCurl, Curl, CurlInfo, CurlOpt
 
 
 async def test_init(server):
@@ -44,3 +46,43 @@ async def test_socket_action(server):
 
 
 async def test_process_data(server): ...
+
+
+async def test_many_handles(server):
+    ac = AsyncCurl()
+    curls = []
+    for i in range(50):
+        c = Curl()
+        c.setopt(CurlOpt.URL, str(server.url.copy_with(path=f"/echo_path/{i}")))
+        c.setopt(CurlOpt.WRITEFUNCTION, lambda x: len(x))
+        curls.append(c)
+    await asyncio.gather(*(ac.add_handle(c) for c in curls))
+    assert all(c.getinfo(CurlInfo.RESPONSE_CODE) == 200 for c in curls)
+    for c in curls:
+        c.close()
+    await ac.close()
+
+
+async def test_thread_driver(server):
+    ac = AsyncCurl(driver="thread")
+    assert ac.driver == "thread"
+    curls = []
+    for i in range(50):
+        c = Curl()
+        c.setopt(CurlOpt.URL, str(server.url.copy_with(path=f"/echo_path/{i}")))
+        c.setopt(CurlOpt.WRITEFUNCTION, lambda x: len(x))
+        curls.append(c)
+    await asyncio.gather(*(ac.add_handle(c) for c in curls))
+    assert all(c.getinfo(CurlInfo.RESPONSE_CODE) == 200 for c in curls)
+
+    # a transfer cancelled while the driver thread polls
+    slow = Curl()
+    slow.setopt(CurlOpt.URL, str(server.url.copy_with(path="/slow_response")))
+    slow.setopt(CurlOpt.WRITEFUNCTION, lambda x: len(x))
+    fut = ac.add_handle(slow)
+    await asyncio.sleep(0.1)
+    ac.remove_handle(slow)
+    assert fut.cancelled()
+    for c in [*curls, slow]:
+        c.close()
+    await ac.close()
@@ -2,20 +2,29 @@ import asyncio
 import base64
 import json
 import pickle
+import threading
 from contextlib import suppress
 from uuid import uuid4
 
 import pytest
 
-from curl_cffi import AsyncCurl, CurlOpt, Headers
+from curl_cffi import AsyncCurl, CurlOpt, CurlShare, Headers
 from curl_cffi.const import CurlECode
-from curl_cffi.requests import AsyncSession, RequestsError
+from curl_cffi.requests import (
+    AdaptiveTimeout,
+    AsyncSession,
+    HedgeStrategy,
+    RateLimit,
+    RequestsError,
+    ShardedAsyncSession,
+)
 from curl_cffi.requests.errors import SessionClosed
 from curl_cffi.requests.exceptions import (
     CertificateVerifyError,
     TooManyRedirects,
     UnrewindableBodyError,
 )
+from curl_cffi.requests.latency import LatencyTracker
 from curl_cffi.requests.models import Response
 
 
@@ -646,6 +655,86 @@ async def test_stream_unconsumed_error_releases_handle(server):
         assert r.status_code == 200
 
 
+async def test_pool_per_host_limit(server):
+    async with AsyncSession(max_clients=4, max_clients_per_host=1) as s:
+        url = str(server.url.copy_with(path="/slow_response"))
+        rs = await asyncio.gather(*[s.get(url) for _ in range(3)])
+        assert all(r.status_code == 200 for r in rs)
+        stats = s.pool_stats()
+        # one handle was enough, the other requests waited for it
+        assert stats.created == 1
+        assert stats.waited == 2
+        assert stats.in_use == 0
+
+
+async def test_pool_push_closed_curl():
+    async with AsyncSession(max_clients=1) as s:
+        curl = await s.pop_curl()
+        curl.close()
+        # the slot of the closed handle is given back
+        s.push_curl(None)
+        assert s.pool_stats().in_use == 0
+        s.push_curl(await s.pop_curl())
+
+
+async def test_pool_idle_eviction_and_warmup(server):
+    async with AsyncSession(
+        min_clients=1, idle_timeout=0.1, warmup_urls=[str(server.url)]
+    ) as s:
+        stats = s.pool_stats()
+        assert stats.idle == stats.size >= 1
+        await asyncio.gather(*[s.get(str(server.url)) for _ in range(4)])
+        assert s.pool_stats().size > 1
+        await asyncio.sleep(0.3)
+        stats = s.pool_stats()
+        assert stats.size == 1
+        assert stats.evicted >= 1
+        assert (await s.get(str(server.url))).status_code == 200
+
+
+async def test_rate_limit_priority(server):
+    url = str(server.url)
+    limit = RateLimit(rate=10, burst=1)
+    async with AsyncSession(rate_limit={server.url.netloc.decode(): limit}) as s:
+        done = []
+
+        async def get(name: str, priority: int = 0):
+            await s.get(url, priority=priority)
+            done.append(name)
+
+        start = asyncio.get_running_loop().time()
+        await asyncio.gather(*[get(f"low{i}") for i in range(3)], get("high", 1))
+        # the tokens come every 0.1s, the high priority request gets the second
+        assert done[:2] == ["low0", "high"]
+        assert asyncio.get_running_loop().time() - start >= 0.3
+
+
+async def test_hedged_request(server):
+    query = f"key={uuid4().hex}".encode()
+    url = str(server.url.copy_with(path="/slow_once", query=query))
+    async with AsyncSession(hedge=HedgeStrategy(delay=0.2)) as s:
+        start = asyncio.get_running_loop().time()
+        r = await s.get(url)
+        # the duplicate answered first, the slow transfer was cancelled
+        assert r.text == "1"
+        assert asyncio.get_running_loop().time() - start < 1.5
+        assert s.pool_stats().in_use == 0
+
+
+def test_adaptive_timeout():
+    latencies = LatencyTracker()
+    adaptive = AdaptiveTimeout(min_samples=10, min_timeout=0.1)
+    assert adaptive.timeout_for(latencies, "example.com") is None
+    for _ in range(99):
+        latencies.observe("example.com", 0.1)
+    latencies.observe("example.com", 1.0)
+    assert 0.1 <= latencies.percentile("example.com", 0.5) < 0.12
+    assert adaptive.timeout_for(latencies, "example.com") == pytest.approx(
+        latencies.percentile("example.com", 0.99) * 3
+    )
+    assert HedgeStrategy(min_samples=10).delay_for(latencies, "example.com") < 0.12
+
+
 async def test_stream_session_curl_options(server):
     async with AsyncSession(
         curl_options={CurlOpt.USERAGENT: "foo/1.0"},
@@ -657,6 +746,37 @@ async def test_stream_session_curl_options(server):
         assert data["User-agent"][0] == "foo/1.0"
 
 
+async def test_stream_ring_buffer(server):
+    async with AsyncSession(max_clients=1) as s:
+        url = str(server.url.copy_with(path="/stream"))
+        async with s.stream(
+            "GET", url, params={"n": "20"}, stream_buffer_size=64
+        ) as r:
+            text = await r.atext()
+        assert len(text.split("\n")) == 20
+
+        # closing a paused transfer early gives the handle back
+        async with s.stream(
+            "GET", url, params={"n": "20"}, stream_buffer_size=64
+        ) as r:
+            async for _ in r.aiter_content():
+                break
+
+        r = await s.get(str(server.url))
+        assert r.status_code == 200
+
+
+async def test_download(server, tmp_path):
+    body = bytes(range(256)) * 1024
+    path = tmp_path / "file.bin"
+    path.write_bytes(body[:1000])
+    async with AsyncSession() as s:
+        url = str(server.url.copy_with(path="/range"))
+        r = await s.download(url, path)
+    assert r.status_code == 206
+    assert path.read_bytes() == body
+
+
 async def test_stream_atext(server):
     async with AsyncSession() as s:
         url = str(server.url.copy_with(path="/stream"))
@@ -702,3 +822,49 @@ async def test_shared_async_curl_not_closed_by_session(server):
     await s2.close()
 
     await pool.close()
+
+
+async def test_sharded_session(server):
+    url = str(server.url.copy_with(path="/echo_params"))
+    threads = threading.active_count()
+    async with ShardedAsyncSession(2, params={"shared": "1"}) as s:
+        assert len(s.shards) == 2
+        assert s.shard_for(url) is s.shard_for(str(server.url))
+        assert all(shard.cookies is s.cookies for shard in s.shards)
+        rs = await asyncio.gather(*(s.get(url, params={"i": i}) for i in range(20)))
+        assert [int(r.json()["params"]["i"][0]) for r in rs] == list(range(20))
+        assert all(r.json()["params"]["shared"] == ["1"] for r in rs)
+
+        r = await s.post(str(server.url.copy_with(path="/echo_body")), content=b"foo")
+        assert r.content == b"foo"
+        with pytest.raises(NotImplementedError):
+            await s.get(url, stream=True)
+    assert threading.active_count() <= threads
+
+    with pytest.raises(ValueError):
+        ShardedAsyncSession(0)
+    # a shard failing to open stops its thread, and the shards opened before it
+    with pytest.raises(ValueError):
+        ShardedAsyncSession(2, share=CurlShare(cookies=False), cookie_engine=True)
+    assert threading.active_count() <= threads
+
+
+async def test_connection_stats(server):
+    url = str(server.url.copy_with(path="/echo_path/a"))
+    async with AsyncSession(max_host_connections=2, max_concurrent_streams=10) as s:
+        # nothing known about the origin yet, wait for a connection that may multiplex
+        assert s.connections is not None
+        assert s.connections.pipewait(url)
+        assert not s.connections.pipewait(url, "v1")
+        await asyncio.gather(*(s.get(url) for _ in range(5)))
+        stats = s.connection_stats()
+        assert 1 <= len(stats) <= 2
+        assert sum(c.total_streams for c in stats) == 5
+        assert all(c.active_streams == 0 and not c.multiplexed for c in stats)
+        # the test server speaks HTTP/1.1, parallel connections are opened right away
+        assert not s.connections.pipewait(url)
+
+    async with AsyncSession(multiplex=False) as s:
+        await s.get(url)
+        assert s.connections is None
+        assert s.connection_stats() == []
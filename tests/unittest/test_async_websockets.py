@@ -27,7 +27,6 @@ from collections.abc import (
     Awaitable,
     Callable,
     Generator,
-    Iterator,
 )
 from contextlib import asynccontextmanager, suppress
 from dataclasses import dataclass, field
@@ -355,6 +354,35 @@ async def create_ws(
         await ws.close()
 
 
+def mock_recv_many(
+    frames: list[tuple[bytes, int]], code: int = 0
+) -> Callable[[memoryview, int], tuple[int, list[tuple[int, int, int, int]]]]:
+    """Feeds ``(payload, flags)`` frames to the read loop like ``Curl.ws_recv_many``,
+    back to back and split where the buffer is full. ``code`` is returned with the
+    last batch."""
+    pending: list[tuple[bytes, int]] = list(frames)
+
+    def recv_many(
+        buffer: memoryview, max_chunks: int
+    ) -> tuple[int, list[tuple[int, int, int, int]]]:
+        received: list[tuple[int, int, int, int]] = []
+        used: int = 0
+        while pending and len(received) < max_chunks and used < len(buffer):
+            data, flags = pending[0]
+            n: int = min(len(data), len(buffer) - used)
+            buffer[used : used + n] = data[:n]
+            received.append((used, n, flags, len(data) - n))
+            used += n
+            if n < len(data):
+                pending[0] = (data[n:], flags)
+                continue
+            del pending[0]
+            if flags & CurlWsFlag.CLOSE:
+                break
+        return (code if not pending else 0), received
+
+    return recv_many
+
 # =============================================================================
 # Test Helpers
 # =============================================================================
@@ -2153,27 +2181,20 @@ class TestAsyncWebSocketRobustness:
         ws.closed = False
         ws._block_on_recv_queue_full = False
 
-        class MockFrameMeta:
-            def __init__(self, flags: int, bytesleft: int = 0) -> None:
-                self.flags: int = flags
-                self.bytesleft: int = bytesleft
-
         # Simulate libcurl yielding an evil sequence of fragmented frames:
         # 1. Fragment 1 (TEXT | CONT)
         # 2. PING (Injected control frame)
         # 3. PONG (Injected control frame)
         # 4. Fragment 2 (TEXT - Final chunk)
         # 5. CLOSE
-        mock_sequence: list[tuple[bytes, MockFrameMeta]] = [
-            (b"Chunk 1 ", MockFrameMeta(CurlWsFlag.TEXT | CurlWsFlag.CONT)),
-            (b"ping_payload", MockFrameMeta(CurlWsFlag.PING)),
-            (b"pong_payload", MockFrameMeta(CurlWsFlag.PONG)),
-            (b"Chunk 2", MockFrameMeta(CurlWsFlag.TEXT)),
-            (b"bye", MockFrameMeta(CurlWsFlag.CLOSE)),
+        mock_sequence: list[tuple[bytes, int]] = [
+            (b"Chunk 1 ", CurlWsFlag.TEXT | CurlWsFlag.CONT),
+            (b"ping_payload", CurlWsFlag.PING),
+            (b"pong_payload", CurlWsFlag.PONG),
+            (b"Chunk 2", CurlWsFlag.TEXT),
+            (b"bye", CurlWsFlag.CLOSE),
         ]
-
-        iterator: Iterator[tuple[bytes, MockFrameMeta]] = iter(mock_sequence)
-        mock_curl.ws_recv.side_effect = lambda: next(iterator)
+        mock_curl.ws_recv_many.side_effect = mock_recv_many(mock_sequence)
 
         # Execute the read loop directly
         await ws._read_loop()
@@ -2192,6 +2213,123 @@ class TestAsyncWebSocketRobustness:
         # Ensure nothing else leaked into the queue
         assert ws._receive_queue.empty()
 
+    @pytest.mark.asyncio
+    async def test_zero_copy_fragment_assembly(self) -> None:
+        """Fragments are reassembled in place, across arenas, and the messages are
+        read-only views of the arenas."""
+        mock_curl: Mock = Mock(spec=Curl)
+        ws: AsyncWebSocket = AsyncWebSocket(
+            Mock(), mock_curl, zero_copy=True, recv_buffer_size=1024
+        )
+        ws.closed = False
+        ws._block_on_recv_queue_full = False
+
+        big: bytes = bytes(range(256)) * 8
+        mock_sequence: list[tuple[bytes, int]] = [
+            (b"Chunk 1 ", CurlWsFlag.TEXT | CurlWsFlag.CONT),
+            (b"ping_payload", CurlWsFlag.PING),
+            (b"Chunk 2", CurlWsFlag.TEXT),
+            (big, CurlWsFlag.BINARY),
+            (b"bye", CurlWsFlag.CLOSE),
+        ]
+        mock_curl.ws_recv_many.side_effect = mock_recv_many(mock_sequence)
+        await ws._read_loop()
+
+        msg1, flags1 = ws._receive_queue.get_nowait()
+        msg2, _ = ws._receive_queue.get_nowait()
+        msg3, flags3 = ws._receive_queue.get_nowait()
+        assert isinstance(msg1, memoryview)
+        assert msg1.readonly
+        assert msg1 == b"Chunk 1 Chunk 2"
+        assert flags1 == CurlWsFlag.TEXT
+        assert msg2 == big
+        assert msg3 == b"bye"
+        assert flags3 & CurlWsFlag.CLOSE
+        assert ws._receive_queue.empty()
+
+    @pytest.mark.asyncio
+    async def test_batch_delivered_before_error(self) -> None:
+        """The messages received in the batch that ended with an error are queued
+        before the connection is failed."""
+        mock_curl: Mock = Mock(spec=Curl)
+        ws: AsyncWebSocket = AsyncWebSocket(Mock(), mock_curl)
+        ws.closed = False
+        mock_curl._get_error.return_value = CurlError(
+            "Failed to WS_RECV", code=CurlECode.GOT_NOTHING
+        )
+        mock_curl.ws_recv_many.side_effect = mock_recv_many(
+            [(b"one", CurlWsFlag.TEXT), (b"two", CurlWsFlag.BINARY)],
+            code=CurlECode.GOT_NOTHING,
+        )
+        await ws._read_loop()
+
+        assert ws._receive_queue.get_nowait() == (b"one", CurlWsFlag.TEXT)
+        assert ws._receive_queue.get_nowait() == (b"two", CurlWsFlag.BINARY)
+        assert isinstance(ws._transport_exception, WebSocketClosed)
+        assert mock_curl.ws_recv_many.call_count == 1
+
+    @pytest.mark.asyncio
+    async def test_batched_send_keeps_frames(self) -> None:
+        """Pending messages are sent with one call, each in its own frame, a full
+        socket resumes the batch where it stopped, and a message larger than a frame
+        is sent on its own, in order."""
+        mock_curl: Mock = Mock(spec=Curl)
+        ws: AsyncWebSocket = AsyncWebSocket(Mock(), mock_curl)
+        ws.closed = False
+        wire: list[tuple[bytes, int]] = []
+        calls: list[tuple[int, int]] = []
+
+        def send_many(
+            frames: list[tuple[bytes, int]], sent: int, offset: int
+        ) -> tuple[int, int, int]:
+            # The socket takes 10 bytes per call
+            calls.append((sent, offset))
+            budget: int = 10
+            while sent < len(frames):
+                payload, flags = frames[sent]
+                n: int = min(len(payload) - offset, budget)
+                budget -= n
+                offset += n
+                if offset < len(payload):
+                    return CurlECode.AGAIN, sent, offset
+                wire.append((payload, flags))
+                sent += 1
+                offset = 0
+            return 0, sent, offset
+
+        def send(chunk: memoryview, flags: int) -> int:
+            wire.append((bytes(chunk), flags))
+            return len(chunk)
+
+        mock_curl.ws_send_many.side_effect = send_many
+        mock_curl.ws_send.side_effect = send
+        big: bytes = b"z" * 70000
+        messages: list[tuple[bytes, int]] = [
+            (b"a" * 8, CurlWsFlag.TEXT),
+            (b"b" * 15, CurlWsFlag.BINARY),
+            (b"", CurlWsFlag.TEXT),
+            (big, CurlWsFlag.BINARY),
+            (b"end", CurlWsFlag.TEXT),
+            (b"\x03\xe8", CurlWsFlag.CLOSE),
+        ]
+        for message in messages:
+            ws._send_queue.put_nowait(message)
+
+        with unittest.mock.patch.object(
+            AsyncWebSocket, "_wait_writable", return_value=True
+        ) as wait_writable:
+            await ws._write_loop()
+
+        assert wire == [
+            *messages[:3],
+            (big[:65536], CurlWsFlag.BINARY | CurlWsFlag.CONT),
+            (big[65536:], CurlWsFlag.BINARY),
+            *messages[4:],
+        ]
+        assert calls == [(0, 0), (1, 2), (1, 12), (0, 0)]
+        assert wait_writable.await_count == 2
+        assert ws._send_queue.empty()
+
     @pytest.mark.asyncio
     async def test_high_concurrency_mixed_frame_stress(
         self,
@@ -1,11 +1,21 @@
+import asyncio
+from concurrent.futures import ThreadPoolExecutor
 from datetime import timedelta
 import json
 from pathlib import Path
+import threading
+import time
 
 import pytest
 
 from curl_cffi.requests import cache
-from curl_cffi.requests import AsyncSession, FileCacheBackend, Session
+from curl_cffi.requests import (
+    AsyncSession,
+    BinaryCacheBackend,
+    FileCacheBackend,
+    MemoryCacheBackend,
+    Session,
+)
 from curl_cffi.requests.models import Response
 
 
@@ -140,16 +150,215 @@ def test_cache_preserves_custom_response_class(server, tmp_path):
     assert cached.status == 200
 
 
-def test_async_session_rejects_cache_backend():
-    cache = FileCacheBackend(expires=timedelta(seconds=60))
+def test_binary_cache_hit_and_reopen(server, tmp_path):
+    cache = BinaryCacheBackend(
+        expires=timedelta(seconds=60), path=tmp_path, zero_copy=True
+    )
+    url = str(server.url.copy_with(path="/unique_cookie"))
 
-    with pytest.raises(NotImplementedError, match="does not support cache yet"):
-        AsyncSession(cache=cache)
+    with Session(cache=cache) as session:
+        first = session.get(url)
+        second = session.get(url)
 
+    assert first.cookies["foo"] == second.cookies["foo"]
+    assert isinstance(second.content, memoryview)
+    assert second.text == first.text
+    cache.close()
+    names = sorted(p.name for p in tmp_path.iterdir())
+    assert names == ["data.bin", "index.bin", "lock"]
 
-def test_async_session_rejects_cache_shorthand():
-    with pytest.raises(NotImplementedError, match="does not support cache yet"):
-        AsyncSession(cache=timedelta(seconds=60))
+    cache = BinaryCacheBackend(expires=timedelta(seconds=60), path=tmp_path)
+    with Session(cache=cache) as session:
+        third = session.get(url)
+    assert third.cookies["foo"] == first.cookies["foo"]
+    assert third.content == first.content
+    cache.close()
+
+
+def test_binary_cache_is_locked_and_checks_records(server, tmp_path):
+    cache = BinaryCacheBackend(expires=timedelta(seconds=60), path=tmp_path)
+    with pytest.raises(RuntimeError):
+        BinaryCacheBackend(expires=timedelta(seconds=60), path=tmp_path)
+    url = str(server.url.copy_with(path="/echo_params", query=b"a=1"))
+    with Session(cache=cache) as session:
+        session.get(url)
+    key = next(iter(cache._index))
+    offset, size, created_at = cache._index[key]
+    # as if the data file was rewritten behind the index
+    cache._index[key] = (offset, size + 1, created_at)
+    assert cache._read_payload(key.hex()) is None
+    assert key not in cache._index
+    cache.close()
+    BinaryCacheBackend(expires=timedelta(seconds=60), path=tmp_path).close()
+
+
+def test_binary_cache_eviction_and_compaction(server, tmp_path):
+    cache = BinaryCacheBackend(
+        expires=timedelta(seconds=60), path=tmp_path, max_size=2048
+    )
+    with Session(cache=cache) as session:
+        for i in range(20):
+            query = f"i={i}".encode()
+            url = str(server.url.copy_with(path="/echo_params", query=query))
+            session.get(url)
+
+    assert cache._live <= 2048
+    # the latest entries are kept
+    assert len(cache._index) < 20
+    cache.compact()
+    assert (tmp_path / "data.bin").stat().st_size == cache._live
+    with Session(cache=cache) as session:
+        url = str(server.url.copy_with(path="/echo_params", query=b"i=19"))
+        assert session.get(url).json() == {"params": {"i": ["19"]}}
+    cache.close()
+
+
+def etag_url(server, key, **params):
+    query = "&".join(f"{k}={v}" for k, v in {"key": key, **params}.items())
+    return str(server.url.copy_with(path="/etag", query=query.encode()))
+
+
+def test_memory_cache_follows_max_age(server):
+    cache = MemoryCacheBackend()
+    url = etag_url(server, "mem-max-age")
+
+    with Session(cache=cache) as session:
+        assert session.get(url).text == "0"
+        assert session.get(url).text == "0"
+        assert session.get(etag_url(server, "mem-no-store", cc="no-store")).ok
+    with Session() as session:
+        assert session.get(url).text == "1"
+    assert len(cache._entries) == 1
+
+
+def test_memory_cache_revalidates_with_etag(server):
+    cache = MemoryCacheBackend()
+    url = etag_url(server, "mem-no-cache", cc="no-cache")
+
+    with Session(cache=cache) as session:
+        first = session.get(url)
+        # the server answers 304, the cached body is served
+        second = session.get(url)
+    with Session() as session:
+        assert session.get(url).text == "2"
+    assert first.text == second.text == "0"
+    assert second.status_code == 200
+
+
+def test_memory_cache_stale_while_revalidate(server):
+    cache = MemoryCacheBackend()
+    url = etag_url(server, "mem-swr", cc="max-age=0, stale-while-revalidate=60")
+
+    with Session(cache=cache) as session:
+        assert session.get(url).text == "0"
+        # the stale response is served, then revalidated in the background
+        assert session.get(url).text == "0"
+        deadline = time.monotonic() + 5
+        while cache._pending and time.monotonic() < deadline:
+            time.sleep(0.05)
+    assert not cache._pending
+    with Session() as session:
+        assert session.get(url).text == "2"
+
+
+def test_memory_cache_collapses_concurrent_misses(server):
+    cache = MemoryCacheBackend()
+    url = etag_url(server, "mem-collapse", delay="0.5")
+
+    with Session(cache=cache) as session, ThreadPoolExecutor(4) as pool:
+        texts = list(pool.map(lambda _: session.get(url).text, range(4)))
+    with Session() as session:
+        assert session.get(url).text == "1"
+    assert texts == ["0"] * 4
+
+
+def test_memory_cache_evicts_by_size(server):
+    # neither fresh nor revalidatable without expires
+    cache = MemoryCacheBackend()
+    with Session(cache=cache) as session:
+        session.get(str(server.url.copy_with(path="/echo_params")))
+    assert not cache._entries
+
+    cache = MemoryCacheBackend(expires=timedelta(seconds=60), max_size=2048)
+    with Session(cache=cache) as session:
+        for i in range(20):
+            query = f"i={i}".encode()
+            session.get(str(server.url.copy_with(path="/echo_params", query=query)))
+
+    assert 0 < cache.size <= 2048
+    assert len(cache._entries) < 20
+    cache.clear()
+    assert cache.size == 0
+
+
+async def test_async_session_cache_hit(server, tmp_path):
+    cache = FileCacheBackend(expires=timedelta(seconds=60), path=tmp_path)
+    url = str(server.url.copy_with(path="/unique_cookie"))
+
+    async with AsyncSession(cache=cache) as session:
+        first = await session.get(url)
+        # the write is done in the background
+        await cache.aflush()
+        second = await session.get(url)
+
+    assert first.cookies["foo"] == second.cookies["foo"]
+    assert len(list(tmp_path.glob("*.json"))) == 1
+
+
+async def test_async_cache_coalesces_queued_writes(server, tmp_path):
+    cache = FileCacheBackend(expires=timedelta(seconds=60), path=tmp_path)
+    url = str(server.url.copy_with(path="/echo_params", query=b"a=1"))
+
+    async with AsyncSession() as session:
+        responses = [await session.get(url) for _ in range(3)]
+    writes = []
+    store = cache.set
+
+    def counting_set(request, response):
+        writes.append(response)
+        store(request, response)
+
+    cache.set = counting_set
+    # keep the I/O thread busy, so that the writes are queued together
+    busy = threading.Event()
+    cache._executor().submit(busy.wait)
+    for response in responses:
+        await cache.aset(response.request, response)
+    busy.set()
+    await cache.aflush()
+
+    assert writes == [responses[-1]]
+    cached = await cache.aget(responses[0].request)
+    assert cached is not None
+    assert cached.json() == {"params": {"a": ["1"]}}
+    cache.close()
+    assert cache._io is None
+
+
+async def test_async_memory_cache_collapses_concurrent_misses(server):
+    cache = MemoryCacheBackend()
+    url = etag_url(server, "mem-async-collapse", delay="0.5")
+
+    async with AsyncSession(cache=cache) as session:
+        responses = await asyncio.gather(*(session.get(url) for _ in range(4)))
+    async with AsyncSession() as session:
+        assert (await session.get(url)).text == "1"
+    assert [r.text for r in responses] == ["0"] * 4
+
+
+async def test_async_memory_cache_stale_while_revalidate(server):
+    cache = MemoryCacheBackend()
+    url = etag_url(server, "mem-async-swr", cc="max-age=0, stale-while-revalidate=60")
+
+    async with AsyncSession(cache=cache) as session:
+        assert (await session.get(url)).text == "0"
+        assert (await session.get(url)).text == "0"
+        deadline = time.monotonic() + 5
+        while cache._pending and time.monotonic() < deadline:
+            await asyncio.sleep(0.05)
+    assert not cache._pending
+    async with AsyncSession() as session:
+        assert (await session.get(url)).text == "2"
 
 
 def test_session_accepts_int_cache_shorthand():
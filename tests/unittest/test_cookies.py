@@ -2,7 +2,8 @@ import pickle
 
 import pytest
 
-from curl_cffi.requests.cookies import Cookies, CurlMorsel
+from curl_cffi.const import CurlOpt
+from curl_cffi.requests.cookies import Cookies, CurlCookies, CurlMorsel
 from curl_cffi.requests.errors import CookieConflict, RequestsError
 
 
@@ -77,3 +78,58 @@ def test_get_dict():
     assert d_example["hello"] == "world"
     assert len(d_test) == 1
     assert d_test["foo"] == "bar"
+
+
+class FakeCurl:
+    def __init__(self):
+        self.options = []
+
+    def setopt(self, option, value):
+        self.options.append((option, value))
+
+
+def test_curl_cookies_sync():
+    cookies = CurlCookies({"hostless": "a"})
+    cookies.set("foo", "bar", domain="example.com")
+    curl = FakeCurl()
+    cookies.sync_to_curl(curl, "www.example.com", {"extra": "b"})
+    assert curl.options == [
+        (CurlOpt.COOKIELIST, "ALL"),
+        (CurlOpt.COOKIELIST, "example.com\tTRUE\t/\tFALSE\t0\tfoo\tbar"),
+        (CurlOpt.COOKIE, "hostless=a; extra=b"),
+    ]
+
+    # nothing to push until the cookies change in python
+    curl = FakeCurl()
+    cookies.sync_to_curl(curl, "example.com")
+    assert curl.options == [(CurlOpt.COOKIE, "hostless=a")]
+
+    # the engine of a share given by the user keeps its cookies
+    curl = FakeCurl()
+    CurlCookies({"hostless": "a"}, clear_engine=False).sync_to_curl(curl, "a.com")
+    assert curl.options == [(CurlOpt.COOKIE, "hostless=a")]
+
+    cookies.delete("foo")
+    curl = FakeCurl()
+    cookies.sync_to_curl(curl, "example.com")
+    assert curl.options[0] == (
+        CurlOpt.COOKIELIST,
+        "example.com\tTRUE\t/\tFALSE\t1\tfoo\tbar",
+    )
+
+
+def test_curl_cookies_lazy_changes():
+    cookies = CurlCookies()
+    cookies.update_cookies_from_curl_changes(
+        [b"SET\texample.com\tFALSE\t/\tFALSE\t0\tfoo\tbar"]
+    )
+    assert cookies._pulls
+    assert cookies.get("foo") == "bar"
+    assert not cookies._pulls
+    cookies.update_cookies_from_curl_changes(
+        [b"DELETE\texample.com\tFALSE\t/\tFALSE\t0\tfoo\tbar"]
+    )
+    assert len(cookies) == 0
+
+    restored = pickle.loads(pickle.dumps(cookies))
+    assert type(restored) is Cookies
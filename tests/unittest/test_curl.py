@@ -1,6 +1,7 @@
 import base64
 import json
 import os
+import threading
 from importlib import import_module
 from io import BytesIO
 from typing import cast
@@ -8,7 +9,20 @@ from unittest.mock import patch
 
 import pytest
 
-from curl_cffi import Curl, CurlECode, CurlError, CurlInfo, CurlOpt, _wrapper
+from curl_cffi import (
+    Curl,
+    CurlBuffer,
+    CurlECode,
+    CurlError,
+    CurlFileSource,
+    CurlHeaderBuffer,
+    CurlInfo,
+    CurlMulti,
+    CurlOpt,
+    CurlRingBuffer,
+    CurlShare,
+    _wrapper,
+)
 from curl_cffi.curl import _default_cacert
 
 #######################################################################################
@@ -61,6 +75,119 @@ def test_post_data_with_size(server):
     assert buffer.getvalue() == b"\0" * 7
 
 
+def test_write_to_curl_buffer(server):
+    c = Curl()
+    url = str(server.url.copy_with(path="/echo_body"))
+    c.setopt(CurlOpt.URL, url.encode())
+    c.setopt(CurlOpt.POSTFIELDS, b"\0foo=bar" * 4096)
+    c.setopt(CurlOpt.POSTFIELDSIZE, 8 * 4096)
+    buffer = CurlBuffer()
+    c.setopt(CurlOpt.WRITEDATA, buffer)
+    c.perform()
+    assert len(buffer) == 8 * 4096
+    assert buffer.getvalue() == b"\0foo=bar" * 4096
+    assert bytes(buffer.getbuffer()[:8]) == b"\0foo=bar"
+
+    buffer.clear()
+    assert buffer.getvalue() == b""
+    buffer.write(b"baz")
+    assert buffer.getvalue() == b"baz"
+
+
+def test_perform_ring(server):
+    c = Curl()
+    url = str(server.url.copy_with(path="/echo_body"))
+    c.setopt(CurlOpt.URL, url.encode())
+    c.setopt(CurlOpt.POSTFIELDS, b"\0foo=bar" * 4096)
+    c.setopt(CurlOpt.POSTFIELDSIZE, 8 * 4096)
+    ring = CurlRingBuffer(1024)
+    c.setopt(CurlOpt.WRITEDATA, ring)
+    thread = threading.Thread(target=c.perform_ring, args=(ring,))
+    thread.start()
+    received = bytearray()
+    while thread.is_alive() or len(ring):
+        with ring.cond:
+            view = ring.peek()
+            received += view
+            ring.consume(len(view))
+            if not view:
+                ring.cond.wait(0.1)
+    thread.join()
+    assert bytes(received) == b"\0foo=bar" * 4096
+    assert not ring.paused
+
+
+def test_file_source(server, tmp_path):
+    path = tmp_path / "body.bin"
+    path.write_bytes(b"skip" + b"\0foo=bar" * 4096 + b"tail")
+    c = Curl()
+    url = str(server.url.copy_with(path="/echo_body"))
+    c.setopt(CurlOpt.URL, url.encode())
+    c.setopt(CurlOpt.UPLOAD, 1)
+    c.setopt(CurlOpt.CUSTOMREQUEST, b"POST")
+    with path.open("rb") as f:
+        source = CurlFileSource(f, 4, 8 * 4096)
+        c.setopt(CurlOpt.INFILESIZE_LARGE, len(source))
+        c.setopt(CurlOpt.READDATA, source)
+        buffer = CurlBuffer()
+        c.setopt(CurlOpt.WRITEDATA, buffer)
+        c.perform()
+        assert f.tell() == 0
+    assert buffer.getvalue() == b"\0foo=bar" * 4096
+    assert source.tell() == len(source)
+    assert source.exception is None
+
+
+def test_multi(server):
+    buffers = {}
+    with CurlMulti() as multi:
+        for path in ("/", "/echo_path", "/status/404"):
+            c = Curl()
+            c.setopt(CurlOpt.URL, str(server.url.copy_with(path=path)).encode())
+            buffers[c] = CurlBuffer()
+            c.setopt(CurlOpt.WRITEDATA, buffers[c])
+            multi.add_handle(c)
+        done = []
+        while multi.perform():
+            done += multi.info_read()
+            multi.poll(100)
+        done += multi.info_read()
+        assert len(multi) == 0
+    assert len(done) == 3
+    assert all(error is None for _, error in done)
+    statuses = sorted(c.getinfo(CurlInfo.RESPONSE_CODE) for c, _ in done)
+    assert statuses == [200, 200, 404]
+    assert any(buffers[c].getvalue() == b"Hello, world!" for c, _ in done)
+
+
+def test_share(server):
+    share = CurlShare(connections=True)
+    connects = []
+
+    def run():
+        c = Curl()
+        c.set_share(share)
+        c.setopt(CurlOpt.URL, str(server.url).encode())
+        c.setopt(CurlOpt.WRITEDATA, BytesIO())
+        c.perform()
+        connects.append(c.getinfo(CurlInfo.NUM_CONNECTS))
+        c.close()
+
+    run()
+    run()
+    # the second handle picks the connection of the first one from the share
+    assert connects == [1, 0]
+
+    # dns and tls sessions can be shared by handles in other threads
+    share = CurlShare()
+    threads = [threading.Thread(target=run) for _ in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert len(connects) == 6
+
+
 def test_headers(server):
     c = Curl()
     url = str(server.url.copy_with(path="/echo_headers"))
@@ -350,6 +477,67 @@ def test_status_code(server):
     assert c.getinfo(CurlInfo.RESPONSE_CODE) == 200
 
 
+def test_getinfo_many(server):
+    c = Curl()
+    url = str(server.url.copy_with(path="/redirect_301"))
+    c.setopt(CurlOpt.URL, url.encode())
+    c.setopt(CurlOpt.FOLLOWLOCATION, 1)
+    c.perform()
+    options = (
+        CurlInfo.EFFECTIVE_URL,
+        CurlInfo.RESPONSE_CODE,
+        CurlInfo.TOTAL_TIME,
+        CurlInfo.SIZE_DOWNLOAD_T,
+        CurlInfo.REDIRECT_COUNT,
+    )
+    values = c.getinfo_many(options)
+    assert values[0] == str(server.url).encode()
+    assert values[1] == 200
+    assert isinstance(values[2], float)
+    assert values[3] == c.getinfo(CurlInfo.SIZE_DOWNLOAD_T)
+    assert values[4] == 1
+    # cached arrays are reused for the same options
+    assert c.getinfo_many(options) == values
+
+
+def test_soft_reset_keeps_template(server):
+    c = Curl()
+    applied = []
+
+    def apply(curl):
+        applied.append(curl)
+        curl.setopt(CurlOpt.ACCEPT_ENCODING, b"gzip")
+
+    assert c.apply_template("gzip", apply) is True
+    assert c.apply_template("gzip", apply) is False
+    assert applied == [c]
+
+    url = str(server.url.copy_with(path="/echo_path"))
+    c.setopt(CurlOpt.URL, url.encode())
+    c.setopt(CurlOpt.HTTPHEADER, [b"Foo: bar"])
+    c.setopt(CurlOpt.CUSTOMREQUEST, b"PUT")
+    buffer = BytesIO()
+    c.setopt(CurlOpt.WRITEDATA, buffer)
+    c.perform()
+    assert json.loads(buffer.getvalue().decode())["method"] == "PUT"
+
+    c.soft_reset()
+    assert c.apply_template("gzip", apply) is False
+    url = str(server.url.copy_with(path="/echo_headers"))
+    c.setopt(CurlOpt.URL, url.encode())
+    buffer = BytesIO()
+    c.setopt(CurlOpt.WRITEDATA, buffer)
+    c.perform()
+    headers = json.loads(buffer.getvalue().decode())
+    assert "Foo" not in headers
+    assert headers["Accept-encoding"][0] == "gzip"
+
+    # an option without a known default falls back to a full reset
+    c.setopt(CurlOpt.TCP_NODELAY, 1)
+    c.soft_reset()
+    assert c.apply_template("gzip", apply) is True
+
+
 def test_response_headers(server):
     c = Curl()
     url = str(server.url.copy_with(path="/set_headers"))
@@ -363,6 +551,30 @@ def test_response_headers(server):
             assert line.startswith("x-test: test")
 
 
+def test_response_headers_to_curl_header_buffer(server):
+    c = Curl()
+    url = str(server.url.copy_with(path="/redirect_301"))
+    c.setopt(CurlOpt.URL, url.encode())
+    c.setopt(CurlOpt.FOLLOWLOCATION, 1)
+    c.setopt(CurlOpt.MAXREDIRS, 1)
+    headers = CurlHeaderBuffer()
+    c.setopt(CurlOpt.HEADERDATA, headers)
+    c.perform()
+    blocks = headers.blocks()
+    assert [status for status, _, _ in blocks] == [301, 200]
+    assert blocks[0][1] == b"Moved Permanently"
+    assert (b"location", b"/") in blocks[0][2]
+
+    headers.clear()
+    url = str(server.url.copy_with(path="/set_headers"))
+    c.setopt(CurlOpt.URL, url.encode())
+    c.setopt(CurlOpt.HEADERDATA, headers)
+    c.perform()
+    blocks = headers.blocks()
+    assert len(blocks) == 1
+    assert [v for k, v in blocks[0][2] if k == b"x-test"] == [b"test", b"test2"]
+
+
 def test_response_cookies(server):
     c = Curl()
     url = str(server.url.copy_with(path="/set_cookies"))
@@ -24,6 +24,33 @@ def test_header_output():
     assert header_list[0][0] == "X-Foo"
 
 
+def test_headers_from_raw_pairs():
+    headers = Headers.from_raw_pairs(
+        [
+            (b"Content-Type", b"text/plain"),
+            (b"Set-Cookie", b"a=1"),
+            (b"set-cookie", b"b=2"),
+        ]
+    )
+    assert headers["content-type"] == "text/plain"
+    assert headers.get_list("Set-Cookie") == ["a=1", "b=2"]
+    assert headers.raw[0] == (b"Content-Type", b"text/plain")
+
+
+def test_raw_headers_built_on_first_use():
+    headers = Headers.from_raw_pairs([(b"X-A", b"1"), (b"x-a", b"2")])
+    assert "_list" not in headers.__dict__
+    assert len(headers.raw) == 2
+    assert "_list" not in headers.__dict__
+    assert headers["x-a"] == "1, 2"
+    assert "_index" in headers.__dict__
+    headers["X-B"] = "3"
+    assert "x-b" in headers
+    del headers["x-a"]
+    assert "x-a" not in headers
+    assert headers.get_list("x-b") == ["3"]
+
+
 def test_replace_header():
     header_lines = []
     update_header_line(header_lines, "content-type", "image/png")
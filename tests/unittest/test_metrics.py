@@ -0,0 +1,83 @@
+from datetime import timedelta
+
+import pytest
+
+from curl_cffi.requests import (
+    AsyncSession,
+    RequestMetrics,
+    RequestsError,
+    Session,
+    SessionMetrics,
+)
+from curl_cffi.requests.models import Response
+
+
+def test_session_metrics(server):
+    seen: list[RequestMetrics] = []
+    metrics = SessionMetrics(hook=seen.append)
+    url = str(server.url.copy_with(path="/echo_headers"))
+    origin = f"http://{server.url.netloc.decode()}"
+    with Session(metrics=metrics) as s:
+        s.get(url)
+        s.get(url)
+
+    m = metrics.snapshot()[origin]
+    assert m.requests == 2
+    # the second request reuses the connection of the first one
+    assert m.new_connections == 1
+    assert m.reused_connections == 1
+    assert m.tls_handshakes == 0
+    assert m.bytes_sent > 0
+    assert m.bytes_received > 0
+    assert m.total.total == 2
+    assert m.dns.total == m.connect.total == 1
+    assert [r.status_code for r in seen] == [200, 200]
+    assert seen[0].ttfb <= seen[0].total
+
+
+async def test_async_session_metrics(server):
+    metrics = SessionMetrics()
+    url = str(server.url.copy_with(path="/echo_headers"))
+    origin = f"http://{server.url.netloc.decode()}"
+    async with AsyncSession(metrics=metrics, retry=1) as s:
+        await s.get(url)
+        with pytest.raises(RequestsError):
+            await s.get("http://127.0.0.1:1/")
+
+    snapshot = metrics.snapshot()
+    assert snapshot[origin].requests == 1
+    assert snapshot[origin].pool_wait.total == 1
+    failed = snapshot["http://127.0.0.1:1"]
+    assert failed.errors == 2
+    assert failed.retries == 1
+
+
+def test_record_response():
+    metrics = SessionMetrics()
+    rsp = Response()
+    rsp.url = "https://example.com/a?b=c"
+    rsp.status_code = 200
+    rsp.elapsed = timedelta(seconds=0.5)
+    rsp.download_size, rsp.header_size = 1000, 200
+    rsp.upload_size, rsp.request_size = 0, 100
+    metrics.record_response(rsp, [0.01, 0.03, 0.08, 0.2, 1])
+    rsp.elapsed = timedelta(seconds=0.1)
+    metrics.record_response(rsp, [0.0, 0.0, 0.0, 0.05, 0])
+
+    m = metrics.snapshot()["https://example.com"]
+    assert (m.requests, m.new_connections, m.reused_connections) == (2, 1, 1)
+    assert (m.bytes_sent, m.bytes_received) == (200, 2400)
+    assert m.tls_handshakes == 1
+    assert 0.05 <= m.tls.percentile(1.0) < 0.06
+    assert 0.5 <= m.total.percentile(1.0) < 0.6
+    assert m.total.sum == pytest.approx(0.6)
+
+    text = metrics.to_prometheus()
+    assert 'curl_cffi_requests_total{origin="https://example.com"} 2' in text
+    label = 'origin="https://example.com"'
+    assert f'curl_cffi_total_seconds_bucket{{{label},le="+Inf"}} 2' in text
+    assert f'curl_cffi_total_seconds_bucket{{{label},le="0.256"}} 1' in text
+    assert f"curl_cffi_total_seconds_count{{{label}}} 2" in text
+
+    metrics.reset()
+    assert metrics.snapshot() == {}
@@ -1,15 +1,20 @@
 import base64
 import json
+import mmap
+import os
 import pickle
+import queue
 import time
+from array import array
 from io import BytesIO
+from unittest.mock import Mock
 from uuid import uuid4
 
 import pytest
 from charset_normalizer import detect
 
 import curl_cffi
-from curl_cffi import Curl, CurlFollow, CurlOpt, requests
+from curl_cffi import Curl, CurlFollow, CurlOpt, CurlShare, requests
 from curl_cffi.const import CurlECode, CurlInfo
 from curl_cffi.requests.errors import SessionClosed
 from curl_cffi.requests.exceptions import (
@@ -18,8 +23,8 @@ from curl_cffi.requests.exceptions import (
     TooManyRedirects,
     UnrewindableBodyError,
 )
-from curl_cffi.requests.models import Response
-from curl_cffi.requests.streams import _IterableReader
+from curl_cffi.requests.models import RawResponse, Response
+from curl_cffi.requests.streams import STREAM_END, _IterableReader
 from curl_cffi.utils import CurlCffiWarning
 
 
@@ -189,6 +194,27 @@ def test_post_content_chunk_list(server):
     assert r.content == b"foobar"
 
 
+def test_post_buffer_body(server, tmp_path):
+    url = str(server.url.copy_with(path="/echo_body"))
+    body = bytearray(b"\0foo=bar" * 4096)
+    r = requests.post(url, content=body)
+    assert r.content == body
+    assert r.request.body is body
+
+    numbers = array("i", range(1000))
+    r = requests.post(url, content=memoryview(numbers))
+    assert r.content == numbers.tobytes()
+
+    r = requests.post(url, content=memoryview(body)[::2])
+    assert r.content == bytes(body[::2])
+
+    path = tmp_path / "body.bin"
+    path.write_bytes(b"mapped-body" * 1000)
+    with path.open("rb") as f, mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as m:
+        r = requests.post(url, content=m)
+    assert r.content == b"mapped-body" * 1000
+
+
 def test_sync_session_rejects_async_content(server):
     async def content():
         yield b"raw"
@@ -485,6 +511,30 @@ def test_json_bytes_bom_parse():
     assert r.json()["foo"] == "bar"
 
 
+def test_json_custom_loads():
+    r = Response()
+    r.content = b'{"foo": 1.5}'
+    assert r.json(loads=lambda data: data) == b'{"foo": 1.5}'
+    assert r.json(parse_float=str)["foo"] == "1.5"
+    with pytest.raises(TypeError):
+        r.json(loads=lambda data: data, parse_float=str)
+
+
+def test_iter_json():
+    r = Response()
+    r.curl = Mock()
+    r.queue = queue.Queue()
+    chunks = [
+        b'{"a": 1}\n{"b"',
+        b': 2}\n\n{"c": ',
+        memoryview(b"[3]}\r\n"),
+        b'{"d": 4}',
+    ]
+    for chunk in [*chunks, STREAM_END]:
+        r.queue.put(chunk)
+    assert list(r.iter_json()) == [{"a": 1}, {"b": 2}, {"c": [3]}, {"d": 4}]
+
+
 def test_response_is_redirect():
     for status_code in (301, 302, 303, 307, 308):
         r = Response()
@@ -624,6 +674,30 @@ def test_session_retry(server):
     assert r.content == b"ok"
 
 
+def test_session_rate_limit(server):
+    url = str(server.url)
+    with requests.Session(rate_limit=requests.RateLimit(rate=10, burst=2)) as s:
+        start = time.monotonic()
+        for _ in range(4):
+            s.get(url)
+        # two requests in the burst, then one every 0.1s
+        assert time.monotonic() - start >= 0.2
+
+    key = uuid4().hex
+    retry_url = str(
+        server.url.copy_with(
+            path="/retry_once", query=f"key={key}&status=429&retry_after=1".encode()
+        )
+    )
+    limit = requests.RateLimit(rate=100, burst=10)
+    with requests.Session(
+        retry=1, raise_for_status=True, rate_limit={"*": limit}
+    ) as s:
+        start = time.monotonic()
+        assert s.get(retry_url).content == b"ok"
+        assert time.monotonic() - start >= 1
+
+
 def test_post_timeout(server):
     with pytest.raises(requests.RequestsError):
         requests.post(str(server.url.copy_with(path="/slow_response")), timeout=0.1)
@@ -761,6 +835,30 @@ def test_response_cookies(server):
     assert r.cookies.get("xxx") is None
 
 
+def test_lazy_response_attributes():
+    rsp = Response()
+    rsp._raw = RawResponse(
+        [
+            (301, b"Moved", [(b"Location", b"/b")]),
+            (200, b"OK", [(b"Set-Cookie", b"foo=bar"), (b"X-A", b"1")]),
+        ],
+        [b"301\thttp://example.com/a"],
+        Response,
+        "utf-8",
+    )
+    assert rsp._headers is None and rsp._cookies is None and rsp._history is None
+    assert rsp.headers["x-a"] == "1"
+    assert rsp.cookies["foo"] == "bar"
+    [redirect] = rsp.history
+    assert redirect.url == "http://example.com/a"
+    assert (redirect.status_code, redirect.reason) == (301, "Moved")
+    assert redirect.headers["location"] == "/b"
+
+    restored = pickle.loads(pickle.dumps(rsp))
+    assert restored.cookies["foo"] == "bar"
+    assert restored.history[0].status_code == 301
+
+
 def test_elapsed(server):
     r = requests.get(str(server.url.copy_with(path="/slow_response")))
     assert r.elapsed.total_seconds() > 0.1
@@ -915,6 +1013,37 @@ def test_session_cookies(server):
     assert cookies["hello"] == "world"
 
 
+def test_cookie_engine(server):
+    s = requests.Session(cookie_engine=True)
+    s.get(str(server.url.copy_with(path="/set_cookies")))
+    assert s.cookies["foo"] == "bar"
+    s.cookies.set("foo2", "bar2", domain="127.0.0.1")
+    s.cookies.set("hostless", "yes")
+    s.cookies.set("other", "no", domain="example.com")
+    r = s.get(
+        str(server.url.copy_with(path="/echo_cookies")), cookies={"hello": "world"}
+    )
+    cookies = r.json()
+    assert cookies == {
+        "foo": "bar",
+        "foo2": "bar2",
+        "hostless": "yes",
+        "hello": "world",
+    }
+    # request cookies are not kept
+    assert "hello" not in s.cookies
+
+    s.cookies.delete("foo2")
+    s.get(str(server.url.copy_with(path="/delete_cookies")))
+    r = s.get(str(server.url.copy_with(path="/echo_cookies")))
+    assert r.json() == {"hostless": "yes"}
+    assert s.cookies.get("foo") is None
+
+    s.get(str(server.url.copy_with(path="/set_cookies")), discard_cookies=True)
+    r = s.get(str(server.url.copy_with(path="/echo_cookies")))
+    assert "foo" not in r.json()
+
+
 def test_cookies_after_redirect(server):
     s = requests.Session(debug=True)
     r = s.get(
@@ -1001,6 +1130,19 @@ def test_session_with_headers(server):
     assert r.status_code == 200
 
 
+def test_session_reuses_handle_between_methods(server):
+    s = requests.Session()
+    url = str(server.url.copy_with(path="/echo_path"))
+    r = s.put(url, data="foo", headers={"Foo": "bar"})
+    assert r.json()["method"] == "PUT"
+    r = s.head(url)
+    assert r.status_code == 200
+    r = s.get(url)
+    assert r.json()["method"] == "GET"
+    r = s.get(str(server.url.copy_with(path="/echo_headers")))
+    assert "Foo" not in r.json()
+
+
 # https://github.com/lexiforest/curl_cffi/pull/171
 def test_session_with_hostname_proxies(server, proxy_server):
     proxies = {
@@ -1032,6 +1174,43 @@ def test_session_with_all_proxies(server, proxy_server):
     assert r.text == "Hello from man in the middle"
 
 
+def test_session_batch(server):
+    url = str(server.url.copy_with(path="/echo_params"))
+    with requests.Session(params={"shared": "1"}) as s:
+        rs = list(s.batch([f"{url}?i={i}" for i in range(20)], concurrency=4))
+        assert sorted(int(r.json()["params"]["i"][0]) for r in rs) == list(range(20))
+        assert all(r.json()["params"]["shared"] == ["1"] for r in rs)
+
+        items = [
+            ("POST", str(server.url.copy_with(path="/echo_body")), {"content": b"x"}),
+            ("GET", str(server.url.copy_with(path="/set_cookies"))),
+        ]
+        rs = list(s.batch(items, headers={"Foo": "bar"}))
+        assert sorted(r.status_code for r in rs) == [200, 200]
+        assert any(r.cookies.get("foo") == "bar" for r in rs)
+
+        s.raise_for_status = True
+        items = [str(server.url.copy_with(path="/status/404")), str(server.url)]
+        rs = list(s.batch(items, return_exceptions=True))
+        assert sorted(type(r).__name__ for r in rs) == ["HTTPError", "Response"]
+        with pytest.raises(HTTPError):
+            list(s.batch(items))
+
+
+def test_session_share(server):
+    url = str(server.url)
+    share = CurlShare(connections=True)
+    infos = [CurlInfo.NUM_CONNECTS]
+    with requests.Session(share=share, curl_infos=infos) as s1:
+        with requests.Session(share=share, curl_infos=infos) as s2:
+            assert s1.get(url).infos[CurlInfo.NUM_CONNECTS] == 1
+            # the connection of the other session is reused
+            assert s2.get(url).infos[CurlInfo.NUM_CONNECTS] == 0
+    with requests.Session(share=True) as s:
+        assert s.share is not None
+        assert s.get(url).text == "Hello, world!"
+
+
 # https://github.com/lexiforest/curl_cffi/issues/222
 def test_closed_session_throws_error():
     with requests.Session() as s:
@@ -1219,6 +1398,73 @@ def test_stream_options_persist(server):
     assert data["User-agent"][0] == "foo/1.0"
 
 
+def test_stream_ring_buffer(server):
+    with requests.Session() as s:
+        url = str(server.url.copy_with(path="/stream"))
+        with s.stream("GET", url, params={"n": "20"}, stream_buffer_size=64) as r:
+            lines = list(r.iter_lines())
+        assert len(lines) == 20
+        assert all(json.loads(line)["path"] == "/stream" for line in lines)
+
+        # a chunk kept past the next one is released, not overwritten
+        with s.stream("GET", url, params={"n": "20"}, stream_buffer_size=64) as r:
+            chunks = list(r.iter_content())
+        with pytest.raises(ValueError):
+            bytes(chunks[0])
+
+        url = str(server.url.copy_with(path="/redirect_loop"))
+        with pytest.raises(requests.RequestsError) as e:
+            s.get(url, max_redirects=2, stream=True, stream_buffer_size=64)
+        assert e.value.code == CurlECode.TOO_MANY_REDIRECTS
+
+
+def test_download(server, tmp_path):
+    body = bytes(range(256)) * 1024
+    path = tmp_path / "file.bin"
+    url = str(server.url.copy_with(path="/range"))
+    with requests.Session() as s:
+        r = s.download(url, path)
+        assert r.status_code == 200
+        assert r.content == b""
+        assert path.read_bytes() == body
+
+        path.write_bytes(body[:1000])
+        r = s.download(url, path)
+        assert r.status_code == 206
+        assert path.read_bytes() == body
+
+        # already complete
+        r = s.download(url, path)
+        assert r.status_code == 416
+        assert path.read_bytes() == body
+
+        # range ignored by the server, downloaded again from the start
+        url = str(server.url.copy_with(path="/echo_path"))
+        path.write_bytes(b"x" * 10)
+        r = s.download(url, path)
+        assert r.status_code == 200
+        assert json.loads(path.read_bytes())["path"] == "/echo_path"
+
+
+def test_stream_to_fd(server, tmp_path):
+    path = tmp_path / "file.bin"
+    url = str(server.url.copy_with(path="/echo_body"))
+    fd = os.open(path, os.O_WRONLY | os.O_CREAT)
+    try:
+        r = requests.post(url, data=b"\0foo=bar" * 4096, stream_to=fd)
+    finally:
+        os.close(fd)
+    assert r.content == b""
+    assert path.read_bytes() == b"\0foo=bar" * 4096
+
+    fd = os.open(path, os.O_RDONLY)
+    try:
+        with pytest.raises(OSError):
+            requests.post(url, data=b"foo", stream_to=fd)
+    finally:
+        os.close(fd)
+
+
 @pytest.mark.skip(reason="External url unstable")
 def test_stream_close_early(server):
     s = requests.Session()
@@ -259,3 +259,37 @@ def test_interface_name_and_prefixed_values_pass_through(interface):
     curl = _set_interface(interface)
 
     assert curl.options[CurlOpt.INTERFACE] == interface.encode()
+
+
+def test_compile_profile_is_memoized():
+    ja3 = "771,4865-4866,0-11-10,29-23,0"
+    akamai = "1:65536|15663105|0|m,a,s,p"
+    profile = utils.compile_profile(ja3=ja3, akamai=akamai)
+
+    assert utils.compile_profile(ja3=ja3, akamai=akamai) is profile
+    assert utils.compile_profile(ja3=ja3) is not profile
+
+    curl = FakeCurl()
+    profile.apply(curl)
+    assert curl.options[CurlOpt.SSL_CIPHER_LIST] == (
+        "TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384"
+    )
+    assert curl.options[CurlOpt.HTTP2_PSEUDO_HEADERS_ORDER] == "masp"
+
+
+def test_compile_profile_follows_fingerprint_changes():
+    fingerprint = Fingerprint(tls_ciphers=["TLS_AES_128_GCM_SHA256"])
+    profile = utils.compile_profile(impersonate=fingerprint)
+
+    assert profile.fingerprint is fingerprint
+    assert utils.compile_profile(impersonate=fingerprint) is profile
+
+    fingerprint.tls_ciphers.append("TLS_AES_256_GCM_SHA384")
+    changed = utils.compile_profile(impersonate=fingerprint)
+    assert changed is not profile
+
+    curl = FakeCurl()
+    changed.apply(curl)
+    assert curl.options[CurlOpt.SSL_CIPHER_LIST] == (
+        "TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384"
+    )
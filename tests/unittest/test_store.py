@@ -0,0 +1,102 @@
+import struct
+import subprocess
+import sys
+
+import pytest
+
+from curl_cffi import CurlShare
+from curl_cffi.requests import PersistentStore, Session
+from curl_cffi.requests.store import (
+    merge_cache_lines,
+    merge_tls_records,
+    parse_tls_records,
+    profile_name,
+)
+
+
+def record(shmac: bytes, sdata: bytes, valid_until: int) -> bytes:
+    return (
+        struct.pack("N", len(shmac))
+        + shmac
+        + struct.pack("N", len(sdata))
+        + sdata
+        + struct.pack("q", valid_until)
+    )
+
+
+def test_profile_name():
+    assert profile_name() == "default"
+    assert profile_name("chrome136") == "chrome136"
+    custom = profile_name("chrome136", ja3="771,4865")
+    assert custom.startswith("custom-")
+    assert custom == profile_name("chrome136", ja3="771,4865")
+    assert custom != profile_name("chrome136", ja3="771,4866")
+    assert profile_name("../etc").startswith("custom-")
+
+
+def test_merge_tls_records():
+    old = record(b"a", b"1", 100) + record(b"b", b"2", 10)
+    new = record(b"a", b"3", 200) + record(b"c", b"4", 150)
+    merged = merge_tls_records(old, new, limit=10, now=50)
+    # expired sessions are dropped, the ones valid the longest come first
+    assert [r[:2] for r in parse_tls_records(merged)] == [
+        (b"a", record(b"a", b"3", 200)),
+        (b"c", record(b"c", b"4", 150)),
+        (b"a", record(b"a", b"1", 100)),
+    ]
+    assert len(parse_tls_records(merge_tls_records(old, new, limit=1, now=50))) == 1
+
+    many = b"".join(record(b"a", bytes([i]), 100 + i) for i in range(10))
+    assert len(parse_tls_records(merge_tls_records(b"", many, limit=10, now=0))) == 4
+
+    with pytest.raises(ValueError):
+        parse_tls_records(old[:-1])
+
+
+def test_session_store(server, tmp_path):
+    store = PersistentStore(tmp_path)
+    with Session(impersonate="chrome", store=store) as s:
+        assert s.share is not None and s.share.ssl_session
+        s.get(str(server.url))
+    profile = tmp_path / "chrome"
+    assert profile.is_dir()
+    # plain http, nothing to resume, but the file is written and read back
+    assert (profile / "tls_sessions.bin").exists()
+    with Session(impersonate="chrome", store=str(tmp_path)) as s:
+        s.get(str(server.url))
+        # a request with another fingerprint has its own profile
+        s.get(str(server.url), impersonate="safari")
+    assert (tmp_path / "safari" / "tls_sessions.bin").exists()
+
+    with pytest.raises(ValueError):
+        Session(store=store, share=CurlShare(ssl_session=False))
+
+
+def test_merge_cache_lines():
+    old = (
+        "# Your alt-svc cache. https://curl.se/docs/alt-svc.html\n"
+        'h2 a.com 443 h3 a.com 443 "20300101 00:00:00" 0 0\n'
+        'h2 b.com 443 h3 b.com 443 "20300101 00:00:00" 0 0\n'
+    )
+    new = 'h2 a.com 443 h3 a.com 443 "20310101 00:00:00" 0 0\n'
+    assert merge_cache_lines([old, new]) == (
+        'h2 a.com 443 h3 a.com 443 "20310101 00:00:00" 0 0\n'
+        'h2 b.com 443 h3 b.com 443 "20300101 00:00:00" 0 0\n'
+    )
+    # the subdomains flag of an HSTS entry does not make it another host
+    hsts = merge_cache_lines(['.a.com "20300101 00:00:00"', 'a.com "unlimited"'])
+    assert hsts == 'a.com "unlimited"\n'
+
+
+def test_stale_copies_are_merged(tmp_path):
+    # the pid of a process which is gone
+    dead = subprocess.Popen([sys.executable, "-c", ""])
+    dead.wait()
+    profile = tmp_path / "chrome"
+    profile.mkdir()
+    (profile / f"altsvc.{dead.pid}-0.txt").write_text(
+        'h2 a.com 443 h3 a.com 443 "20300101 00:00:00" 0 0\n'
+    )
+    PersistentStore(tmp_path).profile("chrome")
+    assert [p.name for p in profile.iterdir()] == ["altsvc.txt"]
+    assert "a.com" in (profile / "altsvc.txt").read_text()
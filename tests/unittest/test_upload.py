@@ -100,3 +100,39 @@ def test_upload_multiple_files_different_name(file_server):
     assert data["size1"] == os.path.getsize(ASSET_FOLDER / "scrapfly.png")
     assert data["size2"] == os.path.getsize(ASSET_FOLDER / "yescaptcha.png")
     multipart.close()
+
+
+def test_upload_streamed_parts(file_server):
+    path = ASSET_FOLDER / "scrapfly.png"
+    data = path.read_bytes()
+
+    def chunks():
+        for i in range(0, len(data), 1000):
+            yield data[i : i + 1000]
+
+    # a generator of unknown size, then an open file read by the shim
+    for content in (chunks(), open(path, "rb")):
+        multipart = CurlMime()
+        multipart.addpart(
+            "image", content_type="image/jpg", filename="a.png", content=content
+        )
+        r = requests.post(file_server.url + "/file", multipart=multipart)
+        assert r.json()["size"] == len(data)
+        multipart.close()
+        if hasattr(content, "close"):
+            content.close()
+
+
+async def test_upload_async_iterable_part(file_server):
+    data = (ASSET_FOLDER / "scrapfly.png").read_bytes()
+
+    async def chunks():
+        for i in range(0, len(data), 1000):
+            yield data[i : i + 1000]
+
+    multipart = CurlMime()
+    multipart.addpart("image", filename="a.png", content=chunks(), size=len(data))
+    async with requests.AsyncSession() as s:
+        r = await s.post(file_server.url + "/file", multipart=multipart)
+    assert r.json()["size"] == len(data)
+    multipart.close()
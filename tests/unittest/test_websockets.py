@@ -56,6 +56,19 @@ def test_receive_large_messages(ws_server):
     ws.close()
 
 
+def test_recv_into(ws_server):
+    ws = WebSocket()
+    ws.connect(ws_server.url)
+    buffer = bytearray(20000)
+    for _ in range(3):
+        ws.send("*" * 10000)
+    for _ in range(3):
+        size, flags = ws.recv_into(buffer)
+        assert size == 10000
+        assert buffer[:size] == b"*" * 10000
+    ws.close()
+
+
 def test_receive_large_messages_run_forever(ws_server):
     def on_open(ws: WebSocket):
         ws.send("*" * 10000)